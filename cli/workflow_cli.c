@@ -1,8 +1,27 @@
 #include "workflow_cli.h"
 #include "../lib/util.h"
+#include "../lib/parallel.h"
+#include "../lib/euler.h"
+#include "../lib/bulk.h"
+#include "../lib/attr.h"
+#include "../lib/query.h"
+#include "../lib/diff.h"
+#include "../lib/snapshot.h"
+#include "../lib/pager.h"
+#include "../lib/pack.h"
+#include "../lib/metrics.h"
+#include "../lib/report.h"
+#include "../lib/trace.h"
+#include "../lib/run.h"
+#include "../lib/rollup.h"
+#include "../lib/deps.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#ifndef _WIN32
+#include <poll.h>
+#include <unistd.h>
+#endif
 
 WorkflowCLI* InitWorkflowCLI(int childSize) {
   WorkflowCLI* cli = (WorkflowCLI*)malloc(sizeof(WorkflowCLI));
@@ -14,6 +33,7 @@ WorkflowCLI* InitWorkflowCLI(int childSize) {
   // JSON 파일 경로 설정
   strncpy(cli->jsonFilePath, JSON_FILE_PATH, sizeof(cli->jsonFilePath) - 1);
   cli->jsonFilePath[sizeof(cli->jsonFilePath) - 1] = '\0';
+  cli->snapshot = NULL;
 
   // JSON 파일에서 불러오기 시도
   cli->tree = NULL;
@@ -28,8 +48,7 @@ WorkflowCLI* InitWorkflowCLI(int childSize) {
     }
 
     // 루트 노드를 "Root"로 초기화
-    strncpy(cli->tree->Head->Data, "Root", SIZE - 1);
-    cli->tree->Head->Data[SIZE - 1] = '\0';
+    SetData_N_Tree(cli->tree, cli->tree->Head, "Root");
     cli->tree->Count = 1;
 
     cli->current = cli->tree->Head;
@@ -44,24 +63,44 @@ WorkflowCLI* InitWorkflowCLI(int childSize) {
   return cli;
 }
 
+// 스냅숏을 지연 로딩으로 열어 시작한다 (JSON 파일은 읽지 않음)
+WorkflowCLI* InitPagedWorkflowCLI(const char* snapshotPath) {
+  WorkflowCLI* cli = (WorkflowCLI*)malloc(sizeof(WorkflowCLI));
+  if (cli == NULL) {
+    printf("Error! Failed to allocate CLI structure.\n");
+    return NULL;
+  }
+
+  strncpy(cli->jsonFilePath, JSON_FILE_PATH, sizeof(cli->jsonFilePath) - 1);
+  cli->jsonFilePath[sizeof(cli->jsonFilePath) - 1] = '\0';
+  cli->snapshot = NULL;
+  cli->tree = Create_N_Tree(1);
+  if (cli->tree == NULL || !OpenPagedTree(cli, snapshotPath)) {
+    CleanupWorkflowCLI(cli);
+    return NULL;
+  }
+  return cli;
+}
+
 void CleanupWorkflowCLI(WorkflowCLI* cli) {
   if (cli == NULL) return;
 
+  StopTrace();
   if (cli->tree != NULL) {
     Delete_N_Tree(cli->tree);
   }
+  Close_Snapshot(cli->snapshot);
   free(cli);
 }
 
-void UpdatePath(WorkflowCLI* cli) {
-  if (cli == NULL || cli->current == NULL) return;
+static void BuildPath(WorkflowCLI* cli) {
 
   // 경로를 거슬러 올라가며 구성
   struct TreeNodeType* node = cli->current;
   int depth = 0;
 
   // 임시 배열에 역순으로 저장
-  char tempPath[MAX_PATH_DEPTH][SIZE];
+  LabelType tempPath[MAX_PATH_DEPTH];
 
   // 무한 루프 방지: 이미 방문한 노드를 추적
   struct TreeNodeType* visited[MAX_PATH_DEPTH] = {NULL};
@@ -73,15 +112,14 @@ void UpdatePath(WorkflowCLI* cli) {
         printf("Warning! Circular reference detected in tree path.\n");
         cli->pathDepth = depth;
         for (int j = 0; j < depth; j++) {
-          strncpy(cli->path[j], tempPath[depth - 1 - j], SIZE);
+          cli->path[j] = tempPath[depth - 1 - j];
         }
         return;
       }
     }
 
     visited[depth] = node;
-    strncpy(tempPath[depth], node->Data, SIZE - 1);
-    tempPath[depth][SIZE - 1] = '\0';
+    tempPath[depth] = node->Label;
     depth++;
     node = node->Parent;
   }
@@ -89,21 +127,30 @@ void UpdatePath(WorkflowCLI* cli) {
   // 정순으로 복사
   cli->pathDepth = depth;
   for (int i = 0; i < depth; i++) {
-    strncpy(cli->path[i], tempPath[depth - 1 - i], SIZE);
+    cli->path[i] = tempPath[depth - 1 - i];
   }
 }
 
+void UpdatePath(WorkflowCLI* cli) {
+  if (cli == NULL || cli->current == NULL) return;
+
+  TRACE_BEGIN(span);
+  BuildPath(cli);
+  TRACE_END(span, "UpdatePath", "cli");
+}
+
 void ShowCurrentPath(WorkflowCLI* cli) {
+  TRACE_BEGIN(span);
   printf("\nCurrent Path: ");
   if (cli->pathDepth == 0) {
     printf("/\n");
-    return;
-  }
-
-  for (int i = 0; i < cli->pathDepth; i++) {
-    printf("/%s", cli->path[i]);
+  } else {
+    for (int i = 0; i < cli->pathDepth; i++) {
+      printf("/%s", Label_Text(cli->tree->Labels, cli->path[i]));
+    }
+    printf("\n");
   }
-  printf("\n");
+  TRACE_END(span, "prompt", "render");
 }
 
 void ClearScreen(void) {
@@ -121,6 +168,7 @@ void ShowHelp(void) {
   printf("  clear / cls       - Clear the screen\n");
   printf("  pwd               - Show current path\n");
   printf("  ls                - List children of current node\n");
+  printf("  ls <from> [count] - List children by order from #from (default %d)\n", LIST_PAGE_SIZE);
   printf("  tree              - Show full tree structure\n");
   printf("  view              - Show horizontal tree view\n");
   printf("  cd <index>        - Navigate to child at position\n");
@@ -132,34 +180,69 @@ void ShowHelp(void) {
   printf("  remove all        - Remove current node and all children\n");
   printf("  edit <data>       - Edit current node's data\n");
   printf("  info              - Show current node information\n");
+  printf("  stat              - Show tree statistics (parallel)\n");
+  printf("  stats [reset|json <file>] - Show operation counters and latency percentiles\n");
+  printf("  trace on [file] | trace off - Record a Chrome trace of the session (default workflow_trace.json)\n");
+  printf("  mem               - Show memory usage, slot occupancy and a ChildSize recommendation\n");
+  printf("  find <text>       - Find nodes whose data contains text\n");
+  printf("  find =<data>      - Find nodes whose data equals data\n");
+  printf("  query <path>      - Find nodes by path (e.g. /Root/*/Build//test*[depth<4])\n");
+  printf("  lca <path> <path> - Show lowest common ancestor of two nodes\n");
+  printf("  mv <path> <parent>/<pos> - Move subtree to position under parent\n");
+  printf("  cp <path> <parent>/<pos> - Copy subtree to position under parent\n");
+  printf("  critical [path]   - Show the longest path by 'duration' and the duration/cost roll-ups ('mode=parallel' children overlap)\n");
+  printf("  dep <path> <path> - Make the first node wait for the second (undep <path> <path> removes it)\n");
+  printf("  deps [path]       - Show what a node waits for and what waits for it\n");
+  printf("  order [path] [count] - Show the execution order (children and dependencies first, default %d)\n", LIST_PAGE_SIZE);
+  printf("  ready [path]      - Show nodes whose children and dependencies have all finished ok\n");
+  printf("  run [path] [-j N] [-k] [--labels] - Run the 'cmd' attribute of each node (children first, 'mode=parallel' runs them concurrently)\n");
+  printf("  diff <file>       - Show changes from current tree to a saved tree\n");
+  printf("  merge <base> <theirs> - Three-way merge saved tree into current tree\n");
+  printf("  import <file>     - Replace tree with records (parent slot data per line)\n");
+  printf("  set <key>[:type] <value> - Set attribute on current node (int|float|string|time)\n");
+  printf("  get [key]         - Show attributes of current node\n");
+  printf("  unset <key>       - Remove attribute from current node\n");
+  printf("  where <expr>      - Find nodes by attribute (e.g. status=failed, cost>=10)\n");
+  printf("  attrs             - List attribute columns\n");
+  printf("  attrs save|load <file> - Save/load attributes in binary form\n");
+  printf("  status            - Check whether saved files match the tree (by root hash)\n");
+  printf("  snapshot save|load|compact [file] - Incremental snapshot (default workflow_tree.snap)\n");
+  printf("  snapshot open [file] - Open snapshot lazily (load subtrees when first visited)\n");
+  printf("  pack save|load [file] - Compressed tree file (default workflow_tree.pack)\n");
   printf("  exit / quit       - Exit the CLI\n");
   printf("=======================================\n\n");
 }
 
+// 지연 로딩 트리: 트리 전체를 훑는 명령 전에 남은 서브트리를 모두 읽는다
+static void LoadWholeTree(WorkflowCLI* cli) {
+  if (cli->tree->Pager == NULL) return;
+
+  long before = cli->tree->Pager->Resident;
+  if (LoadAll_N_Tree(cli->tree) && cli->tree->Pager->Resident > before) {
+    printf("Loaded %ld paged node(s) from %s\n", cli->tree->Pager->Resident - before, cli->tree->Pager->Snapshot->Path);
+  }
+}
+
 void ShowCurrentNode(WorkflowCLI* cli) {
-  printf("\nCurrent Node: %s\n", cli->current->Data);
+  // 떼어 낸 노드는 해제할 때 Count 에서 빠진다
+  Reclaim_N_Tree(cli->tree, 0);
+  printf("\nCurrent Node: %s\n", Data_N_Tree(cli->tree, cli->current));
   printf("Total Nodes in Tree: %d\n", cli->tree->Count);
 
-  int childCount = 0;
-  for (int i = 0; i < cli->tree->ChildSize; i++) {
-    if (cli->current->Children[i] != NULL) {
-      childCount++;
-    }
-  }
-  printf("Children Count: %d\n", childCount);
+  printf("Children Count: %d\n", ChildCount_N_Tree(cli->current));
+  printf("Depth: %d\n", Depth_N_Tree(cli->tree, cli->current));
+  printf("Subtree Size: %d\n", SubtreeSize_N_Tree(cli->tree, cli->current));
 }
 
-static int FindMaxDataLength(struct TreeNodeType* node, int childSize) {
+static int FindMaxDataLength(struct N_TreeType* tree, struct TreeNodeType* node) {
   if (node == NULL) return 0;
 
-  int maxLen = strlen(node->Data);
+  int maxLen = strlen(Data_N_Tree(tree, node));
 
-  for (int i = 0; i < childSize; i++) {
-    if (node->Children[i] != NULL) {
-      int childMax = FindMaxDataLength(node->Children[i], childSize);
-      if (childMax > maxLen) {
-        maxLen = childMax;
-      }
+  FOR_EACH_CHILD_SLOT(node, i) {
+    int childMax = FindMaxDataLength(tree, node->Children[i]);
+    if (childMax > maxLen) {
+      maxLen = childMax;
     }
   }
 
@@ -167,46 +250,345 @@ static int FindMaxDataLength(struct TreeNodeType* node, int childSize) {
 }
 
 void ShowFullTree(WorkflowCLI* cli) {
+  LoadWholeTree(cli);
+  TRACE_BEGIN(span);
   printf("\n");
   Show(cli->tree);
   printf("\n");
+  TRACE_END(span, "tree", "render");
 }
 
-void ListChildren(WorkflowCLI* cli) {
-  printf("\nChildren of '%s':\n", cli->current->Data);
+void ShowTreeStats(WorkflowCLI* cli) {
+  LoadWholeTree(cli);
+  struct TreeStatsType stats = ParallelStats_N_Tree(cli->tree, 0);
+
+  printf("\nTree Statistics:\n");
+  printf("  Nodes          : %ld\n", stats.Nodes);
+  printf("  Leaves         : %ld\n", stats.Leaves);
+  printf("  Depth          : %d\n", stats.Depth);
+  printf("  Max Data Length: %d\n", stats.MaxDataLength);
+  printf("  Child Size     : %d\n", cli->tree->ChildSize);
+  printf("  Threads        : %d\n\n", ParallelThreadCount());
+}
+
+// 세션 추적: 명령 파싱, 실행, 트리 변경, 경로 갱신, 출력, 자동 저장 구간을 기록한다
+bool StartTrace(const char* filepath) {
+  const char* path = filepath != NULL && filepath[0] != '\0' ? filepath : TRACE_FILE_PATH;
+  if (Trace_Enabled()) StopTrace();
+  if (!Trace_Open(path, TRACE_DEFAULT_CAPACITY)) return false;
+
+  printf("Tracing to %s (written on 'trace off' or exit)\n", path);
+  return true;
+}
+
+void StopTrace(void) {
+  if (!Trace_Enabled()) return;
+
+  char path[TRACE_PATH_SIZE];
+  strcpy(path, Trace_Path());
+  long events = Trace_Close();
+  if (events >= 0) {
+    printf("Wrote %ld trace event(s) to %s\n", events, path);
+  }
+}
+
+static void PrintBytesRow(const char* name, size_t bytes, size_t total) {
+  printf("  %-16s: %12zu bytes (%5.1f%%)\n", name, bytes, total > 0 ? 100.0 * bytes / total : 0.0);
+}
+
+// 비어 있지 않은 칸만 막대로 출력
+static void PrintHistogramBars(const char* title, const long* counts, int size, long total) {
+  long largest = 0;
+  for (int index = 0; index < size; index++) {
+    if (counts[index] > largest) largest = counts[index];
+  }
+
+  printf("\n%s\n", title);
+  for (int index = 0; index < size; index++) {
+    if (counts[index] == 0) continue;
+    int width = (int)(40 * counts[index] / largest);
+    bool openEnded = (index == REPORT_DEPTH_BUCKETS - 1 && size == REPORT_DEPTH_BUCKETS) ||
+                     (index == REPORT_FANOUT_BUCKETS - 1 && size == REPORT_FANOUT_BUCKETS);
+    printf("  %4d%s %8ld %5.1f%% ", index, openEnded ? "+" : " ",
+           counts[index], 100.0 * counts[index] / total);
+    for (int bar = 0; bar < width; bar++) putchar('#');
+    putchar('\n');
+  }
+}
+
+// 메모리 사용량과 트리 모양 (슬롯 점유, 깊이, 자식 수 분포)
+void ShowMemoryReport(WorkflowCLI* cli) {
+  struct TreeReportType report;
+  if (!Report_N_Tree(cli->tree, &report)) return;
+
+  printf("\nMemory:\n");
+  PrintBytesRow("Nodes", report.NodeBytes, report.TotalBytes);
+  PrintBytesRow("Child arrays", report.ChildArrayBytes, report.TotalBytes);
+  PrintBytesRow("Labels", report.LabelBytes, report.TotalBytes);
+  PrintBytesRow("Node registry", report.RegistryBytes, report.TotalBytes);
+  PrintBytesRow("Euler index", report.EulerBytes, report.TotalBytes);
+  PrintBytesRow("Roll-ups", report.RollupBytes, report.TotalBytes);
+  PrintBytesRow("Dependencies", report.DependencyBytes, report.TotalBytes);
+  PrintBytesRow("Attributes", report.AttributeBytes, report.TotalBytes);
+  PrintBytesRow("Pager", report.PagerBytes, report.TotalBytes);
+  printf("  %-16s: %12zu bytes (%.1f bytes/node)\n", "Total", report.TotalBytes,
+         report.Nodes > 0 ? (double)report.TotalBytes / report.Nodes : 0.0);
+  if (cli->tree->Pager != NULL) {
+    printf("  (%ld of %d nodes resident; the rest are still in %s)\n", report.Nodes, cli->tree->Count,
+           cli->tree->Pager->Snapshot->Path);
+  }
+  if (cli->tree->Garbage.Size > 0) {
+    printf("  (%ld removed subtree(s) are not freed yet; they are not counted above)\n", cli->tree->Garbage.Size);
+  }
+
+  long slots = report.ChildCapacity;
+  long used = report.Nodes - 1;
+  printf("\nShape:\n");
+  printf("  Nodes          : %ld (%ld leaves, %ld in slabs)\n", report.Nodes, report.Leaves, report.SlabNodes);
+  printf("  Slot occupancy : %ld of %ld allocated (%.2f%%)\n", used, slots, slots > 0 ? 100.0 * used / slots : 0.0);
+  printf("  Fan-out        : p50 %d, p90 %d, p99 %d, max %d\n", FanOutPercentile_N_Tree(&report, 50),
+         FanOutPercentile_N_Tree(&report, 90), FanOutPercentile_N_Tree(&report, 99), report.MaxFanOut);
+  printf("  Max depth      : %d\n", report.MaxDepth);
+
+  int depths = report.MaxDepth + 1 < REPORT_DEPTH_BUCKETS ? report.MaxDepth + 1 : REPORT_DEPTH_BUCKETS;
+  int fanOuts = report.ChildSize + 1 < REPORT_FANOUT_BUCKETS ? report.ChildSize + 1 : REPORT_FANOUT_BUCKETS;
+  PrintHistogramBars("Children per node:", report.Occupancy, fanOuts, report.Nodes);
+  PrintHistogramBars("Highest used slot + 1:", report.Span, fanOuts, report.Nodes);
+  PrintHistogramBars("Nodes per depth:", report.Depths, depths, report.Nodes);
+
+  printf("\nRecommendation:\n");
+  // 자식 블록은 쓰는 만큼만 잡히므로 ChildSize 는 슬롯 번호의 상한일 뿐이다
+  if (report.RecommendedChildSize < report.ChildSize) {
+    printf("  ChildSize %d keeps every slot position (current %d).\n", report.RecommendedChildSize, report.ChildSize);
+  } else {
+    printf("  ChildSize %d is already the smallest that keeps every slot position.\n", report.ChildSize);
+  }
+  printf("  Trimming child blocks to their used span would save %zu bytes of growth slack.\n", report.RecommendedSavings);
+  if (report.CompactChildSize < report.RecommendedChildSize) {
+    printf("  Repacking children to the leading slots would allow ChildSize %d.\n", report.CompactChildSize);
+  }
+  printf("\n");
+}
+
+// 계측 결과 (명령별 지연 시간, 트리 연산, 할당, JSON 입출력)
+void ShowMetrics(WorkflowCLI* cli, const char* action, const char* filepath) {
+  (void)cli;
+  if (!Metrics_Enabled()) {
+    printf("Metrics are disabled in this build (compiled with -DNO_TREE_METRICS).\n");
+    return;
+  }
 
-  int hasChildren = 0;
-  for (int i = 0; i < cli->tree->ChildSize; i++) {
-    if (cli->current->Children[i] != NULL) {
-      printf("  [%d] %s\n", i, cli->current->Children[i]->Data);
-      hasChildren = 1;
+  if (action == NULL || action[0] == '\0') {
+    PrintMetrics();
+  } else if (strcmp(action, "reset") == 0) {
+    ResetMetrics();
+    printf("Metrics reset.\n");
+  } else if (strcmp(action, "json") == 0 && filepath != NULL && filepath[0] != '\0') {
+    FILE* fp = fopen(filepath, "w");
+    if (fp == NULL) {
+      printf("Error! Failed to open file for writing: %s\n", filepath);
+      return;
     }
+    bool dumped = DumpMetricsJSON(fp);
+    fclose(fp);
+    if (dumped) {
+      printf("Metrics written to %s\n", filepath);
+    } else {
+      printf("Error! Failed to write metrics to %s\n", filepath);
+    }
+  } else {
+    printf("Usage: stats [reset|json <file>]\n");
+  }
+}
+
+// 루트부터 노드까지의 경로 출력
+void PrintNodePath(struct N_TreeType* tree, struct TreeNodeType* node) {
+  struct TreeNodeType* chain[MAX_PATH_DEPTH];
+  int depth = 0;
+
+  while (node != NULL && depth < MAX_PATH_DEPTH) {
+    chain[depth++] = node;
+    node = node->Parent;
+  }
+  for (int i = depth - 1; i >= 0; i--) {
+    printf("/%s", Data_N_Tree(tree, chain[i]));
+  }
+}
+
+typedef struct {
+  struct N_TreeType* tree;
+  const char* text;
+  LabelType label;
+} FindContext;
+
+static bool ContainsText(struct TreeNodeType* node, void* context) {
+  FindContext* find = (FindContext*)context;
+  return strstr(Data_N_Tree(find->tree, node), find->text) != NULL;
+}
+
+// 레이블은 중복 없이 등록되므로 정확히 일치하는지는 핸들 비교로 충분하다
+static bool SameLabel(struct TreeNodeType* node, void* context) {
+  return node->Label == ((FindContext*)context)->label;
+}
+
+// "=text" 는 정확히 일치하는 노드, 그 외에는 text 를 포함하는 노드를 찾는다
+void FindNodes(WorkflowCLI* cli, const char* text) {
+  FindContext context = { cli->tree, text, LABEL_NONE };
+  struct NodeListType found = { NULL, 0, 0 };
+  bool exact = (text[0] == '=');
+  LoadWholeTree(cli);
+
+  if (exact) {
+    context.text = text + 1;
+    context.label = Find_Label(cli->tree->Labels, context.text);
+    if (context.label != LABEL_NONE) {
+      found = ParallelFilter_N_Tree(cli->tree, SameLabel, &context, 0);
+    }
+  } else {
+    found = ParallelFilter_N_Tree(cli->tree, ContainsText, &context, 0);
+  }
+
+  printf("\nNodes %s '%s':\n", exact ? "labeled" : "containing", context.text);
+  for (long i = 0; i < found.Size; i++) {
+    printf("  ");
+    PrintNodePath(cli->tree, found.Items[i]);
+    printf("\n");
+  }
+  if (found.Size == 0) {
+    printf("  (no match)\n");
+  }
+  printf("\n");
+  FreeNodeList(&found);
+}
+
+// 경로 질의: "/" 로 시작하면 루트 기준, 아니면 현재 노드 기준
+void RunQuery(WorkflowCLI* cli, const char* text) {
+  struct QueryType* query = Compile_Query(text);
+  if (query == NULL) return;
+
+  Reclaim_N_Tree(cli->tree, 0);
+  struct NodeListType found = { NULL, 0, 0 };
+  if (Run_Query(cli->tree, query, cli->current, &found)) {
+    printf("\nNodes matching %s:\n", text);
+    for (long i = 0; i < found.Size; i++) {
+      printf("  ");
+      PrintNodePath(cli->tree, found.Items[i]);
+      printf("\n");
+    }
+    if (found.Size == 0) {
+      printf("  (no match)\n");
+    }
+    printf("%ld match(es), %ld of %d nodes examined\n\n", found.Size, query->Visited, cli->tree->Count);
   }
 
-  if (!hasChildren) {
+  FreeNodeList(&found);
+  Delete_Query(query);
+}
+
+void ListChildren(WorkflowCLI* cli) {
+  TRACE_BEGIN(span);
+  printf("\nChildren of '%s':\n", Data_N_Tree(cli->tree, cli->current));
+
+  FOR_EACH_CHILD_SLOT(cli->current, i) {
+    printf("  [%d] %s\n", i, Data_N_Tree(cli->tree, cli->current->Children[i]));
+  }
+
+  if (IsLeaf_N_Tree(cli->current)) {
     printf("  (no children)\n");
   }
   printf("\n");
+  TRACE_END(span, "ls", "render");
+}
+
+// 순서로 from 번째 자식부터 count 개 (넓은 노드는 시작 슬롯을 순위 표로 바로 찾는다)
+void ListChildrenPage(WorkflowCLI* cli, int from, int count) {
+  TRACE_BEGIN(span);
+  int total = ChildCount_N_Tree(cli->current);
+  printf("\nChildren of '%s' (%d total):\n", Data_N_Tree(cli->tree, cli->current), total);
+
+  int shown = 0;
+  for (int slot = NthChildSlot_N_Tree(cli->current, from); slot != -1 && shown < count;
+       slot = NextChildSlot_N_Tree(cli->current, slot)) {
+    printf("  #%-6d [%d] %s\n", from + shown, slot, Data_N_Tree(cli->tree, cli->current->Children[slot]));
+    shown++;
+  }
+
+  if (shown == 0) {
+    printf("  (no children from #%d)\n", from);
+  } else if (from + shown < total) {
+    printf("  ... %d more (ls %d %d)\n", total - from - shown, from + shown, count);
+  }
+  printf("\n");
+  TRACE_END(span, "ls", "render");
 }
 
 int GetChildIndex(struct TreeNodeType* parent, struct TreeNodeType* child, int childSize) {
   if (parent == NULL || child == NULL) return -1;
 
-  for (int i = 0; i < childSize; i++) {
-    if (parent->Children[i] == child) {
-      return i;
-    }
+  // 노드가 자기 슬롯을 기억하므로 자식 배열을 훑지 않는다
+  if (child->Slot < childSize && ChildAt_N_Tree(parent, child->Slot) == child) {
+    return child->Slot;
   }
   return -1;
 }
 
+// 인덱스 경로 해석: "/0/2" 는 루트 기준, "1/0" 이나 "../3" 은 현재 노드 기준
+struct TreeNodeType* ResolveNodePath(WorkflowCLI* cli, const char* path) {
+  if (cli == NULL || path == NULL) return NULL;
+
+  struct TreeNodeType* node = (*path == '/') ? cli->tree->Head : cli->current;
+  const char* p = path;
+
+  while (*p && node != NULL) {
+    while (*p == '/') p++;
+    if (!*p) break;
+
+    if (strncmp(p, "..", 2) == 0 && (p[2] == '/' || p[2] == '\0')) {
+      node = node->Parent;
+      p += 2;
+    } else if (*p == '.' && (p[1] == '/' || p[1] == '\0')) {
+      p += 1;
+    } else {
+      char* end = NULL;
+      long index = strtol(p, &end, 10);
+      if (end == p || (*end != '/' && *end != '\0')) return NULL;
+      if (index < 0 || index >= cli->tree->ChildSize) return NULL;
+
+      node = ChildAt_N_Tree(node, index);
+      p = end;
+    }
+  }
+  return node;
+}
+
+void ShowCommonAncestor(WorkflowCLI* cli, const char* first, const char* second) {
+  struct TreeNodeType* a = ResolveNodePath(cli, first);
+  struct TreeNodeType* b = ResolveNodePath(cli, second);
+
+  if (a == NULL || b == NULL) {
+    printf("Error! No node at path '%s'.\n", a == NULL ? first : second);
+    return;
+  }
+
+  struct TreeNodeType* ancestor = LowestCommonAncestor_N_Tree(cli->tree, a, b);
+  if (ancestor == NULL) {
+    printf("Error! Failed to find common ancestor.\n");
+    return;
+  }
+
+  printf("Lowest common ancestor: ");
+  PrintNodePath(cli->tree, ancestor);
+  printf(" (depth %d, %d nodes in subtree)\n",
+         Depth_N_Tree(cli->tree, ancestor), SubtreeSize_N_Tree(cli->tree, ancestor));
+}
+
 void ChangeDirectory(WorkflowCLI* cli, const char* target) {
   if (strcmp(target, "..") == 0) {
     // 부모로 이동
     if (cli->current->Parent != NULL) {
       cli->current = cli->current->Parent;
       UpdatePath(cli);
-      printf("Moved to parent: %s\n", cli->current->Data);
+      printf("Moved to parent: %s\n", Data_N_Tree(cli->tree, cli->current));
     } else {
       printf("Already at root node.\n");
     }
@@ -223,7 +605,8 @@ void ChangeDirectory(WorkflowCLI* cli, const char* target) {
     if (child != NULL) {
       cli->current = child;
       UpdatePath(cli);
-      printf("Moved to: %s\n", cli->current->Data);
+      Fault_N_Tree(cli->tree, cli->current);
+      printf("Moved to: %s\n", Data_N_Tree(cli->tree, cli->current));
     } else {
       printf("No child at position %d\n", index);
     }
@@ -237,13 +620,15 @@ void InsertNode(WorkflowCLI* cli, const char* data, int position) {
   }
 
   // 해당 위치가 비어있는지 확인하고, 비어있으면 삽입
-  if (cli->current->Children[position] != NULL) {
+  if (ChildAt_N_Tree(cli->current, position) != NULL) {
     printf("Warning! Position %d is already occupied. Skipping insertion.\n", position);
     return;
   }
 
+  TRACE_BEGIN(span);
   Insert_ChildNode_N_Tree(cli->tree, cli->current, (char*)data, position);
-  printf("Inserted '%s' at position %d under '%s'\n", data, position, cli->current->Data);
+  TRACE_END(span, "Insert_ChildNode_N_Tree", "tree");
+  printf("Inserted '%s' at position %d under '%s'\n", data, position, Data_N_Tree(cli->tree, cli->current));
   AutoSave(cli);
 }
 
@@ -253,8 +638,10 @@ void InsertParent(WorkflowCLI* cli, const char* data) {
     return;
   }
 
+  TRACE_BEGIN(span);
   Insert_ParentNode_N_Tree(cli->tree, cli->current, (char*)data);
-  printf("Inserted parent '%s' above '%s'\n", data, cli->current->Data);
+  TRACE_END(span, "Insert_ParentNode_N_Tree", "tree");
+  printf("Inserted parent '%s' above '%s'\n", data, Data_N_Tree(cli->tree, cli->current));
 
   // 현재 위치를 새로 삽입된 부모로 이동
   cli->current = cli->current->Parent;
@@ -265,15 +652,11 @@ void InsertParent(WorkflowCLI* cli, const char* data) {
 void RemoveNode(WorkflowCLI* cli, bool clearAll) {
   if (cli->current == cli->tree->Head) {
     if (clearAll) {
-      // Remove all children of the root node
-      int removedCount = 0;
-      for (int i = 0; i < cli->tree->ChildSize; i++) {
-        if (cli->current->Children[i] != NULL) {
-          Clear_N_Tree(cli->tree, cli->current->Children[i]);
-          cli->current->Children[i] = NULL;
-          removedCount++;
-        }
-      }
+      // Remove all children of the root node (해제는 명령 사이에 나누어 한다)
+      int removedCount = ChildCount_N_Tree(cli->current);
+      TRACE_BEGIN(span);
+      if (removedCount > 0) Detach_N_Tree(cli->tree, cli->current);
+      TRACE_END(span, "Detach_N_Tree", "tree");
       if (removedCount > 0) {
         printf("Removed all %d children of root node.\n", removedCount);
         UpdatePath(cli);
@@ -288,11 +671,13 @@ void RemoveNode(WorkflowCLI* cli, bool clearAll) {
     return;
   }
 
-  char nodeName[SIZE];
-  strncpy(nodeName, cli->current->Data, SIZE);
+  // 레이블 표는 추가만 하므로 노드를 해제한 뒤에도 이름을 출력할 수 있다
+  const char* nodeName = Data_N_Tree(cli->tree, cli->current);
 
   struct TreeNodeType* parent = cli->current->Parent;
-  bool result = Remove_N_Tree(cli->tree, cli->current, clearAll);
+  TRACE_BEGIN(span);
+  bool result = clearAll ? Detach_N_Tree(cli->tree, cli->current) : Remove_N_Tree(cli->tree, cli->current, false);
+  TRACE_END(span, clearAll ? "Detach_N_Tree" : "Remove_N_Tree", "tree");
 
   if (result) {
     printf("Removed node '%s'%s\n", nodeName, clearAll ? " (with all children)" : "");
@@ -309,334 +694,1402 @@ void RemoveNode(WorkflowCLI* cli, bool clearAll) {
   }
 }
 
-void EditCurrentNode(WorkflowCLI* cli, const char* newData) {
-  strncpy(cli->current->Data, newData, SIZE - 1);
-  cli->current->Data[SIZE - 1] = '\0';
-  UpdatePath(cli);
-  printf("Node data updated to: %s\n", newData);
-  AutoSave(cli);
-}
-
-// JSON 저장 관련 함수들
-static void WriteEscapedString(FILE* fp, const char* str) {
-  // 큰따옴표를 이스케이프 처리하여 출력
-  while (*str) {
-    if (*str == '"') {
-      fprintf(fp, "\\\"");
-    } else if (*str == '\\') {
-      fprintf(fp, "\\\\");
+// "<parent>/<pos>" 목적지를 새 부모와 슬롯 번호로 나눈다 (마지막 요소는 슬롯 번호, 그 앞은 새 부모 경로)
+static struct TreeNodeType* ResolveDestination(WorkflowCLI* cli, const char* destination, long* position) {
+  char parentPath[MAX_COMMAND_LEN];
+  const char* slash = strrchr(destination, '/');
+  const char* slot = destination;
+  if (slash == NULL) {
+    strcpy(parentPath, ".");
+  } else {
+    size_t length = slash - destination;
+    if (length == 0) {
+      strcpy(parentPath, "/");
     } else {
-      fputc(*str, fp);
+      memcpy(parentPath, destination, length);
+      parentPath[length] = '\0';
     }
-    str++;
+    slot = slash + 1;
   }
-}
 
-static void WriteNodeToJSON(FILE* fp, struct TreeNodeType* node, int childSize, int depth) {
-  if (node == NULL) {
-    fprintf(fp, "null");
-    return;
+  char* end = NULL;
+  *position = strtol(slot, &end, 10);
+  if (end == slot || *end != '\0') {
+    printf("Error! Destination must end with a slot number: %s\n", destination);
+    return NULL;
   }
 
-  // 들여쓰기
-  char indent[256] = "";
-  for (int i = 0; i < depth; i++) {
-    strcat(indent, "  ");
+  struct TreeNodeType* newParent = ResolveNodePath(cli, parentPath);
+  if (newParent == NULL) {
+    printf("Error! No node at path '%s'.\n", parentPath);
   }
+  return newParent;
+}
 
-  fprintf(fp, "{\n");
-  fprintf(fp, "%s  \"data\": \"", indent);
-  WriteEscapedString(fp, node->Data);
-  fprintf(fp, "\"");
-
-  // 자식 노드들 확인
-  int hasChildren = 0;
-  for (int i = 0; i < childSize; i++) {
-    if (node->Children[i] != NULL) {
-      hasChildren = 1;
-      break;
-    }
+void MoveSubtree(WorkflowCLI* cli, const char* source, const char* destination) {
+  struct TreeNodeType* node = ResolveNodePath(cli, source);
+  if (node == NULL) {
+    printf("Error! No node at path '%s'.\n", source);
+    return;
   }
 
-  if (hasChildren) {
-    fprintf(fp, ",\n%s  \"children\": [\n", indent);
-    int firstChild = 1;
-    for (int i = 0; i < childSize; i++) {
-      if (!firstChild) {
-        fprintf(fp, ",\n");
-      }
-      fprintf(fp, "%s    ", indent);
-      WriteNodeToJSON(fp, node->Children[i], childSize, depth + 2);
-      if (node->Children[i] != NULL) {
-        firstChild = 0;
-      }
-    }
-    fprintf(fp, "\n%s  ]", indent);
-  }
+  long position = 0;
+  struct TreeNodeType* newParent = ResolveDestination(cli, destination, &position);
+  if (newParent == NULL) return;
+
+  TRACE_BEGIN(span);
+  bool moved = Move_Subtree_N_Tree(cli->tree, node, newParent, (int)position);
+  TRACE_END(span, "Move_Subtree_N_Tree", "tree");
+  if (!moved) return;
 
-  fprintf(fp, "\n%s}", indent);
+  printf("Moved '%s' to position %ld under '%s'\n",
+         Data_N_Tree(cli->tree, node), position, Data_N_Tree(cli->tree, newParent));
+  UpdatePath(cli);
+  AutoSave(cli);
 }
 
-void SaveTreeToJSON(WorkflowCLI* cli) {
-  if (cli == NULL || cli->tree == NULL) {
-    printf("Error! Invalid CLI or tree.\n");
+// 서브트리 전체를 복사해 목적지 슬롯에 단다 (원본은 그대로)
+void CopySubtree(WorkflowCLI* cli, const char* source, const char* destination) {
+  struct TreeNodeType* node = ResolveNodePath(cli, source);
+  if (node == NULL) {
+    printf("Error! No node at path '%s'.\n", source);
     return;
   }
 
-  FILE* fp = fopen(cli->jsonFilePath, "w");
-  if (fp == NULL) {
-    printf("Error! Failed to open file for writing: %s\n", cli->jsonFilePath);
-    return;
-  }
+  long position = 0;
+  struct TreeNodeType* newParent = ResolveDestination(cli, destination, &position);
+  if (newParent == NULL) return;
 
-  fprintf(fp, "{\n");
-  fprintf(fp, "  \"childSize\": %d,\n", cli->tree->ChildSize);
-  fprintf(fp, "  \"count\": %d,\n", cli->tree->Count);
-  fprintf(fp, "  \"tree\": ");
-  WriteNodeToJSON(fp, cli->tree->Head, cli->tree->ChildSize, 1);
-  fprintf(fp, "\n}\n");
+  int before = cli->tree->Count;
+  TRACE_BEGIN(span);
+  struct TreeNodeType* copy = Clone_Subtree_N_Tree(cli->tree, node, newParent, (int)position);
+  TRACE_END(span, "Clone_Subtree_N_Tree", "tree");
+  if (copy == NULL) return;
 
-  fclose(fp);
+  printf("Copied '%s' (%d nodes) to position %ld under '%s'\n",
+         Data_N_Tree(cli->tree, copy), cli->tree->Count - before, position, Data_N_Tree(cli->tree, newParent));
+  AutoSave(cli);
 }
 
-void AutoSave(WorkflowCLI* cli) {
-  SaveTreeToJSON(cli);
+// 명령을 실행한 노드가 끝날 때마다 결과를 한 줄씩 출력한다
+static void PrintRunProgress(struct N_TreeType* tree, struct TreeNodeType* node, enum RunStatusType status, void* context) {
+  (void)context;
+  char exitCode[ATTR_TEXT_SIZE];
+  char elapsed[ATTR_TEXT_SIZE];
+  if (status != RUN_OK && status != RUN_FAILED) return;
+  if (!GetAttribute_N_Tree(tree, node, RUN_ATTR_EXIT, exitCode, sizeof(exitCode))) return;
+  if (!GetAttribute_N_Tree(tree, node, RUN_ATTR_ELAPSED, elapsed, sizeof(elapsed))) strcpy(elapsed, "?");
+
+  printf("  [%-6s] ", RunStatusName(status));
+  PrintNodePath(tree, node);
+  printf(" (exit %s, %ss)\n", exitCode, elapsed);
+  fflush(stdout);
 }
 
-// JSON 불러오기 관련 함수들
-static char* ReadFileContent(const char* filepath) {
-  FILE* fp = fopen(filepath, "r");
-  if (fp == NULL) {
-    return NULL;
+// run [path] [-j N] [-k] [--labels]: 노드의 cmd 속성을 작업으로 실행 (mode=parallel 이면 자식을 동시에)
+void RunTasks(WorkflowCLI* cli, const char* first, const char* rest) {
+  struct RunOptionsType options = { 0, false, false, PrintRunProgress, NULL };
+  const char* path = NULL;
+  char arguments[MAX_COMMAND_LEN * 2];
+  snprintf(arguments, sizeof(arguments), "%s %s", first != NULL ? first : "", rest != NULL ? rest : "");
+
+  for (char* token = strtok(arguments, " \t"); token != NULL; token = strtok(NULL, " \t")) {
+    if (strcmp(token, "-j") == 0) {
+      char* value = strtok(NULL, " \t");
+      options.Jobs = value != NULL ? atoi(value) : 0;
+      if (options.Jobs < 1 || options.Jobs > RUN_MAX_JOBS) {
+        printf("Error! -j must be between 1 and %d.\n", RUN_MAX_JOBS);
+        return;
+      }
+    } else if (strcmp(token, "-k") == 0 || strcmp(token, "--keep-going") == 0) {
+      options.KeepGoing = true;
+    } else if (strcmp(token, "--labels") == 0) {
+      options.LabelCommands = true;
+    } else if (path == NULL && token[0] != '-') {
+      path = token;
+    } else {
+      printf("Usage: run [path] [-j N] [-k] [--labels]\n");
+      return;
+    }
   }
 
-  fseek(fp, 0, SEEK_END);
-  long size = ftell(fp);
-  fseek(fp, 0, SEEK_SET);
-
-  char* content = (char*)malloc(size + 1);
-  if (content == NULL) {
-    fclose(fp);
-    return NULL;
+  struct TreeNodeType* root = ResolveNodePath(cli, path != NULL ? path : ".");
+  if (root == NULL) {
+    printf("Error! No node at path '%s'.\n", path);
+    return;
   }
 
-  fread(content, 1, size, fp);
-  content[size] = '\0';
-  fclose(fp);
+  struct RunResultType result;
+  TRACE_BEGIN(span);
+  bool success = Run_N_Tree(cli->tree, root, &options, &result);
+  TRACE_END(span, "Run_N_Tree", "run");
+  if (result.Ok + result.Failed + result.Skipped == 0) return;
 
-  return content;
+  printf("\nRun %s: %ld ok, %ld failed, %ld skipped, %ld command(s) in %.3fs\n\n",
+         success ? "succeeded" : "failed", result.Ok, result.Failed, result.Skipped, result.Commands, result.Elapsed);
+  AutoSave(cli);
 }
 
-static char* SkipWhitespace(char* str) {
-  while (*str && (*str == ' ' || *str == '\t' || *str == '\n' || *str == '\r')) {
-    str++;
+// critical [path]: 소요 시간 합계가 가장 긴 자식을 따라 내려간 경로와 서브트리 합계
+void ShowCriticalPath(WorkflowCLI* cli, const char* path) {
+  LoadWholeTree(cli);
+  struct TreeNodeType* root = path != NULL ? ResolveNodePath(cli, path) : cli->current;
+  if (root == NULL) {
+    printf("Error! No node at path '%s'.\n", path);
+    return;
   }
-  return str;
+
+  struct TreeNodeType* chain[MAX_PATH_DEPTH];
+  TRACE_BEGIN(span);
+  int length = CriticalPath_N_Tree(cli->tree, root, chain, MAX_PATH_DEPTH);
+  TRACE_END(span, "CriticalPath_N_Tree", "tree");
+  const struct RollupValueType* total = RollupOf_N_Tree(cli->tree, root);
+  if (length == 0 || total == NULL) return;
+
+  printf("\nCritical path from '%s':\n", Data_N_Tree(cli->tree, root));
+  printf("  Span : %g\n", total->Span);
+  printf("  Work : %g (parallelism %.2f)\n", total->Work, total->Span > 0 ? total->Work / total->Span : 1.0);
+  printf("  Cost : %g\n\n", total->Cost);
+  printf("  %12s %12s  %-10s  %s\n", "span", "duration", "children", "node");
+
+  int shown = length < MAX_PATH_DEPTH ? length : MAX_PATH_DEPTH;
+  for (int i = 0; i < shown; i++) {
+    struct TreeNodeType* node = chain[i];
+    char duration[ATTR_TEXT_SIZE];
+    char mode[ATTR_TEXT_SIZE];
+    char children[32];
+    if (!GetAttribute_N_Tree(cli->tree, node, ROLLUP_ATTR_DURATION, duration, sizeof(duration))) strcpy(duration, "0");
+    int count = ChildCount_N_Tree(node);
+    bool parallel = GetAttribute_N_Tree(cli->tree, node, RUN_ATTR_MODE, mode, sizeof(mode)) && strcmp(mode, "parallel") == 0;
+    if (count == 0) strcpy(children, "-");
+    else snprintf(children, sizeof(children), "%d %s", count, parallel ? "par" : "seq");
+
+    printf("  %12g %12s  %-10s  %*s%s\n", RollupOf_N_Tree(cli->tree, node)->Span, duration, children, i * 2, "", Data_N_Tree(cli->tree, node));
+  }
+  if (shown < length) {
+    printf("  ... %d more node(s)\n", length - shown);
+  }
+  printf("\n");
 }
 
-static char* ParseString(char* str, char* output, int maxLen) {
-  str = SkipWhitespace(str);
-  if (*str != '"') return NULL;
-  str++;
+// dep <path> <on> / undep <path> <on>: path 노드가 on 노드가 끝난 뒤에 시작하도록 잇거나 끊는다
+void LinkDependency(WorkflowCLI* cli, const char* path, const char* target, bool add) {
+  struct TreeNodeType* node = ResolveNodePath(cli, path);
+  struct TreeNodeType* on = ResolveNodePath(cli, target);
+  if (node == NULL || on == NULL) {
+    printf("Error! No node at path '%s'.\n", node == NULL ? path : target);
+    return;
+  }
 
-  int i = 0;
-  while (*str && *str != '"' && i < maxLen - 1) {
-    // 이스케이프된 따옴표 처리
-    if (*str == '\\' && *(str + 1) == '"') {
-      output[i++] = '"';
-      str += 2;
-    } else {
-      output[i++] = *str++;
+  if (add) {
+    TRACE_BEGIN(span);
+    bool linked = AddDependency_N_Tree(cli->tree, node, on);
+    TRACE_END(span, "AddDependency_N_Tree", "tree");
+    if (!linked) return;
+    printf("'%s' now waits for '%s' (%ld dependencies)\n", Data_N_Tree(cli->tree, node), Data_N_Tree(cli->tree, on), DependencyCount_N_Tree(cli->tree));
+  } else {
+    if (!RemoveDependency_N_Tree(cli->tree, node, on)) {
+      printf("Error! '%s' does not wait for '%s'.\n", Data_N_Tree(cli->tree, node), Data_N_Tree(cli->tree, on));
+      return;
     }
+    printf("'%s' no longer waits for '%s'\n", Data_N_Tree(cli->tree, node), Data_N_Tree(cli->tree, on));
   }
-  output[i] = '\0';
-
-  if (*str == '"') str++;
-  return str;
+  AutoSave(cli);
 }
 
-static char* ParseNumber(char* str, int* value) {
-  str = SkipWhitespace(str);
-  *value = 0;
-  while (*str >= '0' && *str <= '9') {
-    *value = (*value * 10) + (*str - '0');
-    str++;
+static void PrintDependencyList(struct N_TreeType* tree, const char* title, const int* ids, int count) {
+  printf("  %s (%d):\n", title, count);
+  for (int i = 0; i < count; i++) {
+    char status[ATTR_TEXT_SIZE];
+    struct TreeNodeType* node = NodeById_N_Tree(tree, ids[i]);
+    if (!GetAttribute_N_Tree(tree, node, RUN_ATTR_STATUS, status, sizeof(status))) strcpy(status, "-");
+    printf("    %-8s ", status);
+    PrintNodePath(tree, node);
+    printf("  %s\n", Data_N_Tree(tree, node));
   }
-  return str;
 }
 
-static char* ParseNode(char* str, struct TreeNodeType** node, int childSize, int depth);
+// deps [path]: 노드가 기다리는 노드와 노드를 기다리는 노드
+void ShowDependencies(WorkflowCLI* cli, const char* path) {
+  struct TreeNodeType* node = path != NULL ? ResolveNodePath(cli, path) : cli->current;
+  if (node == NULL) {
+    printf("Error! No node at path '%s'.\n", path);
+    return;
+  }
 
-static char* ParseChildren(char* str, struct TreeNodeType* parent, int childSize, int depth) {
-  str = SkipWhitespace(str);
-  if (*str != '[') return NULL;
-  str++;
+  int waits;
+  int needed;
+  const int* on = DependsOn_N_Tree(cli->tree, node, &waits);
+  const int* by = DependedBy_N_Tree(cli->tree, node, &needed);
 
-  // 최대 깊이 제한 (무한 재귀 방지)
-  if (depth > MAX_PARSE_DEPTH) {
-    printf("Error! Maximum parsing depth exceeded.\n");
-    return NULL;
+  printf("\nDependencies of '%s':\n", Data_N_Tree(cli->tree, node));
+  PrintDependencyList(cli->tree, "Waits for", on, waits);
+  PrintDependencyList(cli->tree, "Needed by", by, needed);
+  printf("  (%ld dependencies in the tree)\n\n", DependencyCount_N_Tree(cli->tree));
+}
+
+// order [path] [count]: 자식과 의존 대상이 항상 먼저 오는 실행 순서
+void ShowTopologicalOrder(WorkflowCLI* cli, const char* path, int count) {
+  LoadWholeTree(cli);
+  struct TreeNodeType* root = path != NULL ? ResolveNodePath(cli, path) : cli->current;
+  if (root == NULL) {
+    printf("Error! No node at path '%s'.\n", path);
+    return;
+  }
+
+  struct NodeListType order = { NULL, 0, 0 };
+  TRACE_BEGIN(span);
+  bool ok = TopologicalOrder_N_Tree(cli->tree, root, &order);
+  TRACE_END(span, "TopologicalOrder_N_Tree", "tree");
+  if (!ok) {
+    FreeNodeList(&order);
+    return;
+  }
+
+  printf("\nExecution order under '%s' (%ld nodes):\n", Data_N_Tree(cli->tree, root), order.Size);
+  long shown = order.Size < count ? order.Size : count;
+  for (long i = 0; i < shown; i++) {
+    printf("  %6ld  ", i);
+    PrintNodePath(cli->tree, order.Items[i]);
+    printf("  %s\n", Data_N_Tree(cli->tree, order.Items[i]));
+  }
+  if (shown < order.Size) {
+    printf("  ... %ld more node(s)\n", order.Size - shown);
+  }
+  printf("\n");
+  FreeNodeList(&order);
+}
+
+// ready [path]: 자식과 의존 대상이 모두 ok 라서 지금 시작할 수 있는 노드
+void ShowReadyTasks(WorkflowCLI* cli, const char* path) {
+  LoadWholeTree(cli);
+  struct TreeNodeType* root = path != NULL ? ResolveNodePath(cli, path) : cli->current;
+  if (root == NULL) {
+    printf("Error! No node at path '%s'.\n", path);
+    return;
+  }
+
+  struct NodeListType ready = { NULL, 0, 0 };
+  TRACE_BEGIN(span);
+  bool ok = ReadyTasks_N_Tree(cli->tree, root, &ready);
+  TRACE_END(span, "ReadyTasks_N_Tree", "run");
+  if (!ok) {
+    FreeNodeList(&ready);
+    return;
+  }
+
+  printf("\nReady to run under '%s' (%ld nodes):\n", Data_N_Tree(cli->tree, root), ready.Size);
+  for (long i = 0; i < ready.Size; i++) {
+    printf("  ");
+    PrintNodePath(cli->tree, ready.Items[i]);
+    printf("  %s\n", Data_N_Tree(cli->tree, ready.Items[i]));
+  }
+  printf("\n");
+  FreeNodeList(&ready);
+}
+
+// "key" 또는 "key:type" 형태의 속성 지정
+void SetAttribute(WorkflowCLI* cli, const char* spec, const char* value) {
+  char name[ATTR_NAME_SIZE];
+  enum AttributeKindType kind = ATTR_AUTO;
+  const char* colon = strchr(spec, ':');
+  size_t length = colon == NULL ? strlen(spec) : (size_t)(colon - spec);
+
+  if (length == 0 || length >= sizeof(name)) {
+    printf("Error! Attribute name must be 1 ~ %d characters.\n", ATTR_NAME_SIZE - 1);
+    return;
+  }
+  memcpy(name, spec, length);
+  name[length] = '\0';
+
+  if (colon != NULL) {
+    kind = ParseAttributeKind(colon + 1);
+    if (kind == ATTR_AUTO) {
+      printf("Error! Unknown attribute type '%s' (int, float, string, time).\n", colon + 1);
+      return;
+    }
+  }
+
+  if (!SetAttribute_N_Tree(cli->tree, cli->current, name, kind, value)) return;
+
+  char text[ATTR_TEXT_SIZE];
+  GetAttribute_N_Tree(cli->tree, cli->current, name, text, sizeof(text));
+  printf("Set %s = %s on '%s'\n", name, text, Data_N_Tree(cli->tree, cli->current));
+  AutoSave(cli);
+}
+
+void ShowAttributes(WorkflowCLI* cli, const char* name) {
+  struct AttributeTableType* table = cli->tree->Attributes;
+  char text[ATTR_TEXT_SIZE];
+  int shown = 0;
+
+  printf("\nAttributes of '%s':\n", Data_N_Tree(cli->tree, cli->current));
+  for (int i = 0; table != NULL && i < table->Count; i++) {
+    struct AttributeColumnType* column = &table->Columns[i];
+    if (name != NULL && strcmp(column->Name, name) != 0) continue;
+    if (!HasAttributeValue(column, cli->current->Id)) continue;
+
+    FormatAttributeValue(cli->tree, column, cli->current->Id, text, sizeof(text));
+    printf("  %-16s %-6s %s\n", column->Name, AttributeKindName(column->Kind), text);
+    shown++;
+  }
+  if (shown == 0) {
+    printf("  (no attributes)\n");
+  }
+  printf("\n");
+}
+
+void UnsetAttribute(WorkflowCLI* cli, const char* name) {
+  if (!UnsetAttribute_N_Tree(cli->tree, cli->current, name)) {
+    printf("Error! '%s' has no attribute '%s'.\n", Data_N_Tree(cli->tree, cli->current), name);
+    return;
+  }
+  printf("Removed attribute '%s' from '%s'\n", name, Data_N_Tree(cli->tree, cli->current));
+  AutoSave(cli);
+}
+
+void FindWhere(WorkflowCLI* cli, const char* expression) {
+  struct NodeListType found = { NULL, 0, 0 };
+  if (!Where_N_Tree(cli->tree, expression, &found)) {
+    FreeNodeList(&found);
+    return;
+  }
+
+  printf("\nNodes where %s:\n", expression);
+  for (long i = 0; i < found.Size; i++) {
+    printf("  ");
+    PrintNodePath(cli->tree, found.Items[i]);
+    printf("\n");
+  }
+  if (found.Size == 0) {
+    printf("  (no match)\n");
+  }
+  printf("\n");
+  FreeNodeList(&found);
+}
+
+void ListAttributeColumns(WorkflowCLI* cli) {
+  struct AttributeTableType* table = cli->tree->Attributes;
+
+  printf("\nAttribute columns:\n");
+  for (int i = 0; table != NULL && i < table->Count; i++) {
+    printf("  %-16s %-6s %d node(s)\n", table->Columns[i].Name,
+           AttributeKindName(table->Columns[i].Kind), table->Columns[i].Size);
+  }
+  if (table == NULL || table->Count == 0) {
+    printf("  (no attributes)\n");
+  }
+  printf("\n");
+}
+
+void SaveAttributeFile(WorkflowCLI* cli, const char* filepath) {
+  FILE* fp = fopen(filepath, "wb");
+  if (fp == NULL) {
+    printf("Error! Failed to open file for writing: %s\n", filepath);
+    return;
+  }
+  bool saved = SaveAttributesBinary(cli->tree, fp);
+  fclose(fp);
+
+  if (saved) {
+    printf("Saved attributes to %s\n", filepath);
+  } else {
+    printf("Error! Failed to save attributes to %s\n", filepath);
+  }
+}
+
+void LoadAttributeFile(WorkflowCLI* cli, const char* filepath) {
+  FILE* fp = fopen(filepath, "rb");
+  if (fp == NULL) {
+    printf("Error! Failed to open file: %s\n", filepath);
+    return;
+  }
+  bool loaded = LoadAttributesBinary(cli->tree, fp);
+  fclose(fp);
+
+  if (loaded) {
+    printf("Loaded attributes from %s\n", filepath);
+    AutoSave(cli);
+  }
+}
+
+void EditCurrentNode(WorkflowCLI* cli, const char* newData) {
+  TRACE_BEGIN(span);
+  bool updated = SetData_N_Tree(cli->tree, cli->current, newData);
+  TRACE_END(span, "SetData_N_Tree", "tree");
+  if (!updated) {
+    printf("Error! Failed to update node data.\n");
+    return;
+  }
+  UpdatePath(cli);
+  printf("Node data updated to: %s\n", newData);
+  AutoSave(cli);
+}
+
+// JSON 저장 관련 함수들
+static void WriteEscapedString(FILE* fp, const char* str) {
+  // 큰따옴표를 이스케이프 처리하여 출력
+  while (*str) {
+    if (*str == '"') {
+      fprintf(fp, "\\\"");
+    } else if (*str == '\\') {
+      fprintf(fp, "\\\\");
+    } else {
+      fputc(*str, fp);
+    }
+    str++;
+  }
+}
+
+static void WriteNodeToJSON(FILE* fp, struct N_TreeType* tree, struct TreeNodeType* node, int depth) {
+  if (node == NULL) {
+    fprintf(fp, "null");
+    return;
+  }
+
+  // 들여쓰기 (깊은 트리도 버퍼 없이 폭만 지정해 쓴다)
+  int indent = depth * 2;
+
+  fprintf(fp, "{\n");
+  fprintf(fp, "%*s  \"data\": \"", indent, "");
+  WriteEscapedString(fp, Data_N_Tree(tree, node));
+  fprintf(fp, "\"");
+
+  // 자식 배열은 마지막으로 점유된 슬롯까지만 쓴다 (뒤쪽 빈 슬롯은 읽을 때 null 로 채워짐)
+  int lastSlot = LastChildSlot_N_Tree(node);
+  if (lastSlot != -1) {
+    fprintf(fp, ",\n%*s  \"children\": [\n", indent, "");
+    for (int i = 0; i <= lastSlot; i++) {
+      if (i > 0) {
+        fprintf(fp, ",\n");
+      }
+      fprintf(fp, "%*s    ", indent, "");
+      WriteNodeToJSON(fp, tree, node->Children[i], depth + 2);
+    }
+    fprintf(fp, "\n%*s  ]", indent, "");
+  }
+
+  fprintf(fp, "\n%*s}", indent, "");
+}
+
+// 속성 열: 노드는 전위 순서 번호로 기록한다 (불러올 때 같은 순서로 번호를 매긴다)
+static void WriteAttributesToJSON(FILE* fp, struct N_TreeType* tree) {
+  struct AttributeTableType* table = tree->Attributes;
+  if (table == NULL || table->Count == 0) return;
+  if (!Renumber_N_Tree(tree)) return;
+
+  char text[ATTR_TEXT_SIZE];
+  fprintf(fp, ",\n  \"attributes\": {");
+  for (int i = 0; i < table->Count; i++) {
+    struct AttributeColumnType* column = &table->Columns[i];
+    fprintf(fp, "%s\n    \"", i > 0 ? "," : "");
+    WriteEscapedString(fp, column->Name);
+    fprintf(fp, "\": {\n      \"type\": \"%s\",\n      \"values\": {", AttributeKindName(column->Kind));
+
+    int written = 0;
+    for (int id = 0; id < column->Capacity; id++) {
+      if (!HasAttributeValue(column, id)) continue;
+
+      fprintf(fp, "%s\n        \"%d\": \"", written > 0 ? "," : "", tree->Nodes[id]->Entry);
+      if (column->Kind == ATTR_STRING) {
+        WriteEscapedString(fp, Label_Text(tree->Labels, column->Values.Strings[id]));
+      } else {
+        FormatAttributeValue(tree, column, id, text, sizeof(text));
+        fprintf(fp, "%s", text);
+      }
+      fprintf(fp, "\"");
+      written++;
+    }
+    fprintf(fp, "\n      }\n    }");
+  }
+  fprintf(fp, "\n  }");
+}
+
+// "dependencies": { "<전위 번호>": [<기다리는 노드의 전위 번호>, ...] }
+static void WriteDependenciesToJSON(FILE* fp, struct N_TreeType* tree) {
+  struct DependencyIndexType* index = tree->Dependencies;
+  if (index == NULL || index->EdgeCount == 0) return;
+  if (!Renumber_N_Tree(tree)) return;
+
+  fprintf(fp, ",\n  \"dependencies\": {");
+  int written = 0;
+  for (int i = 0; i < index->ListCount; i++) {
+    const struct DependencyListType* list = &index->Lists[i];
+    if (list->OnCount == 0) continue;
+
+    fprintf(fp, "%s\n    \"%d\": [", written > 0 ? "," : "", tree->Nodes[list->Id]->Entry);
+    for (int edge = 0; edge < list->OnCount; edge++) {
+      fprintf(fp, "%s%d", edge > 0 ? ", " : "", tree->Nodes[list->Ids[edge]]->Entry);
+    }
+    fprintf(fp, "]");
+    written++;
+  }
+  fprintf(fp, "\n  }");
+}
+
+// 속성과 의존 간선의 요약 값 (구조는 루트 해시가 맡는다)
+static unsigned long long ContentDigest(struct N_TreeType* tree) {
+  return AttributeDigest_N_Tree(tree) * 31 + DependencyDigest_N_Tree(tree);
+}
+
+void SaveTreeToJSON(WorkflowCLI* cli) {
+  if (cli == NULL || cli->tree == NULL) {
+    printf("Error! Invalid CLI or tree.\n");
+    return;
+  }
+
+  LoadWholeTree(cli);
+  Reclaim_N_Tree(cli->tree, 0);
+  METRIC_START(timer);
+  FILE* fp = fopen(cli->jsonFilePath, "w");
+  if (fp == NULL) {
+    printf("Error! Failed to open file for writing: %s\n", cli->jsonFilePath);
+    return;
+  }
+
+  fprintf(fp, "{\n");
+  fprintf(fp, "  \"childSize\": %d,\n", cli->tree->ChildSize);
+  fprintf(fp, "  \"count\": %d,\n", cli->tree->Count);
+  fprintf(fp, "  \"hash\": \"%016llx\",\n", cli->tree->Head->Hash);
+  fprintf(fp, "  \"digest\": \"%016llx\",\n", ContentDigest(cli->tree));
+  fprintf(fp, "  \"tree\": ");
+  WriteNodeToJSON(fp, cli->tree, cli->tree->Head, 1);
+  WriteAttributesToJSON(fp, cli->tree);
+  WriteDependenciesToJSON(fp, cli->tree);
+  fprintf(fp, "\n}\n");
+
+  METRIC_ADD(METRIC_JSON_BYTES_WRITTEN, (unsigned long long)ftell(fp));
+  fclose(fp);
+  METRIC_STOP(METRIC_OP_JSON_SAVE, timer);
+}
+
+void AutoSave(WorkflowCLI* cli) {
+  TRACE_BEGIN(span);
+  // 지연 로딩 트리는 바뀐 서브트리만 스냅숏에 덧붙인다 (JSON 은 트리 전체가 필요)
+  if (cli->tree->Pager != NULL) {
+    Write_Snapshot(cli->tree->Pager->Snapshot, cli->tree);
+  } else {
+    SaveTreeToJSON(cli);
+  }
+  TRACE_END(span, "AutoSave", "io");
+}
+
+// JSON 불러오기 관련 함수들
+static char* ReadFileContent(const char* filepath) {
+  FILE* fp = fopen(filepath, "r");
+  if (fp == NULL) {
+    return NULL;
+  }
+
+  fseek(fp, 0, SEEK_END);
+  long size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+
+  char* content = (char*)malloc(size + 1);
+  if (content == NULL) {
+    fclose(fp);
+    return NULL;
+  }
+
+  fread(content, 1, size, fp);
+  content[size] = '\0';
+  fclose(fp);
+
+  return content;
+}
+
+static char* SkipWhitespace(char* str) {
+  while (*str && (*str == ' ' || *str == '\t' || *str == '\n' || *str == '\r')) {
+    str++;
+  }
+  return str;
+}
+
+static char* ParseString(char* str, char* output, int maxLen) {
+  str = SkipWhitespace(str);
+  if (*str != '"') return NULL;
+  str++;
+
+  int i = 0;
+  while (*str && *str != '"' && i < maxLen - 1) {
+    // 이스케이프된 따옴표 처리
+    if (*str == '\\' && *(str + 1) == '"') {
+      output[i++] = '"';
+      str += 2;
+    } else {
+      output[i++] = *str++;
+    }
+  }
+  output[i] = '\0';
+
+  if (*str == '"') str++;
+  return str;
+}
+
+static char* ParseNumber(char* str, int* value) {
+  str = SkipWhitespace(str);
+  *value = 0;
+  while (*str >= '0' && *str <= '9') {
+    *value = (*value * 10) + (*str - '0');
+    str++;
+  }
+  return str;
+}
+
+static char* ParseNode(char* str, struct TreeNodeType** node, int childSize, struct LabelPoolType* labels, int depth);
+
+static char* ParseChildren(char* str, struct TreeNodeType* parent, int childSize, struct LabelPoolType* labels, int depth) {
+  str = SkipWhitespace(str);
+  if (*str != '[') return NULL;
+  str++;
+
+  // 최대 깊이 제한 (무한 재귀 방지)
+  if (depth > MAX_PARSE_DEPTH) {
+    printf("Error! Maximum parsing depth exceeded.\n");
+    return NULL;
   }
 
   for (int i = 0; i < childSize; i++) {
     str = SkipWhitespace(str);
+    if (*str == ']') break;  // 남은 슬롯은 비어 있음
+
+    // null 체크
+    if (strncmp(str, "null", 4) == 0) {
+      SetChild_N_Tree(parent, i, NULL);
+      str += 4;
+    } else {
+      struct TreeNodeType* child = NULL;
+      str = ParseNode(str, &child, childSize, labels, depth + 1);
+      if (child != NULL) {
+        child->Parent = parent;
+      }
+      if (!SetChild_N_Tree(parent, i, child)) return NULL;
+    }
+
+    str = SkipWhitespace(str);
+    if (*str == ',') str++;
+  }
+
+  str = SkipWhitespace(str);
+  if (*str == ']') str++;
+
+  return str;
+}
+
+static char* ParseNode(char* str, struct TreeNodeType** node, int childSize, struct LabelPoolType* labels, int depth) {
+  str = SkipWhitespace(str);
+
+  if (strncmp(str, "null", 4) == 0) {
+    *node = NULL;
+    return str + 4;
+  }
+
+  if (*str != '{') return NULL;
+  str++;
+
+  // 최대 깊이 제한 (무한 재귀 방지)
+  if (depth > MAX_PARSE_DEPTH) {
+    printf("Error! Maximum parsing depth exceeded.\n");
+    *node = NULL;
+    return NULL;
+  }
+
+  *node = (struct TreeNodeType*)calloc(1, sizeof(struct TreeNodeType));
+  if (*node == NULL) return NULL;
+
+  // 자식 블록은 첫 자식을 달 때 SetChild_N_Tree 가 만든다
+  METRIC_ADD(METRIC_NODES_ALLOCATED, 1);
+  METRIC_ADD(METRIC_NODE_BYTES, sizeof(struct TreeNodeType));
+
+  int iterations = 0;
+  while (*str && *str != '}') {
+    str = SkipWhitespace(str);
+
+    if (*str == '"') {
+      char key[64];
+      str = ParseString(str, key, sizeof(key));
+      if (str == NULL) break;  // 파싱 실패 시 중단
+
+      str = SkipWhitespace(str);
+
+      if (*str == ':') str++;
+      str = SkipWhitespace(str);
+
+      if (strcmp(key, "data") == 0) {
+        char data[LABEL_MAX_LENGTH + 1];
+        str = ParseString(str, data, sizeof(data));
+        if (str == NULL) break;  // 파싱 실패 시 중단
+        (*node)->Label = Intern_Label(labels, data);
+      } else if (strcmp(key, "children") == 0) {
+        str = ParseChildren(str, *node, childSize, labels, depth);
+        if (str == NULL) break;  // 파싱 실패 시 중단
+      }
+    }
+
+    str = SkipWhitespace(str);
+    if (*str == ',') str++;
+  }
+
+  if (*str == '}') str++;
+  return str;
+}
+
+static int CountNodes(struct TreeNodeType* node, int childSize) {
+  if (node == NULL) return 0;
+
+  int count = 1;
+  FOR_EACH_CHILD_SLOT(node, i) {
+    count += CountNodes(node->Children[i], childSize);
+  }
+  return count;
+}
+
+// 객체나 배열을 통째로 건너뛴다 (문자열 안의 괄호는 무시)
+static char* SkipValue(char* str) {
+  int nesting = 0;
+  str = SkipWhitespace(str);
+
+  do {
+    if (*str == '"') {
+      str++;
+      while (*str && *str != '"') {
+        if (*str == '\\' && *(str + 1)) str++;
+        str++;
+      }
+    } else if (*str == '{' || *str == '[') {
+      nesting++;
+    } else if (*str == '}' || *str == ']') {
+      nesting--;
+    } else if (nesting == 0 && (*str == ',' || *str == '\n')) {
+      return str;
+    }
+    if (*str) str++;
+  } while (*str && nesting > 0);
+
+  return str;
+}
+
+// "attributes": { "<name>": { "type": "...", "values": { "<전위 번호>": "<값>" } } }
+static char* ParseAttributes(char* str, struct N_TreeType* tree) {
+  struct EulerIndexType* index = Renumber_N_Tree(tree) ? tree->Euler : NULL;
+
+  str = SkipWhitespace(str);
+  if (*str != '{' || index == NULL) return NULL;
+  str++;
+
+  while (*str && *str != '}') {
+    char name[ATTR_NAME_SIZE];
+    enum AttributeKindType kind = ATTR_AUTO;
+
+    str = ParseString(str, name, sizeof(name));
+    if (str == NULL) return NULL;
+    str = SkipWhitespace(str);
+    if (*str == ':') str++;
+    str = SkipWhitespace(str);
+    if (*str != '{') return NULL;
+    str++;
+
+    while (*str && *str != '}') {
+      char key[64];
+      str = ParseString(str, key, sizeof(key));
+      if (str == NULL) return NULL;
+      str = SkipWhitespace(str);
+      if (*str == ':') str++;
+      str = SkipWhitespace(str);
+
+      if (strcmp(key, "type") == 0) {
+        char type[16];
+        str = ParseString(str, type, sizeof(type));
+        if (str == NULL) return NULL;
+        kind = ParseAttributeKind(type);
+      } else if (strcmp(key, "values") == 0 && *str == '{') {
+        str++;
+        while (*str && *str != '}') {
+          char entry[16];
+          char value[LABEL_MAX_LENGTH + 1];
+          str = ParseString(str, entry, sizeof(entry));
+          if (str == NULL) return NULL;
+          str = SkipWhitespace(str);
+          if (*str == ':') str++;
+          str = ParseString(str, value, sizeof(value));
+          if (str == NULL) return NULL;
+
+          int position = atoi(entry);
+          if (position >= 0 && position < index->Size) {
+            SetAttribute_N_Tree(tree, index->Order[position], name, kind, value);
+          }
+          str = SkipWhitespace(str);
+          if (*str == ',') str++;
+          str = SkipWhitespace(str);
+        }
+        if (*str == '}') str++;
+      } else {
+        str = SkipValue(str);
+      }
+
+      str = SkipWhitespace(str);
+      if (*str == ',') str++;
+      str = SkipWhitespace(str);
+    }
+    if (*str == '}') str++;
+
+    str = SkipWhitespace(str);
+    if (*str == ',') str++;
+    str = SkipWhitespace(str);
+  }
+
+  if (*str == '}') str++;
+  return str;
+}
+
+// "dependencies": { "<전위 번호>": [<전위 번호>, ...] }
+static char* ParseDependencies(char* str, struct N_TreeType* tree) {
+  struct EulerIndexType* index = Renumber_N_Tree(tree) ? tree->Euler : NULL;
+
+  str = SkipWhitespace(str);
+  if (*str != '{' || index == NULL) return NULL;
+  str++;
+
+  while (*str && *str != '}') {
+    char entry[16];
+    str = ParseString(str, entry, sizeof(entry));
+    if (str == NULL) return NULL;
+    str = SkipWhitespace(str);
+    if (*str == ':') str++;
+    str = SkipWhitespace(str);
+    if (*str != '[') return NULL;
+    str++;
+
+    int position = atoi(entry);
+    str = SkipWhitespace(str);
+    while (*str && *str != ']') {
+      int on = -1;
+      char* next = ParseNumber(str, &on);
+      if (next == str) return NULL;
+      str = next;
+      if (position >= 0 && position < index->Size && on >= 0 && on < index->Size) {
+        AddDependency_N_Tree(tree, index->Order[position], index->Order[on]);
+      }
+      str = SkipWhitespace(str);
+      if (*str == ',') str++;
+      str = SkipWhitespace(str);
+    }
+    if (*str == ']') str++;
+
+    str = SkipWhitespace(str);
+    if (*str == ',') str++;
+    str = SkipWhitespace(str);
+  }
+
+  if (*str == '}') str++;
+  return str;
+}
+
+// JSON 문자열에서 트리를 만든다 (source 는 경고 메시지용)
+static struct N_TreeType* ParseTreeJSON(char* content, const char* source) {
+  METRIC_START(timer);
+  METRIC_ADD(METRIC_JSON_BYTES_READ, strlen(content));
+  char* str = SkipWhitespace(content);
+  if (*str != '{') {
+    return NULL;
+  }
+  str++;
+
+  int childSize = 0;
+  int count = 0;
+  struct TreeNodeType* root = NULL;
+  char* attributes = NULL;
+  char* dependencies = NULL;
+  struct LabelPoolType* labels = Create_Label_Pool();
+  if (labels == NULL) {
+    return NULL;
+  }
+
+  while (*str && *str != '}') {
+    str = SkipWhitespace(str);
+
+    if (*str == '"') {
+      char key[64];
+      str = ParseString(str, key, sizeof(key));
+      str = SkipWhitespace(str);
+
+      if (*str == ':') str++;
+      str = SkipWhitespace(str);
+
+      if (strcmp(key, "childSize") == 0) {
+        str = ParseNumber(str, &childSize);
+      } else if (strcmp(key, "count") == 0) {
+        str = ParseNumber(str, &count);
+      } else if (strcmp(key, "tree") == 0) {
+        str = ParseNode(str, &root, childSize, labels, 0);
+      } else if (strcmp(key, "attributes") == 0) {
+        // 노드 번호가 정해진 뒤에 읽는다
+        attributes = str;
+        str = SkipValue(str);
+      } else if (strcmp(key, "dependencies") == 0) {
+        dependencies = str;
+        str = SkipValue(str);
+      } else {
+        // "hash" 와 "digest" 는 불러온 뒤 다시 계산한다
+        str = SkipValue(str);
+      }
+    }
+
+    if (str == NULL) break;
+    str = SkipWhitespace(str);
+    if (*str == ',') str++;
+  }
+
+  if (root == NULL || childSize <= 0 || childSize > CHILD_SIZE_MAX) {
+    Delete_Label_Pool(labels);
+    return NULL;
+  }
+
+  struct N_TreeType* tree = (struct N_TreeType*)calloc(1, sizeof(struct N_TreeType));
+  if (tree == NULL) {
+    Delete_Label_Pool(labels);
+    return NULL;
+  }
+  tree->Head = root;
+  tree->ChildSize = childSize;
+  tree->Count = CountNodes(root, childSize);
+  tree->Labels = labels;
+  RegisterNodes_N_Tree(tree, root);
+  Rehash_N_Tree(tree);
+
+  if (attributes != NULL && ParseAttributes(attributes, tree) == NULL) {
+    printf("Warning! Failed to parse attributes in %s\n", source);
+  }
+  if (dependencies != NULL && ParseDependencies(dependencies, tree) == NULL) {
+    printf("Warning! Failed to parse dependencies in %s\n", source);
+  }
+  METRIC_STOP(METRIC_OP_JSON_PARSE, timer);
+  return tree;
+}
+
+// 다른 JSON 파일의 트리를 따로 읽는다 (diff, merge 용)
+static struct N_TreeType* ReadTreeFile(const char* filepath) {
+  char* content = ReadFileContent(filepath);
+  if (content == NULL) {
+    printf("Error! Failed to open file: %s\n", filepath);
+    return NULL;
+  }
+
+  struct N_TreeType* tree = ParseTreeJSON(content, filepath);
+  free(content);
+  if (tree == NULL) {
+    printf("Error! %s is not a workflow tree file.\n", filepath);
+  }
+  return tree;
+}
+
+bool LoadTreeFromJSON(WorkflowCLI* cli) {
+  if (cli == NULL) return false;
+
+  char* content = ReadFileContent(cli->jsonFilePath);
+  if (content == NULL) {
+    // JSON 파일이 없으면 빈 트리 생성
+    printf("No existing workflow file found. Starting with empty tree.\n");
+    return false;
+  }
+
+  TRACE_BEGIN(span);
+  struct N_TreeType* tree = ParseTreeJSON(content, cli->jsonFilePath);
+  free(content);
+  TRACE_END(span, "LoadTreeFromJSON", "io");
+  if (tree == NULL) {
+    return false;
+  }
+
+  // 기존 트리 삭제
+  if (cli->tree != NULL) {
+    Delete_N_Tree(cli->tree);
+  }
+
+  // 새 트리 설정
+  cli->tree = tree;
+  cli->current = tree->Head;
+  UpdatePath(cli);
+
+  printf("Loaded workflow tree from %s (%d nodes)\n", cli->jsonFilePath, cli->tree->Count);
+  return true;
+}
+
+static void PrintDiffOp(WorkflowCLI* cli, struct N_TreeType* other, const struct DiffOpType* op) {
+  char before[DIFF_PATH_SIZE];
+  char after[DIFF_PATH_SIZE];
+
+  switch (op->Kind) {
+    case DIFF_INSERT:
+      FormatSlotPath(op->After, after, sizeof(after));
+      printf("  + %-12s %s\n", after, Data_N_Tree(other, op->After));
+      break;
+    case DIFF_DELETE:
+      FormatSlotPath(op->Before, before, sizeof(before));
+      printf("  - %-12s %s\n", before, Data_N_Tree(cli->tree, op->Before));
+      break;
+    case DIFF_EDIT:
+      FormatSlotPath(op->Before, before, sizeof(before));
+      printf("  ~ %-12s %s -> %s\n", before, Data_N_Tree(cli->tree, op->Before), Data_N_Tree(other, op->After));
+      break;
+    case DIFF_MOVE:
+      FormatSlotPath(op->Before, before, sizeof(before));
+      FormatSlotPath(op->After, after, sizeof(after));
+      printf("  > %-12s %s -> %s\n", before, Data_N_Tree(cli->tree, op->Before), after);
+      break;
+  }
+}
+
+// 현재 트리와 다른 파일의 트리 비교 (현재 트리가 이전, 파일이 새 트리)
+void DiffTree(WorkflowCLI* cli, const char* filepath) {
+  struct N_TreeType* other = ReadTreeFile(filepath);
+  if (other == NULL) return;
+  LoadWholeTree(cli);
+
+  // 루트 해시가 같으면 노드를 보지 않고 끝낸다
+  if (Equal_N_Tree(cli->tree, other)) {
+    printf("\nDiff against %s:\n  (identical)\n0 change(s), 0 node pair(s) compared\n\n", filepath);
+    Delete_N_Tree(other);
+    return;
+  }
 
-    // null 체크
-    if (strncmp(str, "null", 4) == 0) {
-      parent->Children[i] = NULL;
-      str += 4;
-    } else {
-      str = ParseNode(str, &parent->Children[i], childSize, depth + 1);
-      if (parent->Children[i] != NULL) {
-        parent->Children[i]->Parent = parent;
-      }
+  struct DiffListType diff = { NULL, 0, 0, 0 };
+  if (Diff_N_Tree(cli->tree, other, &diff)) {
+    printf("\nDiff against %s:\n", filepath);
+    for (long i = 0; i < diff.Size; i++) {
+      PrintDiffOp(cli, other, &diff.Items[i]);
+    }
+    if (diff.Size == 0) {
+      printf("  (identical)\n");
     }
+    printf("%ld change(s), %ld node pair(s) compared\n\n", diff.Size, diff.Compared);
+  }
 
-    str = SkipWhitespace(str);
-    if (*str == ',') str++;
+  FreeDiffList(&diff);
+  Delete_N_Tree(other);
+}
+
+// 3-way 병합: 현재 트리(ours)에 base 이후 theirs 의 변경을 합친다
+void MergeTree(WorkflowCLI* cli, const char* basePath, const char* theirPath) {
+  struct N_TreeType* base = ReadTreeFile(basePath);
+  struct N_TreeType* theirs = base == NULL ? NULL : ReadTreeFile(theirPath);
+  if (base == NULL || theirs == NULL) {
+    Delete_N_Tree(base);
+    return;
   }
 
-  str = SkipWhitespace(str);
-  if (*str == ']') str++;
+  struct MergeConflictListType conflicts;
+  LoadWholeTree(cli);
+  struct N_TreeType* merged = Merge_N_Tree(base, cli->tree, theirs, &conflicts);
+  Delete_N_Tree(base);
+  Delete_N_Tree(theirs);
+  if (merged == NULL) return;
 
-  return str;
+  Delete_N_Tree(cli->tree);
+  cli->tree = merged;
+  cli->current = merged->Head;
+  UpdatePath(cli);
+
+  printf("Merged %s into current tree (%d nodes)\n", theirPath, merged->Count);
+  if (conflicts.Total > 0) {
+    printf("%d conflict(s), ours kept:\n", conflicts.Total);
+    for (int i = 0; i < conflicts.Size; i++) {
+      printf("  %-12s %s\n", conflicts.Items[i].Path, conflicts.Items[i].Message);
+    }
+    if (conflicts.Total > conflicts.Size) {
+      printf("  ... and %d more\n", conflicts.Total - conflicts.Size);
+    }
+  }
+  AutoSave(cli);
 }
 
-static char* ParseNode(char* str, struct TreeNodeType** node, int childSize, int depth) {
-  str = SkipWhitespace(str);
+// JSON 파일 머리의 "hash" 와 "digest" 만 읽는다 (트리 전체를 파싱하지 않음, "digest" 가 없는 예전 파일은 0)
+static bool ReadSavedHash(const char* filepath, unsigned long long* hash, unsigned long long* digest) {
+  FILE* fp = fopen(filepath, "r");
+  if (fp == NULL) return false;
 
-  if (strncmp(str, "null", 4) == 0) {
-    *node = NULL;
-    return str + 4;
+  char head[256];
+  size_t length = fread(head, 1, sizeof(head) - 1, fp);
+  head[length] = '\0';
+  fclose(fp);
+
+  char* field = strstr(head, "\"digest\"");
+  *digest = 0;
+  if (field != NULL) sscanf(field, "\"digest\" : \"%llx\"", digest);
+
+  field = strstr(head, "\"hash\"");
+  return field != NULL && sscanf(field, "\"hash\" : \"%llx\"", hash) == 1;
+}
+
+// 이미 열린 스냅숏이 같은 파일이면 조각 색인을 다시 쓴다
+static struct SnapshotType* OpenCliSnapshot(WorkflowCLI* cli, const char* filepath) {
+  const char* path = filepath != NULL && filepath[0] != '\0' ? filepath : SNAPSHOT_FILE_PATH;
+  if (cli->snapshot != NULL && strcmp(cli->snapshot->Path, path) == 0) {
+    return cli->snapshot;
   }
 
-  if (*str != '{') return NULL;
-  str++;
+  struct SnapshotType* snapshot = Open_Snapshot(path);
+  if (snapshot == NULL) return NULL;
 
-  // 최대 깊이 제한 (무한 재귀 방지)
-  if (depth > MAX_PARSE_DEPTH) {
-    printf("Error! Maximum parsing depth exceeded.\n");
-    *node = NULL;
+  // 지연 로딩 트리가 쓰던 스냅숏을 닫기 전에 남은 노드를 모두 읽어 둔다
+  if (cli->tree->Pager != NULL && cli->tree->Pager->Snapshot == cli->snapshot && !Detach_Pager_N_Tree(cli->tree)) {
+    Close_Snapshot(snapshot);
     return NULL;
   }
+  Close_Snapshot(cli->snapshot);
+  cli->snapshot = snapshot;
+  return snapshot;
+}
 
-  *node = (struct TreeNodeType*)malloc(sizeof(struct TreeNodeType));
-  if (*node == NULL) return NULL;
+// 메모리의 트리가 저장된 파일과 같은지 루트 해시와 속성/간선 요약 값으로 확인
+void ShowSyncStatus(WorkflowCLI* cli) {
+  unsigned long long saved, digest;
+  Reclaim_N_Tree(cli->tree, 0);
+  printf("\nTree hash: %016llx (%d nodes)\n", cli->tree->Head->Hash, cli->tree->Count);
 
-  (*node)->Parent = NULL;
-  (*node)->Children = (struct TreeNodeType**)calloc(childSize, sizeof(struct TreeNodeType*));
-  memset((*node)->Data, 0, SIZE);  // 데이터 초기화
+  if (!ReadSavedHash(cli->jsonFilePath, &saved, &digest)) {
+    printf("  %-20s no hash recorded\n", cli->jsonFilePath);
+  } else {
+    bool same = saved == cli->tree->Head->Hash && digest == ContentDigest(cli->tree);
+    printf("  %-20s %s (%016llx)\n", cli->jsonFilePath, same ? "in sync" : "differs", saved);
+  }
 
-  int iterations = 0;
-  while (*str && *str != '}') {
-    str = SkipWhitespace(str);
+  const char* path = cli->snapshot != NULL ? cli->snapshot->Path : SNAPSHOT_FILE_PATH;
+  FILE* fp = fopen(path, "rb");
+  if (fp == NULL) {
+    printf("  %-20s not found\n\n", path);
+    return;
+  }
+  fclose(fp);
 
-    if (*str == '"') {
-      char key[64];
-      str = ParseString(str, key, sizeof(key));
-      if (str == NULL) break;  // 파싱 실패 시 중단
+  struct SnapshotType* snapshot = OpenCliSnapshot(cli, path);
+  if (snapshot == NULL || !snapshot->HasRoot) {
+    printf("  %-20s no saved tree\n\n", path);
+  } else {
+    printf("  %-20s %s (%016llx, %ld chunks)\n", path, Matches_Snapshot(snapshot, cli->tree) ? "in sync" : "differs",
+           snapshot->Root, snapshot->Count);
+  }
 
-      str = SkipWhitespace(str);
+  struct PagerType* pager = cli->tree->Pager;
+  if (pager != NULL) {
+    printf("  Paged from %s: %ld node(s) loaded (budget %ld), %ld fault(s), %ld eviction(s)\n",
+           pager->Snapshot->Path, pager->Resident, pager->Budget, pager->Faults, pager->Evictions);
+  }
+  printf("\n");
+}
 
-      if (*str == ':') str++;
-      str = SkipWhitespace(str);
+// 스냅숏에 바뀐 서브트리만 덧붙인다
+void SaveSnapshotFile(WorkflowCLI* cli, const char* filepath) {
+  struct SnapshotType* snapshot = OpenCliSnapshot(cli, filepath);
+  if (snapshot == NULL) return;
 
-      if (strcmp(key, "data") == 0) {
-        str = ParseString(str, (*node)->Data, SIZE);
-        if (str == NULL) break;  // 파싱 실패 시 중단
-      } else if (strcmp(key, "children") == 0) {
-        str = ParseChildren(str, *node, childSize, depth);
-        if (str == NULL) break;  // 파싱 실패 시 중단
-      }
-    }
+  if (Matches_Snapshot(snapshot, cli->tree)) {
+    printf("Snapshot %s is already up to date.\n", snapshot->Path);
+    return;
+  }
 
-    str = SkipWhitespace(str);
-    if (*str == ',') str++;
+  long written = Write_Snapshot(snapshot, cli->tree);
+  if (written >= 0) {
+    printf("Saved snapshot to %s (%ld of %d nodes written, %ld bytes)\n", snapshot->Path, written, cli->tree->Count, snapshot->Size);
   }
+}
 
-  if (*str == '}') str++;
-  return str;
+void LoadSnapshotFile(WorkflowCLI* cli, const char* filepath) {
+  struct SnapshotType* snapshot = OpenCliSnapshot(cli, filepath);
+  if (snapshot == NULL) return;
+
+  struct N_TreeType* tree = Read_Snapshot(snapshot);
+  if (tree == NULL) return;
+
+  Delete_N_Tree(cli->tree);
+  cli->tree = tree;
+  cli->current = tree->Head;
+  UpdatePath(cli);
+
+  printf("Loaded snapshot from %s (%d nodes)\n", snapshot->Path, tree->Count);
+  AutoSave(cli);
 }
 
-static int CountNodes(struct TreeNodeType* node, int childSize) {
-  if (node == NULL) return 0;
+// 압축 형식으로 저장 (레이블 사전 + 가변 길이 정수)
+void SavePackedFile(WorkflowCLI* cli, const char* filepath) {
+  const char* path = filepath != NULL && filepath[0] != '\0' ? filepath : PACK_FILE_PATH;
+  FILE* fp = fopen(path, "wb");
+  if (fp == NULL) {
+    printf("Error! Failed to open file for writing: %s\n", path);
+    return;
+  }
 
-  int count = 1;
-  for (int i = 0; i < childSize; i++) {
-    count += CountNodes(node->Children[i], childSize);
+  bool saved = Save_Packed_N_Tree(cli->tree, fp);
+  long bytes = ftell(fp);
+  fclose(fp);
+
+  if (saved) {
+    printf("Packed %d nodes to %s (%ld bytes)\n", cli->tree->Count, path, bytes);
+  } else {
+    printf("Error! Failed to save packed tree to %s\n", path);
   }
-  return count;
 }
 
-bool LoadTreeFromJSON(WorkflowCLI* cli) {
-  if (cli == NULL) return false;
-
-  char* content = ReadFileContent(cli->jsonFilePath);
-  if (content == NULL) {
-    // JSON 파일이 없으면 빈 트리 생성
-    printf("No existing workflow file found. Starting with empty tree.\n");
-    return false;
+void LoadPackedFile(WorkflowCLI* cli, const char* filepath) {
+  const char* path = filepath != NULL && filepath[0] != '\0' ? filepath : PACK_FILE_PATH;
+  FILE* fp = fopen(path, "rb");
+  if (fp == NULL) {
+    printf("Error! Failed to open file: %s\n", path);
+    return;
   }
 
-  char* str = content;
-  str = SkipWhitespace(str);
+  struct N_TreeType* tree = Load_Packed_N_Tree(fp);
+  fclose(fp);
+  if (tree == NULL) return;
 
-  if (*str != '{') {
-    free(content);
-    return false;
+  Delete_N_Tree(cli->tree);
+  cli->tree = tree;
+  cli->current = tree->Head;
+  UpdatePath(cli);
+
+  printf("Loaded packed tree from %s (%d nodes)\n", path, tree->Count);
+  AutoSave(cli);
+}
+
+// 스냅숏을 지연 로딩으로 연다: 처음 방문하는 노드의 자식만 파일에서 읽는다
+bool OpenPagedTree(WorkflowCLI* cli, const char* filepath) {
+  struct SnapshotType* snapshot = OpenCliSnapshot(cli, filepath);
+  if (snapshot == NULL) return false;
+
+  struct N_TreeType* tree = Open_Paged_N_Tree(snapshot, PAGER_DEFAULT_BUDGET);
+  if (tree == NULL) return false;
+
+  Delete_N_Tree(cli->tree);
+  cli->tree = tree;
+  cli->current = tree->Head;
+  UpdatePath(cli);
+  Fault_N_Tree(tree, tree->Head);
+
+  printf("Opened %s lazily (%d nodes, changes are saved to the snapshot)\n", snapshot->Path, tree->Count);
+  return true;
+}
+
+// 지난 저장본에만 쓰이던 조각을 버린다
+void CompactSnapshotFile(WorkflowCLI* cli, const char* filepath) {
+  struct SnapshotType* snapshot = OpenCliSnapshot(cli, filepath);
+  if (snapshot == NULL) return;
+
+  long before = snapshot->Size;
+  if (Compact_Snapshot(snapshot)) {
+    printf("Compacted %s (%ld -> %ld bytes, %ld chunks)\n", snapshot->Path, before, snapshot->Size, snapshot->Count);
   }
-  str++;
+}
 
-  int childSize = 0;
-  int count = 0;
-  struct TreeNodeType* root = NULL;
+// 일괄 가져오기: 한 줄에 "부모번호 슬롯 데이터" (0 번 줄은 루트, 부모번호 -1)
+void ImportTree(WorkflowCLI* cli, const char* filepath) {
+  char* content = ReadFileContent(filepath);
+  if (content == NULL) {
+    printf("Error! Failed to open file: %s\n", filepath);
+    return;
+  }
 
-  while (*str && *str != '}') {
-    str = SkipWhitespace(str);
+  int capacity = 1024;
+  int count = 0;
+  struct BuildRecordType* records = (struct BuildRecordType*)malloc(capacity * sizeof(struct BuildRecordType));
+  if (records == NULL) {
+    printf("Error! Failed to allocate import records.\n");
+    free(content);
+    return;
+  }
 
-    if (*str == '"') {
-      char key[64];
-      str = ParseString(str, key, sizeof(key));
-      str = SkipWhitespace(str);
+  int lineNumber = 0;
+  int malformed = 0;
+  char* line = content;
+  while (line != NULL && *line) {
+    char* next = strchr(line, '\n');
+    if (next != NULL) *next++ = '\0';
+    lineNumber++;
+
+    line[strcspn(line, "\r")] = '\0';
+    char* p = SkipWhitespace(line);
+    if (*p == '\0' || *p == '#') {
+      line = next;
+      continue;
+    }
 
-      if (*str == ':') str++;
-      str = SkipWhitespace(str);
+    char* end = NULL;
+    long parent = strtol(p, &end, 10);
+    char* slotStart = end;
+    long slot = strtol(slotStart, &end, 10);
+    if (end == slotStart || (*end != ' ' && *end != '\t')) {
+      if (malformed++ < 10) printf("  line %d: expected '<parent> <slot> <data>'\n", lineNumber);
+      line = next;
+      continue;
+    }
 
-      if (strcmp(key, "childSize") == 0) {
-        str = ParseNumber(str, &childSize);
-      } else if (strcmp(key, "count") == 0) {
-        str = ParseNumber(str, &count);
-      } else if (strcmp(key, "tree") == 0) {
-        str = ParseNode(str, &root, childSize, 0);
+    if (count == capacity) {
+      capacity *= 2;
+      struct BuildRecordType* grown = (struct BuildRecordType*)realloc(records, capacity * sizeof(struct BuildRecordType));
+      if (grown == NULL) {
+        printf("Error! Failed to allocate import records.\n");
+        free(records);
+        free(content);
+        return;
       }
+      records = grown;
     }
-
-    str = SkipWhitespace(str);
-    if (*str == ',') str++;
+    records[count].Parent = (int)parent;
+    records[count].Slot = (int)slot;
+    records[count].Data = SkipWhitespace(end);
+    count++;
+    line = next;
   }
 
-  free(content);
+  if (malformed > 0) {
+    printf("Error! %d malformed line(s) in %s. Nothing imported.\n", malformed, filepath);
+    free(records);
+    free(content);
+    return;
+  }
 
-  if (root != NULL && childSize > 0) {
-    // 기존 트리 삭제
-    if (cli->tree != NULL) {
-      Delete_N_Tree(cli->tree);
-    }
+  // 지금 ChildSize 보다 넓은 노드가 있으면 그 폭으로 넓힌다 (자식 블록은 쓰는 만큼만 잡힘)
+  int childSize = cli->tree->ChildSize;
+  for (int i = 1; i < count; i++) {
+    if (records[i].Slot >= childSize && records[i].Slot < CHILD_SIZE_MAX) childSize = records[i].Slot + 1;
+  }
+  if (childSize > cli->tree->ChildSize) {
+    printf("Widening ChildSize from %d to %d for %s\n", cli->tree->ChildSize, childSize, filepath);
+  }
 
-    // 새 트리 설정
-    cli->tree = (struct N_TreeType*)malloc(sizeof(struct N_TreeType));
-    cli->tree->Head = root;
-    cli->tree->ChildSize = childSize;
-    cli->tree->Count = CountNodes(root, childSize);
+  struct BuildErrorListType errors;
+  struct N_TreeType* tree = Build_N_Tree(childSize, records, count, &errors);
+  free(records);
+  free(content);
 
-    cli->current = root;
-    UpdatePath(cli);
+  // JSON 로 자동 저장한 뒤 다시 읽을 수 있는 깊이까지만 받는다
+  struct TreeReportType report;
+  if (tree != NULL && Report_N_Tree(tree, &report) && report.MaxDepth > MAX_PARSE_DEPTH) {
+    printf("Error! %s is %d levels deep; at most %d levels can be saved. Nothing imported.\n", filepath, report.MaxDepth, MAX_PARSE_DEPTH);
+    Delete_N_Tree(tree);
+    return;
+  }
 
-    printf("Loaded workflow tree from %s (%d nodes)\n", cli->jsonFilePath, cli->tree->Count);
-    return true;
+  if (tree == NULL) {
+    printf("Error! Import failed with %d error(s):\n", errors.Total);
+    for (int i = 0; i < errors.Size; i++) {
+      if (errors.Items[i].Record >= 0) {
+        printf("  record %d: %s\n", errors.Items[i].Record, errors.Items[i].Message);
+      } else {
+        printf("  %s\n", errors.Items[i].Message);
+      }
+    }
+    if (errors.Total > errors.Size) {
+      printf("  ... and %d more\n", errors.Total - errors.Size);
+    }
+    return;
   }
 
-  return false;
+  Delete_N_Tree(cli->tree);
+  cli->tree = tree;
+  cli->current = tree->Head;
+  UpdatePath(cli);
+  printf("Imported %d nodes from %s\n", tree->Count, filepath);
+  AutoSave(cli);
 }
 
 // 큰따옴표를 고려한 명령어 파싱 함수
@@ -650,7 +2103,7 @@ static int ParseCommand(const char* command, char* cmd, char* arg1, char* arg2)
 
   // 1. 명령어 파싱
   int i = 0;
-  while (*p && *p != ' ' && *p != '\t' && i < SIZE - 1) {
+  while (*p && *p != ' ' && *p != '\t' && i < MAX_CMD_NAME_LEN - 1) {
     cmd[i++] = *p++;
   }
   cmd[i] = '\0';
@@ -706,14 +2159,24 @@ static int ParseCommand(const char* command, char* cmd, char* arg1, char* arg2)
 // 문자열 길이 검증 함수
 static bool ValidateStringLength(const char* str, const char* fieldName) {
   size_t len = strlen(str);
-  if (len >= SIZE) {
+  if (len > LABEL_MAX_LENGTH) {
     printf("Error! %s is too long (max %d characters, got %zu).\n",
-           fieldName, SIZE - 1, len);
+           fieldName, LABEL_MAX_LENGTH, len);
     return false;
   }
   return true;
 }
 
+// 표준 입력에 읽을 것이 있으면 true (확인할 수 없는 환경에서는 항상 true)
+static bool InputPending(void) {
+#ifdef _WIN32
+  return true;
+#else
+  struct pollfd input = { STDIN_FILENO, POLLIN, 0 };
+  return poll(&input, 1, 0) != 0;
+#endif
+}
+
 void RunWorkflowCLI(WorkflowCLI* cli) {
   if (cli == NULL) {
     printf("Error! CLI not initialized.\n");
@@ -729,8 +2192,21 @@ void RunWorkflowCLI(WorkflowCLI* cli) {
   printf("=======================================\n");
 
   while (1) {
+    // 지연 로딩 트리: 명령 사이에만 페이지를 내보낸다 (이때는 현재 노드 외의 포인터를 들고 있지 않음)
+    if (cli->tree->Pager != NULL) {
+      Fault_N_Tree(cli->tree, cli->current);
+      Evict_N_Tree(cli->tree, cli->current);
+    }
     ShowCurrentPath(cli);
     printf("> ");
+    fflush(stdout);
+
+    // 떼어 낸 서브트리는 프롬프트를 띄운 뒤 입력이 없는 동안에만 조금씩 해제한다
+    if (cli->tree->Garbage.Size > 0) {
+      TRACE_BEGIN(reclaimSpan);
+      while (cli->tree->Garbage.Size > 0 && !InputPending()) Reclaim_N_Tree(cli->tree, RECLAIM_BATCH);
+      TRACE_END(reclaimSpan, "reclaim", "tree");
+    }
 
     if (fgets(command, MAX_COMMAND_LEN, stdin) == NULL) {
       break;
@@ -745,17 +2221,22 @@ void RunWorkflowCLI(WorkflowCLI* cli) {
     }
 
     // 명령어 파싱
-    char cmd[SIZE] = {0};
+    char cmd[MAX_CMD_NAME_LEN] = {0};
     arg1[0] = '\0';
     arg2[0] = '\0';
 
+    TRACE_BEGIN(parseSpan);
     int parsed = ParseCommand(command, cmd, arg1, arg2);
+    TRACE_END(parseSpan, "parse", "cli");
 
     // 디버깅 출력
     printf("[DEBUG] parsed=%d, cmd='%s', arg1='%s', arg2='%s'\n",
            parsed, cmd, arg1, arg2);
 
-    // 명령어 처리
+    // 명령어 처리 (알 수 없는 명령은 계측하지 않음)
+    METRIC_START(timer);
+    TRACE_BEGIN(dispatchSpan);
+    bool known = true;
     if (strcmp(cmd, "exit") == 0 || strcmp(cmd, "quit") == 0) {
       printf("Exiting...\n");
       break;
@@ -770,21 +2251,210 @@ void RunWorkflowCLI(WorkflowCLI* cli) {
       ShowCurrentPath(cli);
     }
     else if (strcmp(cmd, "ls") == 0) {
-      ListChildren(cli);
+      if (parsed < 2) {
+        ListChildren(cli);
+      } else if (atoi(arg1) < 0 || (parsed >= 3 && atoi(arg2) < 1)) {
+        printf("Usage: ls [from] [count]\n");
+      } else {
+        ListChildrenPage(cli, atoi(arg1), parsed >= 3 ? atoi(arg2) : LIST_PAGE_SIZE);
+      }
     }
     else if (strcmp(cmd, "tree") == 0) {
       ShowFullTree(cli);
     }
     else if (strcmp(cmd, "view") == 0) {
-      int maxLen = FindMaxDataLength(cli->tree->Head, cli->tree->ChildSize);
+      LoadWholeTree(cli);
+      int maxLen = FindMaxDataLength(cli->tree, cli->tree->Head);
       int width = maxLen + 1; // 여백을 위해 1 추가
+      TRACE_BEGIN(span);
       printf("\n");
       TreeView(cli->tree, width);
       printf("\n");
+      TRACE_END(span, "view", "render");
     }
     else if (strcmp(cmd, "info") == 0) {
       ShowCurrentNode(cli);
     }
+    else if (strcmp(cmd, "stat") == 0) {
+      ShowTreeStats(cli);
+    }
+    else if (strcmp(cmd, "trace") == 0) {
+      if (parsed >= 2 && strcmp(arg1, "on") == 0) {
+        StartTrace(parsed >= 3 ? arg2 : NULL);
+      } else if (parsed >= 2 && strcmp(arg1, "off") == 0) {
+        StopTrace();
+      } else {
+        printf("Usage: trace on [file] | trace off\n");
+      }
+    }
+    else if (strcmp(cmd, "mem") == 0) {
+      ShowMemoryReport(cli);
+    }
+    else if (strcmp(cmd, "stats") == 0) {
+      ShowMetrics(cli, parsed >= 2 ? arg1 : NULL, parsed >= 3 ? arg2 : NULL);
+    }
+    else if (strcmp(cmd, "find") == 0) {
+      if (parsed < 2) {
+        printf("Usage: find <text>\n");
+      } else {
+        FindNodes(cli, arg1);
+      }
+    }
+    else if (strcmp(cmd, "query") == 0) {
+      if (parsed < 2) {
+        printf("Usage: query <path>\n");
+        printf("  Example: query /Root/*/Build//test*[depth<4]\n");
+        printf("  Steps: name, glob (* ?), . or ..; '//' searches all descendants\n");
+        printf("  Predicates: [depth<4] [size>=10] [children=0] [pos=2] [@status=failed]\n");
+      } else {
+        // 이름에 공백이 있는 경로도 그대로 이어 붙인다
+        char text[MAX_COMMAND_LEN * 2];
+        snprintf(text, sizeof(text), parsed >= 3 ? "%s %s" : "%s", arg1, arg2);
+        RunQuery(cli, text);
+      }
+    }
+    else if (strcmp(cmd, "lca") == 0) {
+      if (parsed < 3) {
+        printf("Usage: lca <path> <path>\n");
+        printf("  Path: /0/2 (from root), 1/0 or ../3 (from current)\n");
+      } else {
+        ShowCommonAncestor(cli, arg1, arg2);
+      }
+    }
+    else if (strcmp(cmd, "mv") == 0) {
+      if (parsed < 3) {
+        printf("Usage: mv <path> <parent>/<pos>\n");
+        printf("  Example: mv 0/1 /2/0  (move child 1 of child 0 to slot 0 of /2)\n");
+      } else {
+        MoveSubtree(cli, arg1, arg2);
+      }
+    }
+    else if (strcmp(cmd, "cp") == 0) {
+      if (parsed < 3) {
+        printf("Usage: cp <path> <parent>/<pos>\n");
+        printf("  Example: cp 0 /1/3  (copy child 0 and its subtree to slot 3 of /1)\n");
+      } else {
+        CopySubtree(cli, arg1, arg2);
+      }
+    }
+    else if (strcmp(cmd, "critical") == 0) {
+      ShowCriticalPath(cli, parsed >= 2 ? arg1 : NULL);
+    }
+    else if (strcmp(cmd, "dep") == 0 || strcmp(cmd, "undep") == 0) {
+      if (parsed < 3) {
+        printf("Usage: %s <path> <path>\n", cmd);
+        printf("  Example: dep /1/0 /0/2  (/1/0 starts only after /0/2 has finished)\n");
+      } else {
+        LinkDependency(cli, arg1, arg2, strcmp(cmd, "dep") == 0);
+      }
+    }
+    else if (strcmp(cmd, "deps") == 0) {
+      ShowDependencies(cli, parsed >= 2 ? arg1 : NULL);
+    }
+    else if (strcmp(cmd, "order") == 0) {
+      if (parsed >= 3 && atoi(arg2) < 1) {
+        printf("Usage: order [path] [count]\n");
+      } else {
+        ShowTopologicalOrder(cli, parsed >= 2 ? arg1 : NULL, parsed >= 3 ? atoi(arg2) : LIST_PAGE_SIZE);
+      }
+    }
+    else if (strcmp(cmd, "ready") == 0) {
+      ShowReadyTasks(cli, parsed >= 2 ? arg1 : NULL);
+    }
+    else if (strcmp(cmd, "run") == 0) {
+      RunTasks(cli, parsed >= 2 ? arg1 : NULL, parsed >= 3 ? arg2 : NULL);
+    }
+    else if (strcmp(cmd, "diff") == 0) {
+      if (parsed < 2) {
+        printf("Usage: diff <file>\n");
+        printf("  + insert, - delete, ~ edit, > move (slot paths)\n");
+      } else {
+        DiffTree(cli, arg1);
+      }
+    }
+    else if (strcmp(cmd, "merge") == 0) {
+      if (parsed < 3) {
+        printf("Usage: merge <base file> <their file>\n");
+        printf("  Applies changes made in <their file> since <base file> to the current tree\n");
+      } else {
+        MergeTree(cli, arg1, arg2);
+      }
+    }
+    else if (strcmp(cmd, "import") == 0) {
+      if (parsed < 2) {
+        printf("Usage: import <file>\n");
+        printf("  Each line: <parent record> <slot> <data> (first line: -1 0 Root)\n");
+      } else {
+        ImportTree(cli, arg1);
+      }
+    }
+    else if (strcmp(cmd, "set") == 0) {
+      if (parsed < 3) {
+        printf("Usage: set <key>[:type] <value>\n");
+        printf("  Types: int, float, string, time (YYYY-MM-DD[THH:MM:SS] or @epoch)\n");
+      } else {
+        SetAttribute(cli, arg1, arg2);
+      }
+    }
+    else if (strcmp(cmd, "get") == 0) {
+      ShowAttributes(cli, parsed >= 2 ? arg1 : NULL);
+    }
+    else if (strcmp(cmd, "unset") == 0) {
+      if (parsed < 2) {
+        printf("Usage: unset <key>\n");
+      } else {
+        UnsetAttribute(cli, arg1);
+      }
+    }
+    else if (strcmp(cmd, "where") == 0) {
+      if (parsed < 2) {
+        printf("Usage: where <key><op><value>\n");
+        printf("  Ops: = != < <= > >=  (e.g. where status=failed, where due < 2024-06-01)\n");
+      } else {
+        // "cost >= 10" 처럼 띄어 쓴 식도 하나로 합친다
+        char expression[MAX_COMMAND_LEN * 2];
+        snprintf(expression, sizeof(expression), "%s%s", arg1, arg2);
+        FindWhere(cli, expression);
+      }
+    }
+    else if (strcmp(cmd, "attrs") == 0) {
+      if (parsed < 2) {
+        ListAttributeColumns(cli);
+      } else if (parsed >= 3 && strcmp(arg1, "save") == 0) {
+        SaveAttributeFile(cli, arg2);
+      } else if (parsed >= 3 && strcmp(arg1, "load") == 0) {
+        LoadAttributeFile(cli, arg2);
+      } else {
+        printf("Usage: attrs [save|load <file>]\n");
+      }
+    }
+    else if (strcmp(cmd, "status") == 0) {
+      ShowSyncStatus(cli);
+    }
+    else if (strcmp(cmd, "pack") == 0) {
+      const char* path = parsed >= 3 ? arg2 : NULL;
+      if (parsed >= 2 && strcmp(arg1, "save") == 0) {
+        SavePackedFile(cli, path);
+      } else if (parsed >= 2 && strcmp(arg1, "load") == 0) {
+        LoadPackedFile(cli, path);
+      } else {
+        printf("Usage: pack save|load [file]\n");
+      }
+    }
+    else if (strcmp(cmd, "snapshot") == 0) {
+      const char* path = parsed >= 3 ? arg2 : NULL;
+      if (parsed >= 2 && strcmp(arg1, "open") == 0) {
+        OpenPagedTree(cli, path);
+      } else if (parsed >= 2 && strcmp(arg1, "save") == 0) {
+        SaveSnapshotFile(cli, path);
+      } else if (parsed >= 2 && strcmp(arg1, "load") == 0) {
+        LoadSnapshotFile(cli, path);
+      } else if (parsed >= 2 && strcmp(arg1, "compact") == 0) {
+        CompactSnapshotFile(cli, path);
+      } else {
+        printf("Usage: snapshot open|save|load|compact [file]\n");
+      }
+    }
     else if (strcmp(cmd, "cd") == 0) {
       if (parsed < 2) {
         printf("Usage: cd <index|..|/>\n");
@@ -834,8 +2504,11 @@ void RunWorkflowCLI(WorkflowCLI* cli) {
       }
     }
     else {
+      known = false;
       printf("Unknown command: %s\n", cmd);
       printf("Type 'help' for available commands.\n");
     }
+    if (known) METRIC_STOP_NAMED(cmd, timer);
+    TRACE_END(dispatchSpan, cmd, "command");
   }
 }
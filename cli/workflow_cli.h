@@ -2,24 +2,33 @@
 #define _WORKFLOW_CLI_H_
 
 #include "../lib/n_tree.h"
+#include "../lib/snapshot.h"
 
 #define MAX_PATH_DEPTH 1024
 #define MAX_COMMAND_LEN 256
+#define MAX_CMD_NAME_LEN 32
 #define JSON_FILE_PATH "workflow_tree.json"
-#define MAX_PARSE_DEPTH 100
+#define SNAPSHOT_FILE_PATH "workflow_tree.snap"
+#define PACK_FILE_PATH "workflow_tree.pack"
+#define TRACE_FILE_PATH "workflow_trace.json"
+#define MAX_PARSE_DEPTH 2048  // JSON 로 저장하고 다시 읽을 수 있는 트리 깊이 (import 도 이 깊이까지만 받는다)
 #define MAX_PARSE_ITERATIONS 1000
+#define LIST_PAGE_SIZE 50
+#define RECLAIM_BATCH 16384  // 입력을 기다리는 동안 한 번에 해제하는 떼어 낸 노드 수
 
 // CLI 상태를 관리하는 구조체
 typedef struct {
   struct N_TreeType* tree;
   struct TreeNodeType* current;  // 현재 위치 노드
-  char path[MAX_PATH_DEPTH][SIZE];  // 현재 경로
+  LabelType path[MAX_PATH_DEPTH];  // 현재 경로 (레이블 핸들)
   int pathDepth;  // 경로 깊이
   char jsonFilePath[256];  // JSON 파일 경로
+  struct SnapshotType* snapshot;  // 마지막으로 쓴 스냅숏 (조각 색인 보관)
 } WorkflowCLI;
 
 // CLI 초기화 및 종료
 WorkflowCLI* InitWorkflowCLI(int childSize);
+WorkflowCLI* InitPagedWorkflowCLI(const char* snapshotPath);
 void CleanupWorkflowCLI(WorkflowCLI* cli);
 
 // CLI 메인 루프
@@ -36,15 +45,51 @@ void InsertNode(WorkflowCLI* cli, const char* data, int position);
 void InsertParent(WorkflowCLI* cli, const char* data);
 void RemoveNode(WorkflowCLI* cli, bool clearAll);
 void ListChildren(WorkflowCLI* cli);
+void ListChildrenPage(WorkflowCLI* cli, int from, int count);
 void EditCurrentNode(WorkflowCLI* cli, const char* newData);
+void MoveSubtree(WorkflowCLI* cli, const char* source, const char* destination);
+void CopySubtree(WorkflowCLI* cli, const char* source, const char* destination);
+void RunTasks(WorkflowCLI* cli, const char* first, const char* rest);
+void ShowCriticalPath(WorkflowCLI* cli, const char* path);
+void LinkDependency(WorkflowCLI* cli, const char* path, const char* target, bool add);
+void ShowDependencies(WorkflowCLI* cli, const char* path);
+void ShowTopologicalOrder(WorkflowCLI* cli, const char* path, int count);
+void ShowReadyTasks(WorkflowCLI* cli, const char* path);
+void ShowTreeStats(WorkflowCLI* cli);
+void ShowMemoryReport(WorkflowCLI* cli);
+bool StartTrace(const char* filepath);
+void StopTrace(void);
+void ShowMetrics(WorkflowCLI* cli, const char* action, const char* filepath);
+void FindNodes(WorkflowCLI* cli, const char* text);
+void ShowCommonAncestor(WorkflowCLI* cli, const char* first, const char* second);
+void SetAttribute(WorkflowCLI* cli, const char* spec, const char* value);
+void ShowAttributes(WorkflowCLI* cli, const char* name);
+void UnsetAttribute(WorkflowCLI* cli, const char* name);
+void FindWhere(WorkflowCLI* cli, const char* expression);
+void RunQuery(WorkflowCLI* cli, const char* text);
+void ListAttributeColumns(WorkflowCLI* cli);
+void SaveAttributeFile(WorkflowCLI* cli, const char* filepath);
+void LoadAttributeFile(WorkflowCLI* cli, const char* filepath);
 
 // 유틸리티 함수
 void UpdatePath(WorkflowCLI* cli);
+void PrintNodePath(struct N_TreeType* tree, struct TreeNodeType* node);
+struct TreeNodeType* ResolveNodePath(WorkflowCLI* cli, const char* path);
 int GetChildIndex(struct TreeNodeType* parent, struct TreeNodeType* child, int childSize);
 
 // JSON 저장/불러오기 함수
 void SaveTreeToJSON(WorkflowCLI* cli);
 bool LoadTreeFromJSON(WorkflowCLI* cli);
 void AutoSave(WorkflowCLI* cli);
+void ImportTree(WorkflowCLI* cli, const char* filepath);
+void DiffTree(WorkflowCLI* cli, const char* filepath);
+void MergeTree(WorkflowCLI* cli, const char* basePath, const char* theirPath);
+void ShowSyncStatus(WorkflowCLI* cli);
+void SaveSnapshotFile(WorkflowCLI* cli, const char* filepath);
+void LoadSnapshotFile(WorkflowCLI* cli, const char* filepath);
+void CompactSnapshotFile(WorkflowCLI* cli, const char* filepath);
+bool OpenPagedTree(WorkflowCLI* cli, const char* filepath);
+void SavePackedFile(WorkflowCLI* cli, const char* filepath);
+void LoadPackedFile(WorkflowCLI* cli, const char* filepath);
 
 #endif
@@ -0,0 +1,730 @@
+#include "attr.h"
+#include "deps.h"
+#include "euler.h"
+#include "rollup.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ATTR_MAGIC "WTAT"
+#define ATTR_VERSION 1
+
+struct AttributeTableType* Create_Attribute_Table (void) {
+
+  struct AttributeTableType* table = (struct AttributeTableType*) calloc (1, sizeof (struct AttributeTableType));
+  if (table == NULL) printf ("Error! The dynamic memory allocation failed. Create_Attribute_Table()\n");
+  return table;
+}
+
+void Delete_Attribute_Table (struct AttributeTableType* table) {
+
+  if (table == NULL) return;
+
+  for (int index = 0; index < table->Count; index++) {
+
+    free (table->Columns[index].Present);
+    free (table->Columns[index].Values.Ints);
+  }
+  free (table->Columns);
+  free (table);
+}
+
+struct AttributeColumnType* FindAttributeColumn (struct AttributeTableType* table, const char* name) {
+
+  if (table == NULL || name == NULL) return NULL;
+
+  for (int index = 0; index < table->Count; index++) {
+
+    if (strcmp (table->Columns[index].Name, name) == 0) return &table->Columns[index];
+  }
+  return NULL;
+}
+
+const char* AttributeKindName (enum AttributeKindType kind) {
+
+  switch (kind) {
+
+    case ATTR_INT: return "int";
+    case ATTR_FLOAT: return "float";
+    case ATTR_STRING: return "string";
+    case ATTR_TIMESTAMP: return "time";
+    default: return "auto";
+  }
+}
+
+enum AttributeKindType ParseAttributeKind (const char* name) {
+
+  if (name == NULL) return ATTR_AUTO;
+  if (strcmp (name, "int") == 0) return ATTR_INT;
+  if (strcmp (name, "float") == 0) return ATTR_FLOAT;
+  if (strcmp (name, "string") == 0) return ATTR_STRING;
+  if (strcmp (name, "time") == 0) return ATTR_TIMESTAMP;
+  return ATTR_AUTO;
+}
+
+// 그레고리력 날짜 <-> 1970-01-01 기준 일 수
+static long long DaysFromCivil (long long year, int month, int day) {
+
+  year -= month <= 2;
+  long long era = (year >= 0 ? year : year - 399) / 400;
+  long long yearOfEra = year - era * 400;
+  long long dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  long long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  return era * 146097 + dayOfEra - 719468;
+}
+
+static void CivilFromDays (long long days, long long* year, int* month, int* day) {
+
+  days += 719468;
+  long long era = (days >= 0 ? days : days - 146096) / 146097;
+  long long dayOfEra = days - era * 146097;
+  long long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+  long long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  long long monthPart = (5 * dayOfYear + 2) / 153;
+
+  *day = (int) (dayOfYear - (153 * monthPart + 2) / 5 + 1);
+  *month = (int) (monthPart < 10 ? monthPart + 3 : monthPart - 9);
+  *year = yearOfEra + era * 400 + (*month <= 2);
+}
+
+// "@1700000000", "2024-03-01", "2024-03-01T12:30", "2024-03-01T12:30:05Z" (UTC)
+static bool ParseTimestamp (const char* text, long long* value) {
+
+  if (text[0] == '@') {
+
+    char* end = NULL;
+    *value = strtoll (text + 1, &end, 10);
+    return end != text + 1 && *end == '\0';
+  }
+
+  int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+  int consumed = 0;
+  if (sscanf (text, "%4d-%2d-%2d%n", &year, &month, &day, &consumed) != 3 || consumed != 10) return false;
+
+  const char* rest = text + consumed;
+  if (*rest == 'T' || *rest == ' ') {
+
+    int timeConsumed = 0;
+    if (sscanf (rest + 1, "%2d:%2d%n", &hour, &minute, &timeConsumed) != 2) return false;
+    rest += 1 + timeConsumed;
+    if (*rest == ':') {
+
+      if (sscanf (rest + 1, "%2d%n", &second, &timeConsumed) != 1) return false;
+      rest += 1 + timeConsumed;
+    }
+  }
+  if (*rest == 'Z') rest++;
+  if (*rest != '\0') return false;
+  if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) return false;
+
+  *value = DaysFromCivil (year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+  return true;
+}
+
+static void FormatTimestamp (long long value, char* out, int outSize) {
+
+  long long days = value >= 0 ? value / 86400 : -((-value + 86399) / 86400);
+  long long seconds = value - days * 86400;
+  long long year;
+  int month, day;
+
+  CivilFromDays (days, &year, &month, &day);
+  snprintf (out, outSize, "%04lld-%02d-%02dT%02lld:%02lld:%02lldZ",
+    year, month, day, seconds / 3600, (seconds / 60) % 60, seconds % 60);
+}
+
+static bool ParseInt (const char* text, long long* value) {
+
+  char* end = NULL;
+  *value = strtoll (text, &end, 10);
+  return end != text && *end == '\0';
+}
+
+static bool ParseFloat (const char* text, double* value) {
+
+  char* end = NULL;
+  *value = strtod (text, &end);
+  return end != text && *end == '\0';
+}
+
+static enum AttributeKindType InferKind (const char* text) {
+
+  long long integer;
+  double real;
+
+  if (ParseInt (text, &integer)) return ATTR_INT;
+  if (ParseFloat (text, &real)) return ATTR_FLOAT;
+  if (ParseTimestamp (text, &integer)) return ATTR_TIMESTAMP;
+  return ATTR_STRING;
+}
+
+static size_t ValueSize (enum AttributeKindType kind) {
+
+  switch (kind) {
+
+    case ATTR_FLOAT: return sizeof (double);
+    case ATTR_STRING: return sizeof (LabelType);
+    default: return sizeof (long long);
+  }
+}
+
+static bool EnsureColumnCapacity (struct AttributeColumnType* column, int id) {
+
+  if (id < column->Capacity) return true;
+
+  int capacity = column->Capacity == 0 ? 256 : column->Capacity;
+  while (capacity <= id) capacity *= 2;
+
+  unsigned long long* present = (unsigned long long*) realloc (column->Present, (capacity / 64) * sizeof (unsigned long long));
+  if (present == NULL) return false;
+  memset (present + column->Capacity / 64, 0, ((capacity - column->Capacity) / 64) * sizeof (unsigned long long));
+  column->Present = present;
+
+  void* values = realloc (column->Values.Ints, capacity * ValueSize (column->Kind));
+  if (values == NULL) return false;
+  column->Values.Ints = (long long*) values;
+
+  column->Capacity = capacity;
+  return true;
+}
+
+static struct AttributeColumnType* AddAttributeColumn (struct N_TreeType* tree, const char* name, enum AttributeKindType kind) {
+
+  if (tree->Attributes == NULL) {
+
+    tree->Attributes = Create_Attribute_Table ();
+    if (tree->Attributes == NULL) return NULL;
+  }
+
+  struct AttributeTableType* table = tree->Attributes;
+  if (table->Count == table->Capacity) {
+
+    int capacity = table->Capacity == 0 ? 8 : table->Capacity * 2;
+    struct AttributeColumnType* columns = (struct AttributeColumnType*) realloc (table->Columns, capacity * sizeof (struct AttributeColumnType));
+    if (columns == NULL) return NULL;
+
+    table->Columns = columns;
+    table->Capacity = capacity;
+  }
+
+  struct AttributeColumnType* column = &table->Columns[table->Count++];
+  memset (column, 0, sizeof (struct AttributeColumnType));
+  strncpy (column->Name, name, ATTR_NAME_SIZE - 1);
+  column->Kind = kind;
+  return column;
+}
+
+bool HasAttributeValue (struct AttributeColumnType* column, int id) {
+
+  if (column == NULL || id < 0 || id >= column->Capacity) return false;
+  return (column->Present[id / 64] >> (id % 64)) & 1ULL;
+}
+
+static void MarkPresent (struct AttributeColumnType* column, int id) {
+
+  if (!HasAttributeValue (column, id)) column->Size++;
+  column->Present[id / 64] |= 1ULL << (id % 64);
+}
+
+static void ClearPresent (struct AttributeColumnType* column, int id) {
+
+  if (!HasAttributeValue (column, id)) return;
+  column->Size--;
+  column->Present[id / 64] &= ~(1ULL << (id % 64));
+}
+
+// 떼어 낸 노드의 값은 해제할 때 지워지므로, 값을 모두 훑기 전에 남은 노드를 해제한다
+static void SettleAttributes (struct N_TreeType* tree) {
+
+  if (tree->Attributes != NULL && tree->Garbage.Size > 0) Reclaim_N_Tree (tree, 0);
+}
+
+bool SetAttribute_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, const char* name, enum AttributeKindType kind, const char* text) {
+
+  if (tree == NULL || node == NULL || name == NULL || text == NULL) {
+
+    printf ("Error! Invalid arguments. SetAttribute_N_Tree()\n");
+    return false;
+  }
+  if (name[0] == '\0' || strlen (name) >= ATTR_NAME_SIZE) {
+
+    printf ("Error! Attribute name must be 1 ~ %d characters. SetAttribute_N_Tree()\n", ATTR_NAME_SIZE - 1);
+    return false;
+  }
+
+  struct AttributeColumnType* column = FindAttributeColumn (tree->Attributes, name);
+  if (column != NULL && kind != ATTR_AUTO && kind != column->Kind) {
+
+    printf ("Error! Attribute '%s' holds %s values. SetAttribute_N_Tree()\n", name, AttributeKindName (column->Kind));
+    return false;
+  }
+  if (kind == ATTR_AUTO) kind = column != NULL ? column->Kind : InferKind (text);
+
+  // 값을 먼저 검증한 뒤에 열을 만든다
+  long long integer = 0;
+  double real = 0.0;
+  LabelType label = 0;
+  bool valid = true;
+
+  switch (kind) {
+
+    case ATTR_INT: valid = ParseInt (text, &integer); break;
+    case ATTR_FLOAT: valid = ParseFloat (text, &real); break;
+    case ATTR_TIMESTAMP: valid = ParseTimestamp (text, &integer); break;
+    default: label = Intern_Label (tree->Labels, text); valid = label != LABEL_NONE; break;
+  }
+  if (!valid) {
+
+    printf ("Error! '%s' is not a valid %s value. SetAttribute_N_Tree()\n", text, AttributeKindName (kind));
+    return false;
+  }
+
+  if (column == NULL) column = AddAttributeColumn (tree, name, kind);
+  if (column == NULL || !EnsureColumnCapacity (column, node->Id)) {
+
+    printf ("Error! The dynamic memory allocation failed. SetAttribute_N_Tree()\n");
+    return false;
+  }
+
+  switch (kind) {
+
+    case ATTR_FLOAT: column->Values.Floats[node->Id] = real; break;
+    case ATTR_STRING: column->Values.Strings[node->Id] = label; break;
+    default: column->Values.Ints[node->Id] = integer; break;
+  }
+  MarkPresent (column, node->Id);
+  if (IsRollupAttribute (name)) UpdateRollup_N_Tree (tree, node);
+  return true;
+}
+
+void FormatAttributeValue (struct N_TreeType* tree, struct AttributeColumnType* column, int id, char* out, int outSize) {
+
+  switch (column->Kind) {
+
+    case ATTR_INT: snprintf (out, outSize, "%lld", column->Values.Ints[id]); break;
+    case ATTR_FLOAT:
+      // 다시 읽었을 때 같은 값이 되는 가장 짧은 표기
+      snprintf (out, outSize, "%.15g", column->Values.Floats[id]);
+      if (strtod (out, NULL) != column->Values.Floats[id]) snprintf (out, outSize, "%.17g", column->Values.Floats[id]);
+      break;
+    case ATTR_TIMESTAMP: FormatTimestamp (column->Values.Ints[id], out, outSize); break;
+    default: snprintf (out, outSize, "%s", Label_Text (tree->Labels, column->Values.Strings[id])); break;
+  }
+}
+
+bool GetAttribute_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, const char* name, char* out, int outSize) {
+
+  if (tree == NULL || node == NULL || out == NULL) return false;
+
+  struct AttributeColumnType* column = FindAttributeColumn (tree->Attributes, name);
+  if (!HasAttributeValue (column, node->Id)) return false;
+
+  FormatAttributeValue (tree, column, node->Id, out, outSize);
+  return true;
+}
+
+bool UnsetAttribute_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, const char* name) {
+
+  if (tree == NULL || node == NULL) return false;
+
+  struct AttributeColumnType* column = FindAttributeColumn (tree->Attributes, name);
+  if (!HasAttributeValue (column, node->Id)) return false;
+
+  ClearPresent (column, node->Id);
+  if (IsRollupAttribute (name)) UpdateRollup_N_Tree (tree, node);
+  return true;
+}
+
+// 다른 트리(또는 같은 트리)의 노드 속성을 그대로 옮겨 적는다
+bool CopyAttributes_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, struct N_TreeType* source, struct TreeNodeType* sourceNode) {
+
+  if (tree == NULL || node == NULL || source == NULL || sourceNode == NULL) return false;
+  if (source->Attributes == NULL) return true;
+
+  char text[LABEL_MAX_LENGTH + 1];
+  for (int index = 0; index < source->Attributes->Count; index++) {
+
+    struct AttributeColumnType* column = &source->Attributes->Columns[index];
+    if (!HasAttributeValue (column, sourceNode->Id)) continue;
+
+    FormatAttributeValue (source, column, sourceNode->Id, text, sizeof (text));
+    if (!SetAttribute_N_Tree (tree, node, column->Name, column->Kind, text)) return false;
+  }
+  return true;
+}
+
+void ClearAttributes_N_Tree (struct N_TreeType* tree, int id) {
+
+  if (tree == NULL || tree->Attributes == NULL) return;
+
+  for (int index = 0; index < tree->Attributes->Count; index++) {
+
+    ClearPresent (&tree->Attributes->Columns[index], id);
+  }
+}
+
+bool CompareAttributeOrder (int order, enum AttributeOperatorType op) {
+
+  switch (op) {
+
+    case ATTR_OP_EQ: return order == 0;
+    case ATTR_OP_NE: return order != 0;
+    case ATTR_OP_LT: return order < 0;
+    case ATTR_OP_LE: return order <= 0;
+    case ATTR_OP_GT: return order > 0;
+    default: return order >= 0;
+  }
+}
+
+const char* ParseAttributeOperator (const char* text, enum AttributeOperatorType* op) {
+
+  if (text[0] == '!' && text[1] == '=') { *op = ATTR_OP_NE; return text + 2; }
+  if (text[0] == '<' && text[1] == '=') { *op = ATTR_OP_LE; return text + 2; }
+  if (text[0] == '>' && text[1] == '=') { *op = ATTR_OP_GE; return text + 2; }
+  if (text[0] == '=') { *op = ATTR_OP_EQ; return text + (text[1] == '=' ? 2 : 1); }
+  if (text[0] == '<') { *op = ATTR_OP_LT; return text + 1; }
+  if (text[0] == '>') { *op = ATTR_OP_GT; return text + 1; }
+  return NULL;
+}
+
+// "status=failed", "duration>=30", "due<2024-06-01" 형태의 조건을 열에 묶는다
+bool ParseAttributeCondition (struct N_TreeType* tree, const char* expression, struct AttributeConditionType* condition) {
+
+  if (tree == NULL || expression == NULL || condition == NULL) return false;
+
+  memset (condition, 0, sizeof (struct AttributeConditionType));
+  condition->Label = LABEL_NONE;
+
+  const char* opStart = strpbrk (expression, "=!<>");
+  if (opStart == NULL || opStart == expression) {
+
+    printf ("Error! Expected <name><op><value> with op one of = != < <= > >=. ParseAttributeCondition()\n");
+    return false;
+  }
+
+  char name[ATTR_NAME_SIZE];
+  int nameLength = opStart - expression;
+  while (nameLength > 0 && expression[nameLength - 1] == ' ') nameLength--;
+  if (nameLength >= ATTR_NAME_SIZE) nameLength = ATTR_NAME_SIZE - 1;
+  memcpy (name, expression, nameLength);
+  name[nameLength] = '\0';
+
+  const char* value = ParseAttributeOperator (opStart, &condition->Operator);
+  if (value == NULL) {
+
+    printf ("Error! Unknown operator in '%s'. ParseAttributeCondition()\n", expression);
+    return false;
+  }
+  while (*value == ' ') value++;
+  condition->Text = value;
+
+  // 없는 속성이면 Column 이 NULL 로 남아 아무 노드도 맞지 않는다
+  struct AttributeColumnType* column = FindAttributeColumn (tree->Attributes, name);
+  if (column == NULL) return true;
+
+  bool valid = true;
+  switch (column->Kind) {
+
+    case ATTR_INT: valid = ParseInt (value, &condition->Int); break;
+    case ATTR_FLOAT: valid = ParseFloat (value, &condition->Float); break;
+    case ATTR_TIMESTAMP: valid = ParseTimestamp (value, &condition->Int); break;
+    default: condition->Label = Find_Label (tree->Labels, value); break;
+  }
+  if (!valid) {
+
+    printf ("Error! '%s' is not a valid %s value. ParseAttributeCondition()\n", value, AttributeKindName (column->Kind));
+    return false;
+  }
+
+  condition->Column = column;
+  return true;
+}
+
+bool TestAttributeCondition (struct N_TreeType* tree, const struct AttributeConditionType* condition, int id) {
+
+  struct AttributeColumnType* column = condition->Column;
+  if (!HasAttributeValue (column, id)) return false;
+
+  int order;
+  switch (column->Kind) {
+
+    case ATTR_FLOAT: {
+
+      double current = column->Values.Floats[id];
+      order = (current > condition->Float) - (current < condition->Float);
+      break;
+    }
+    case ATTR_STRING:
+      // 문자열 같음 비교는 핸들 비교: 표에 없는 문자열이면 = 는 아무것도 맞지 않는다
+      if (condition->Operator == ATTR_OP_EQ || condition->Operator == ATTR_OP_NE) order = column->Values.Strings[id] != condition->Label;
+      else order = strcmp (Label_Text (tree->Labels, column->Values.Strings[id]), condition->Text);
+      break;
+    default: {
+
+      long long current = column->Values.Ints[id];
+      order = (current > condition->Int) - (current < condition->Int);
+      break;
+    }
+  }
+  return CompareAttributeOrder (order, condition->Operator);
+}
+
+bool Where_N_Tree (struct N_TreeType* tree, const char* expression, struct NodeListType* result) {
+
+  if (tree == NULL || expression == NULL || result == NULL) return false;
+
+  SettleAttributes (tree);
+  struct AttributeConditionType condition;
+  if (!ParseAttributeCondition (tree, expression, &condition)) return false;
+
+  struct AttributeColumnType* column = condition.Column;
+  if (column == NULL) return true;
+  if (column->Kind == ATTR_STRING && condition.Operator == ATTR_OP_EQ && condition.Label == LABEL_NONE) return true;
+
+  // 값이 있는 노드만 비트맵에서 골라 비교한다
+  int words = column->Capacity / 64;
+  for (int word = 0; word < words; word++) {
+
+    unsigned long long bits = column->Present[word];
+    while (bits != 0) {
+
+      int id = word * 64 + __builtin_ctzll (bits);
+      bits &= bits - 1;
+
+      if (!TestAttributeCondition (tree, &condition, id)) continue;
+
+      struct TreeNodeType* node = NodeById_N_Tree (tree, id);
+      if (node != NULL && !AppendNodeList (result, node)) return false;
+    }
+  }
+  return true;
+}
+
+static unsigned long long MixDigest (unsigned long long value) {
+
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdULL;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ULL;
+  value ^= value >> 33;
+  return value;
+}
+
+static unsigned long long HashText (const char* text, unsigned long long hash) {
+
+  for (; *text != '\0'; text++) hash = (hash ^ (unsigned char) *text) * 0x100000001b3ULL;
+  return hash;
+}
+
+// 열 이름과 값 하나의 요약 값 (문자열은 핸들 대신 글자로 세므로 트리가 달라도 같다)
+static unsigned long long ValueDigest (struct N_TreeType* tree, struct AttributeColumnType* column, unsigned long long name, int id) {
+
+  unsigned long long value;
+  if (column->Kind == ATTR_STRING) value = HashText (Label_Text (tree->Labels, column->Values.Strings[id]), 0xcbf29ce484222325ULL);
+  else memcpy (&value, &column->Values.Ints[id], sizeof (value));
+  return MixDigest (name ^ value);
+}
+
+// 노드 하나의 속성 요약 값 (값이 없으면 0)
+unsigned long long NodeAttributeDigest_N_Tree (struct N_TreeType* tree, int id) {
+
+  struct AttributeTableType* table = tree != NULL ? tree->Attributes : NULL;
+  if (table == NULL) return 0;
+
+  unsigned long long digest = 0;
+  for (int index = 0; index < table->Count; index++) {
+
+    struct AttributeColumnType* column = &table->Columns[index];
+    if (!HasAttributeValue (column, id)) continue;
+
+    unsigned long long name = HashText (column->Name, 0xcbf29ce484222325ULL) + (unsigned long long) column->Kind;
+    digest += ValueDigest (tree, column, name, id);
+  }
+  return digest;
+}
+
+// 모든 속성 값의 요약 값. 노드는 슬롯 경로로 세므로 다시 읽은 트리와 비교할 수 있다 (값이 없으면 0).
+unsigned long long AttributeDigest_N_Tree (struct N_TreeType* tree) {
+
+  if (tree != NULL) SettleAttributes (tree);
+  struct AttributeTableType* table = tree != NULL ? tree->Attributes : NULL;
+  if (table == NULL) return 0;
+
+  unsigned long long digest = 0;
+  bool any = false;
+  for (int index = 0; index < table->Count; index++) {
+
+    struct AttributeColumnType* column = &table->Columns[index];
+    if (column->Size == 0) continue;
+
+    unsigned long long name = HashText (column->Name, 0xcbf29ce484222325ULL) + (unsigned long long) column->Kind;
+    for (int word = 0; word < column->Capacity / 64; word++) {
+
+      unsigned long long bits = column->Present[word];
+      while (bits != 0) {
+
+        int id = word * 64 + __builtin_ctzll (bits);
+        bits &= bits - 1;
+
+        struct TreeNodeType* node = NodeById_N_Tree (tree, id);
+        if (node == NULL) continue;
+
+        digest += MixDigest (SlotPathHash_N_Tree (node) * 31 + ValueDigest (tree, column, name, id));
+        any = true;
+      }
+    }
+  }
+  return digest != 0 || !any ? digest : 1;
+}
+
+// 이진 저장 형식 (리틀 엔디언)
+//   "WTAT" u32 version u32 columns
+//   columns x { u8 nameLength, name, u8 kind, u32 count, count x { u32 entry, value } }
+//   value: int/time = i64, float = f64 비트, string = u32 length + bytes
+static void WriteU32 (FILE* fp, unsigned int value) {
+
+  unsigned char bytes[4] = { value & 0xFF, (value >> 8) & 0xFF, (value >> 16) & 0xFF, (value >> 24) & 0xFF };
+  fwrite (bytes, 1, 4, fp);
+}
+
+static void WriteU64 (FILE* fp, unsigned long long value) {
+
+  WriteU32 (fp, (unsigned int) (value & 0xFFFFFFFFu));
+  WriteU32 (fp, (unsigned int) (value >> 32));
+}
+
+static bool ReadU32 (FILE* fp, unsigned int* value) {
+
+  unsigned char bytes[4];
+  if (fread (bytes, 1, 4, fp) != 4) return false;
+  *value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((unsigned int) bytes[3] << 24);
+  return true;
+}
+
+static bool ReadU64 (FILE* fp, unsigned long long* value) {
+
+  unsigned int low, high;
+  if (!ReadU32 (fp, &low) || !ReadU32 (fp, &high)) return false;
+  *value = ((unsigned long long) high << 32) | low;
+  return true;
+}
+
+// 값 하나를 종류에 맞게 쓴다 (스냅숏의 속성 기록도 같은 형식을 쓴다)
+void WriteAttributeValue (struct N_TreeType* tree, struct AttributeColumnType* column, int id, FILE* fp) {
+
+  if (column->Kind == ATTR_STRING) {
+
+    const char* text = Label_Text (tree->Labels, column->Values.Strings[id]);
+    unsigned int length = strlen (text);
+    WriteU32 (fp, length);
+    fwrite (text, 1, length, fp);
+  } else {
+
+    unsigned long long bits;
+    memcpy (&bits, &column->Values.Ints[id], sizeof (bits));
+    WriteU64 (fp, bits);
+  }
+}
+
+// 값 하나를 읽어 SetAttribute_N_Tree 에 넘길 문자열로 만든다 (text 는 LABEL_MAX_LENGTH + 1 칸 이상)
+bool ReadAttributeValue (FILE* fp, enum AttributeKindType kind, char* text, int textSize) {
+
+  if (kind == ATTR_STRING) {
+
+    unsigned int length;
+    if (!ReadU32 (fp, &length) || length > LABEL_MAX_LENGTH || (int) length >= textSize || fread (text, 1, length, fp) != length) return false;
+    text[length] = '\0';
+    return true;
+  }
+
+  unsigned long long bits;
+  if (!ReadU64 (fp, &bits)) return false;
+  if (kind == ATTR_FLOAT) {
+
+    double real;
+    memcpy (&real, &bits, sizeof (real));
+    snprintf (text, textSize, "%.17g", real);
+  } else {
+
+    snprintf (text, textSize, kind == ATTR_TIMESTAMP ? "@%lld" : "%lld", (long long) bits);
+  }
+  return true;
+}
+
+bool SaveAttributesBinary (struct N_TreeType* tree, FILE* fp) {
+
+  if (tree == NULL || fp == NULL) return false;
+  SettleAttributes (tree);
+  if (!Renumber_N_Tree (tree)) return false;
+
+  struct AttributeTableType* table = tree->Attributes;
+  int columns = table == NULL ? 0 : table->Count;
+
+  fwrite (ATTR_MAGIC, 1, 4, fp);
+  WriteU32 (fp, ATTR_VERSION);
+  WriteU32 (fp, columns);
+
+  for (int index = 0; index < columns; index++) {
+
+    struct AttributeColumnType* column = &table->Columns[index];
+    unsigned char nameLength = (unsigned char) strlen (column->Name);
+    unsigned char kind = (unsigned char) column->Kind;
+
+    fwrite (&nameLength, 1, 1, fp);
+    fwrite (column->Name, 1, nameLength, fp);
+    fwrite (&kind, 1, 1, fp);
+    WriteU32 (fp, column->Size);
+
+    for (int id = 0; id < column->Capacity; id++) {
+
+      if (!HasAttributeValue (column, id)) continue;
+
+      WriteU32 (fp, tree->Nodes[id]->Entry);
+      WriteAttributeValue (tree, column, id, fp);
+    }
+  }
+  return ferror (fp) == 0;
+}
+
+bool LoadAttributesBinary (struct N_TreeType* tree, FILE* fp) {
+
+  if (tree == NULL || fp == NULL) return false;
+  if (!Renumber_N_Tree (tree)) return false;
+
+  char magic[4];
+  unsigned int version, columns;
+  if (fread (magic, 1, 4, fp) != 4 || memcmp (magic, ATTR_MAGIC, 4) != 0 ||
+      !ReadU32 (fp, &version) || version != ATTR_VERSION || !ReadU32 (fp, &columns)) {
+
+    printf ("Error! Not an attribute file. LoadAttributesBinary()\n");
+    return false;
+  }
+
+  struct EulerIndexType* index = tree->Euler;
+  char text[LABEL_MAX_LENGTH + 1];
+
+  for (unsigned int column = 0; column < columns; column++) {
+
+    unsigned char nameLength, kind;
+    char name[ATTR_NAME_SIZE + 256];
+    unsigned int count;
+
+    if (fread (&nameLength, 1, 1, fp) != 1 || fread (name, 1, nameLength, fp) != nameLength ||
+        fread (&kind, 1, 1, fp) != 1 || !ReadU32 (fp, &count)) goto corrupt;
+    name[nameLength] = '\0';
+    if (kind < ATTR_INT || kind > ATTR_TIMESTAMP) goto corrupt;
+
+    for (unsigned int item = 0; item < count; item++) {
+
+      unsigned int entry;
+      if (!ReadU32 (fp, &entry) || !ReadAttributeValue (fp, (enum AttributeKindType) kind, text, sizeof (text))) goto corrupt;
+
+      if (entry >= (unsigned int) index->Size) continue;  // 트리 모양이 달라 대응하는 노드가 없음
+      SetAttribute_N_Tree (tree, index->Order[entry], name, (enum AttributeKindType) kind, text);
+    }
+  }
+  return true;
+
+corrupt:
+  printf ("Error! Attribute file is truncated or corrupt. LoadAttributesBinary()\n");
+  return false;
+}
\ No newline at end of file
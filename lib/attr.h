@@ -0,0 +1,82 @@
+#ifndef _ATTR_H_
+#define _ATTR_H_
+
+#include "n_tree.h"
+#include <stdio.h>
+
+#define ATTR_NAME_SIZE 32
+#define ATTR_TEXT_SIZE 64
+
+enum AttributeKindType {
+
+  ATTR_AUTO = 0,    // 값을 보고 정수, 실수, 시각, 문자열 순으로 추론
+  ATTR_INT,
+  ATTR_FLOAT,
+  ATTR_STRING,      // 트리의 레이블 표에 등록된 핸들로 저장
+  ATTR_TIMESTAMP    // UTC 기준 초 단위 epoch
+};
+
+// 속성 하나를 노드 번호로 색인한 열. 같은 종류의 값만 담는다.
+struct AttributeColumnType {
+
+  char Name[ATTR_NAME_SIZE];
+  enum AttributeKindType Kind;
+  unsigned long long* Present;  // 노드 번호별 값 존재 비트
+  union {
+
+    long long* Ints;      // ATTR_INT, ATTR_TIMESTAMP
+    double* Floats;       // ATTR_FLOAT
+    LabelType* Strings;   // ATTR_STRING
+  } Values;
+  int Capacity;           // 할당된 노드 번호 수 (64 의 배수)
+  int Size;               // 값이 있는 노드 수
+};
+
+enum AttributeOperatorType { ATTR_OP_EQ, ATTR_OP_NE, ATTR_OP_LT, ATTR_OP_LE, ATTR_OP_GT, ATTR_OP_GE };
+
+// 열 종류에 맞게 미리 해석해 둔 비교 조건
+struct AttributeConditionType {
+
+  struct AttributeColumnType* Column;  // NULL 이면 없는 속성 (아무 노드도 맞지 않음)
+  enum AttributeOperatorType Operator;
+  long long Int;        // ATTR_INT, ATTR_TIMESTAMP
+  double Float;         // ATTR_FLOAT
+  LabelType Label;      // ATTR_STRING 의 = / != 비교용 핸들
+  const char* Text;     // 원래 값 문자열 (식 문자열을 가리킨다)
+};
+
+struct AttributeTableType {
+
+  struct AttributeColumnType* Columns;
+  int Count;
+  int Capacity;
+};
+
+struct AttributeTableType* Create_Attribute_Table (void);
+void Delete_Attribute_Table (struct AttributeTableType* table);
+struct AttributeColumnType* FindAttributeColumn (struct AttributeTableType* table, const char* name);
+const char* AttributeKindName (enum AttributeKindType kind);
+enum AttributeKindType ParseAttributeKind (const char* name);
+
+bool SetAttribute_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, const char* name, enum AttributeKindType kind, const char* text);
+bool GetAttribute_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, const char* name, char* out, int outSize);
+bool UnsetAttribute_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, const char* name);
+bool CopyAttributes_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, struct N_TreeType* source, struct TreeNodeType* sourceNode);
+void ClearAttributes_N_Tree (struct N_TreeType* tree, int id);
+bool HasAttributeValue (struct AttributeColumnType* column, int id);
+void FormatAttributeValue (struct N_TreeType* tree, struct AttributeColumnType* column, int id, char* out, int outSize);
+const char* ParseAttributeOperator (const char* text, enum AttributeOperatorType* op);
+bool CompareAttributeOrder (int order, enum AttributeOperatorType op);
+bool ParseAttributeCondition (struct N_TreeType* tree, const char* expression, struct AttributeConditionType* condition);
+bool TestAttributeCondition (struct N_TreeType* tree, const struct AttributeConditionType* condition, int id);
+bool Where_N_Tree (struct N_TreeType* tree, const char* expression, struct NodeListType* result);
+unsigned long long AttributeDigest_N_Tree (struct N_TreeType* tree);
+unsigned long long NodeAttributeDigest_N_Tree (struct N_TreeType* tree, int id);
+
+// 열 단위 이진 저장: 노드는 전위 번호로 기록하므로 다른 세션에서 읽어도 같은 노드를 가리킨다
+bool SaveAttributesBinary (struct N_TreeType* tree, FILE* fp);
+bool LoadAttributesBinary (struct N_TreeType* tree, FILE* fp);
+void WriteAttributeValue (struct N_TreeType* tree, struct AttributeColumnType* column, int id, FILE* fp);
+bool ReadAttributeValue (FILE* fp, enum AttributeKindType kind, char* text, int textSize);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include "bulk.h"
+#include "metrics.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void AddBuildError (struct BuildErrorListType* errors, int record, const char* format, ...) {
+
+  errors->Total++;
+  if (errors->Size >= BUILD_MAX_ERRORS) return;
+
+  struct BuildErrorType* error = &errors->Items[errors->Size++];
+  error->Record = record;
+
+  va_list arguments;
+  va_start (arguments, format);
+  vsnprintf (error->Message, BUILD_MESSAGE_SIZE, format, arguments);
+  va_end (arguments);
+}
+
+// 레코드를 모두 검증하고, 오류가 하나라도 있으면 트리를 만들지 않는다 (오류는 errors 로만 보고)
+struct N_TreeType* Build_N_Tree (int number_of_children, const struct BuildRecordType* records, int count, struct BuildErrorListType* errors) {
+
+  struct BuildErrorListType localErrors;
+  if (errors == NULL) errors = &localErrors;
+  errors->Size = 0;
+  errors->Total = 0;
+
+  if (number_of_children < 1 || number_of_children > CHILD_SIZE_MAX) {
+
+    AddBuildError (errors, -1, "invalid number_of_children %d (must be between 1 and %d)", number_of_children, CHILD_SIZE_MAX);
+    return NULL;
+  }
+  if (records == NULL || count < 1) {
+
+    AddBuildError (errors, -1, "no records");
+    return NULL;
+  }
+
+  for (int index = 0; index < count; index++) {
+
+    const struct BuildRecordType* record = &records[index];
+
+    if (index == 0 && record->Parent != -1) AddBuildError (errors, index, "first record must be the root (parent -1)");
+    if (index > 0 && (record->Parent < 0 || record->Parent >= index)) AddBuildError (errors, index, "parent %d must refer to an earlier record", record->Parent);
+    if (index > 0 && (record->Slot < 0 || record->Slot >= number_of_children)) AddBuildError (errors, index, "slot %d is out of range (0 ~ %d)", record->Slot, number_of_children - 1);
+    if (record->Data == NULL) AddBuildError (errors, index, "data is NULL");
+    else if (strlen (record->Data) > LABEL_MAX_LENGTH) AddBuildError (errors, index, "data is too long (max %d characters)", LABEL_MAX_LENGTH);
+  }
+  if (errors->Total > 0) return NULL;
+
+  // 부모마다 가장 높은 슬롯을 담는 크기로만 자식 블록을 잡는다 (리프는 블록이 없다)
+  int* capacities = (int*) calloc ((size_t) count, sizeof (int));
+  if (capacities == NULL) {
+
+    AddBuildError (errors, -1, "the dynamic memory allocation failed");
+    return NULL;
+  }
+  size_t childBytes = 0;
+  for (int index = 1; index < count; index++) {
+
+    int* capacity = &capacities[records[index].Parent];
+    if (*capacity == 0) *capacity = CHILD_MIN_CAPACITY;
+    while (*capacity <= records[index].Slot) *capacity *= 2;
+  }
+  for (int index = 0; index < count; index++) {
+
+    if (capacities[index] > 0) childBytes += CHILD_BLOCK_BYTES (capacities[index]);
+  }
+
+  struct N_TreeType* tree = (struct N_TreeType*) calloc (1, sizeof (struct N_TreeType));
+  struct NodeSlabType* slab = (struct NodeSlabType*) calloc (1, sizeof (struct NodeSlabType));
+  struct LabelPoolType* labels = Create_Label_Pool ();
+
+  // 노드와 자식 블록 전체를 블록 하나로 할당
+  size_t nodeBytes = (size_t) count * sizeof (struct TreeNodeType);
+  char* memory = (char*) calloc (1, nodeBytes + childBytes);
+  struct TreeNodeType** registry = (struct TreeNodeType**) malloc ((size_t) count * sizeof (struct TreeNodeType*));
+
+  if (tree == NULL || slab == NULL || labels == NULL || memory == NULL || registry == NULL) {
+
+    AddBuildError (errors, -1, "the dynamic memory allocation failed");
+    free (capacities);
+    free (registry);
+    free (tree);
+    free (slab);
+    free (memory);
+    Delete_Label_Pool (labels);
+    return NULL;
+  }
+
+  struct TreeNodeType* nodes = (struct TreeNodeType*) memory;
+  char* children = memory + nodeBytes;
+
+  for (int index = 0; index < count; index++) {
+
+    struct TreeNodeType* node = &nodes[index];
+    if (capacities[index] > 0) {
+
+      node->Children = (struct TreeNodeType**) children;
+      node->Capacity = capacities[index];
+      node->ChildrenInSlab = true;
+      children += CHILD_BLOCK_BYTES (capacities[index]);
+    }
+    node->InSlab = true;
+    node->Id = index;  // 노드 번호는 레코드 번호와 같다
+    registry[index] = node;
+
+    node->Label = Intern_Label (labels, records[index].Data);
+    if (node->Label == LABEL_NONE) {
+
+      AddBuildError (errors, index, "the dynamic memory allocation failed");
+      break;
+    }
+    if (index == 0) continue;
+
+    struct TreeNodeType* parent = &nodes[records[index].Parent];
+    if (ChildAt_N_Tree (parent, records[index].Slot) != NULL) {
+
+      AddBuildError (errors, index, "slot %d of record %d is already occupied", records[index].Slot, records[index].Parent);
+      continue;
+    }
+    SetChild_N_Tree (parent, records[index].Slot, node);
+    node->Parent = parent;
+  }
+
+  free (capacities);
+  if (errors->Total > 0) {
+
+    free (registry);
+    free (memory);
+    free (slab);
+    free (tree);
+    Delete_Label_Pool (labels);
+    return NULL;
+  }
+
+  METRIC_ADD (METRIC_NODES_ALLOCATED, count);
+  METRIC_ADD (METRIC_NODE_BYTES, nodeBytes + childBytes);
+  slab->Memory = memory;
+  tree->Labels = labels;
+  tree->Slabs = slab;
+  tree->Nodes = registry;
+  tree->NodeCapacity = count;
+  tree->NextId = count;
+  tree->Head = nodes;
+  tree->ChildSize = number_of_children;
+  tree->Count = count;
+  Rehash_N_Tree (tree);
+  return tree;
+}
@@ -0,0 +1,33 @@
+#ifndef _BULK_H_
+#define _BULK_H_
+
+#include "n_tree.h"
+
+#define BUILD_MAX_ERRORS 100
+#define BUILD_MESSAGE_SIZE 96
+
+// 일괄 생성용 레코드: Parent 는 앞선 레코드의 번호 (0 번 레코드는 루트이며 -1)
+struct BuildRecordType {
+
+  int Parent;
+  int Slot;
+  const char* Data;
+};
+
+struct BuildErrorType {
+
+  int Record;
+  char Message[BUILD_MESSAGE_SIZE];
+};
+
+// 처음 BUILD_MAX_ERRORS 개의 오류만 보관하고, Total 은 전체 오류 수
+struct BuildErrorListType {
+
+  struct BuildErrorType Items[BUILD_MAX_ERRORS];
+  int Size;
+  int Total;
+};
+
+struct N_TreeType* Build_N_Tree (int number_of_children, const struct BuildRecordType* records, int count, struct BuildErrorListType* errors);
+
+#endif
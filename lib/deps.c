@@ -0,0 +1,618 @@
+#include "deps.h"
+#include "euler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static struct DependencyIndexType* IndexOf (struct N_TreeType* tree) {
+
+  if (tree->Dependencies != NULL) return tree->Dependencies;
+
+  tree->Dependencies = (struct DependencyIndexType*) calloc (1, sizeof (struct DependencyIndexType));
+  if (tree->Dependencies == NULL) printf ("Error! The dynamic memory allocation failed. IndexOf()\n");
+  return tree->Dependencies;
+}
+
+// 노드 번호 capacity 개를 담도록 늘린다 (새 칸은 간선 없음)
+static bool EnsureDependencyCapacity (struct DependencyIndexType* index, int capacity) {
+
+  if (capacity <= index->Capacity) return true;
+
+  int size = index->Capacity == 0 ? 256 : index->Capacity;
+  while (size < capacity) size *= 2;
+
+  int* slots = (int*) realloc (index->Slots, (size_t) size * sizeof (int));
+  if (slots == NULL) return false;
+  index->Slots = slots;
+  int* rank = (int*) realloc (index->Rank, (size_t) size * sizeof (int));
+  if (rank == NULL) return false;
+  index->Rank = rank;
+  unsigned int* visit = (unsigned int*) realloc (index->Visit, (size_t) size * sizeof (unsigned int));
+  if (visit == NULL) return false;
+  index->Visit = visit;
+
+  for (int id = index->Capacity; id < size; id++) slots[id] = -1;
+  memset (rank + index->Capacity, 0, (size_t) (size - index->Capacity) * sizeof (int));
+  memset (visit + index->Capacity, 0, (size_t) (size - index->Capacity) * sizeof (unsigned int));
+  index->Capacity = size;
+  return true;
+}
+
+static struct DependencyListType* ListOf (struct DependencyIndexType* index, int id) {
+
+  if (index == NULL || id < 0 || id >= index->Capacity || index->Slots[id] < 0) return NULL;
+  return &index->Lists[index->Slots[id]];
+}
+
+// id 의 목록을 만들고 간선 하나가 더 들어갈 자리를 잡는다
+static bool ReserveList (struct DependencyIndexType* index, int id) {
+
+  if (index->Slots[id] < 0) {
+
+    if (index->ListCount == index->ListCapacity) {
+
+      int capacity = index->ListCapacity == 0 ? 64 : index->ListCapacity * 2;
+      struct DependencyListType* lists = (struct DependencyListType*) realloc (index->Lists, (size_t) capacity * sizeof (struct DependencyListType));
+      if (lists == NULL) return false;
+
+      index->Lists = lists;
+      index->ListCapacity = capacity;
+    }
+    memset (&index->Lists[index->ListCount], 0, sizeof (struct DependencyListType));
+    index->Lists[index->ListCount].Id = id;
+    index->Slots[id] = index->ListCount++;
+  }
+
+  struct DependencyListType* list = &index->Lists[index->Slots[id]];
+  if (list->OnCount + list->ByCount < list->Capacity) return true;
+
+  int capacity = list->Capacity == 0 ? 4 : list->Capacity * 2;
+  int* ids = (int*) realloc (list->Ids, (size_t) capacity * sizeof (int));
+  if (ids == NULL) return false;
+
+  list->Ids = ids;
+  list->Capacity = capacity;
+  return true;
+}
+
+// 간선이 하나도 남지 않은 목록은 마지막 목록을 그 자리로 옮기고 지운다
+static void DropEmptyList (struct DependencyIndexType* index, int id) {
+
+  struct DependencyListType* list = ListOf (index, id);
+  if (list == NULL || list->OnCount + list->ByCount > 0) return;
+
+  free (list->Ids);
+  int slot = index->Slots[id];
+  index->Slots[id] = -1;
+  if (slot != --index->ListCount) {
+
+    index->Lists[slot] = index->Lists[index->ListCount];
+    index->Slots[index->Lists[slot].Id] = slot;
+  }
+}
+
+// 자리는 ReserveList 로 미리 잡아 둔다. On 칸이 늘면 By 의 첫 칸을 맨 뒤로 옮긴다.
+static void InsertId (struct DependencyListType* list, int id, bool by) {
+
+  if (by) {
+
+    list->Ids[list->OnCount + list->ByCount++] = id;
+    return;
+  }
+  list->Ids[list->OnCount + list->ByCount] = list->Ids[list->OnCount];
+  list->Ids[list->OnCount++] = id;
+}
+
+static bool RemoveId (struct DependencyListType* list, int id, bool by) {
+
+  int first = by ? list->OnCount : 0;
+  int count = by ? list->ByCount : list->OnCount;
+  for (int index = first; index < first + count; index++) {
+
+    if (list->Ids[index] != id) continue;
+
+    int end = list->OnCount + list->ByCount;
+    if (by) {
+
+      list->Ids[index] = list->Ids[end - 1];
+      list->ByCount--;
+    } else {
+
+      // On 의 마지막 칸으로 구멍을 메우고, 그 칸은 By 의 마지막 칸으로 메운다
+      list->Ids[index] = list->Ids[list->OnCount - 1];
+      list->Ids[list->OnCount - 1] = list->Ids[end - 1];
+      list->OnCount--;
+    }
+    return true;
+  }
+  return false;
+}
+
+static bool Visited (struct DependencyIndexType* index, int id) {
+
+  if (index->Visit[id] == index->Epoch) return true;
+  index->Visit[id] = index->Epoch;
+  return false;
+}
+
+static void NextEpoch (struct DependencyIndexType* index) {
+
+  if (++index->Epoch == 0) {
+
+    memset (index->Visit, 0, (size_t) index->Capacity * sizeof (unsigned int));
+    index->Epoch = 1;
+  }
+}
+
+// 메모리에 있는 노드 전체를 다시 정렬한다 (Kahn).
+// 자식과 기다리는 노드가 모두 끝나야 차례가 오며, 읽지 않은 서브트리의 자리표시자는 리프로 본다.
+static bool BuildOrder (struct N_TreeType* tree, struct DependencyIndexType* index) {
+
+  int* pending = (int*) calloc ((size_t) (tree->NextId > 0 ? tree->NextId : 1), sizeof (int));
+  struct NodeListType nodes = { NULL, 0, 0 };
+  struct NodeListType queue = { NULL, 0, 0 };
+  bool ok = pending != NULL && EnsureDependencyCapacity (index, tree->NextId) && AppendNodeList (&nodes, tree->Head);
+
+  for (long at = 0; ok && at < nodes.Size; at++) {
+
+    struct TreeNodeType* node = nodes.Items[at];
+    const struct DependencyListType* list = ListOf (index, node->Id);
+    pending[node->Id] = ChildCount_N_Tree (node) + (list != NULL ? list->OnCount : 0);
+    if (pending[node->Id] == 0) ok = AppendNodeList (&queue, node);
+
+    FOR_EACH_CHILD_SLOT (node, slot) {
+
+      if (ok) ok = AppendNodeList (&nodes, node->Children[slot]);
+    }
+  }
+
+  int rank = 0;
+  for (long at = 0; ok && at < queue.Size; at++) {
+
+    struct TreeNodeType* node = queue.Items[at];
+    index->Rank[node->Id] = rank++;
+
+    if (node->Parent != NULL && --pending[node->Parent->Id] == 0) ok = AppendNodeList (&queue, node->Parent);
+
+    const struct DependencyListType* list = ListOf (index, node->Id);
+    for (int edge = 0; ok && list != NULL && edge < list->ByCount; edge++) {
+
+      int id = list->Ids[list->OnCount + edge];
+      if (--pending[id] == 0) ok = AppendNodeList (&queue, tree->Nodes[id]);
+    }
+  }
+
+  if (ok && queue.Size != nodes.Size) {
+
+    printf ("Error! The dependencies contain a cycle. BuildOrder()\n");
+    ok = false;
+  } else if (!ok) {
+
+    printf ("Error! The dynamic memory allocation failed. BuildOrder()\n");
+  }
+
+  index->Ordered = ok;
+  index->Low = 0;
+  index->High = rank;
+  free (pending);
+  FreeNodeList (&nodes);
+  FreeNodeList (&queue);
+  return ok;
+}
+
+static bool EnsureOrder (struct N_TreeType* tree, struct DependencyIndexType* index) {
+
+  return index->Ordered || BuildOrder (tree, index);
+}
+
+static const int* SortRank;
+
+static int CompareRank (const void* first, const void* second) {
+
+  int a = SortRank[(*(struct TreeNodeType* const*) first)->Id];
+  int b = SortRank[(*(struct TreeNodeType* const*) second)->Id];
+  return a < b ? -1 : a > b;
+}
+
+static int CompareInt (const void* first, const void* second) {
+
+  int a = *(const int*) first;
+  int b = *(const int*) second;
+  return a < b ? -1 : a > b;
+}
+
+// before 가 after 보다 먼저 오도록 순위를 고친다 (Pearce-Kelly).
+// 이미 그렇다면 할 일이 없고, 아니면 after 에서 앞으로 닿는 노드 중 before 보다 앞 순위인 것과
+// before 에서 뒤로 닿는 노드 중 after 보다 뒤 순위인 것만 두 순위 묶음 안에서 다시 매긴다.
+// after 에서 before 에 닿으면 순환이므로 0, 할당에 실패하면 -1, 성공하면 1.
+static int Link (struct N_TreeType* tree, struct DependencyIndexType* index, struct TreeNodeType* before, struct TreeNodeType* after) {
+
+  int lower = index->Rank[after->Id];
+  int upper = index->Rank[before->Id];
+  if (upper < lower) return 1;
+  if (before == after) return 0;
+
+  NextEpoch (index);
+  index->Forward.Size = 0;
+  index->Backward.Size = 0;
+  index->Stack.Size = 0;
+  Visited (index, after->Id);
+  if (!AppendNodeList (&index->Stack, after)) return -1;
+
+  // 앞쪽: 부모와 나를 기다리는 노드
+  while (index->Stack.Size > 0) {
+
+    struct TreeNodeType* node = index->Stack.Items[--index->Stack.Size];
+    if (!AppendNodeList (&index->Forward, node)) return -1;
+
+    struct TreeNodeType* parent = node->Parent;
+    if (parent == before) return 0;
+    if (parent != NULL && index->Rank[parent->Id] < upper && !Visited (index, parent->Id) && !AppendNodeList (&index->Stack, parent)) return -1;
+
+    const struct DependencyListType* list = ListOf (index, node->Id);
+    for (int edge = 0; list != NULL && edge < list->ByCount; edge++) {
+
+      int id = list->Ids[list->OnCount + edge];
+      if (id == before->Id) return 0;
+      if (index->Rank[id] < upper && !Visited (index, id) && !AppendNodeList (&index->Stack, tree->Nodes[id])) return -1;
+    }
+  }
+
+  // 뒤쪽: 자식과 내가 기다리는 노드
+  Visited (index, before->Id);
+  if (!AppendNodeList (&index->Stack, before)) return -1;
+  while (index->Stack.Size > 0) {
+
+    struct TreeNodeType* node = index->Stack.Items[--index->Stack.Size];
+    if (!AppendNodeList (&index->Backward, node)) return -1;
+
+    bool ok = true;
+    FOR_EACH_CHILD_SLOT (node, slot) {
+
+      struct TreeNodeType* child = node->Children[slot];
+      if (ok && index->Rank[child->Id] > lower && !Visited (index, child->Id)) ok = AppendNodeList (&index->Stack, child);
+    }
+    if (!ok) return -1;
+
+    const struct DependencyListType* list = ListOf (index, node->Id);
+    for (int edge = 0; list != NULL && edge < list->OnCount; edge++) {
+
+      int id = list->Ids[edge];
+      if (index->Rank[id] > lower && !Visited (index, id) && !AppendNodeList (&index->Stack, tree->Nodes[id])) return -1;
+    }
+  }
+
+  // 두 묶음이 쓰던 순위를 모아 뒤쪽 묶음, 앞쪽 묶음 순서로 다시 나눠 준다
+  long total = index->Forward.Size + index->Backward.Size;
+  if (total > index->PoolCapacity) {
+
+    int* pool = (int*) realloc (index->Pool, (size_t) total * sizeof (int));
+    if (pool == NULL) return -1;
+    index->Pool = pool;
+    index->PoolCapacity = (int) total;
+  }
+
+  SortRank = index->Rank;
+  qsort (index->Backward.Items, index->Backward.Size, sizeof (struct TreeNodeType*), CompareRank);
+  qsort (index->Forward.Items, index->Forward.Size, sizeof (struct TreeNodeType*), CompareRank);
+
+  long at = 0;
+  for (long item = 0; item < index->Backward.Size; item++) index->Pool[at++] = index->Rank[index->Backward.Items[item]->Id];
+  for (long item = 0; item < index->Forward.Size; item++) index->Pool[at++] = index->Rank[index->Forward.Items[item]->Id];
+  qsort (index->Pool, total, sizeof (int), CompareInt);
+
+  at = 0;
+  for (long item = 0; item < index->Backward.Size; item++) index->Rank[index->Backward.Items[item]->Id] = index->Pool[at++];
+  for (long item = 0; item < index->Forward.Size; item++) index->Rank[index->Forward.Items[item]->Id] = index->Pool[at++];
+  return 1;
+}
+
+// 떼어 낸 노드의 간선은 해제할 때 지워지므로, 간선을 따라가기 전에 남은 노드를 해제한다
+static void Settle (struct N_TreeType* tree) {
+
+  if (tree->Dependencies != NULL && tree->Dependencies->EdgeCount > 0 && tree->Garbage.Size > 0) Reclaim_N_Tree (tree, 0);
+}
+
+static bool IsRegistered (struct N_TreeType* tree, struct TreeNodeType* node) {
+
+  return node != NULL && NodeById_N_Tree (tree, node->Id) == node;
+}
+
+// node 가 on 이 끝난 뒤에 시작하도록 간선을 더한다. 순환이 생기면 더하지 않고 false.
+bool AddDependency_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, struct TreeNodeType* on) {
+
+  if (tree == NULL || !IsRegistered (tree, node) || !IsRegistered (tree, on)) {
+
+    printf ("Error! Invalid arguments. AddDependency_N_Tree()\n");
+    return false;
+  }
+  if (node == on) {
+
+    printf ("Error! A node cannot depend on itself. AddDependency_N_Tree()\n");
+    return false;
+  }
+  Settle (tree);
+
+  struct DependencyIndexType* index = IndexOf (tree);
+  if (index == NULL) return false;
+  if (!EnsureDependencyCapacity (index, tree->NextId)) {
+
+    printf ("Error! The dynamic memory allocation failed. AddDependency_N_Tree()\n");
+    return false;
+  }
+  if (!EnsureOrder (tree, index)) return false;
+
+  const struct DependencyListType* list = ListOf (index, node->Id);
+  for (int edge = 0; list != NULL && edge < list->OnCount; edge++) {
+
+    if (list->Ids[edge] == on->Id) return true;
+  }
+
+  int linked = Link (tree, index, on, node);
+  if (linked == 0) {
+
+    printf ("Error! '%s' already has to finish after '%s' (dependency cycle). AddDependency_N_Tree()\n",
+      Data_N_Tree (tree, on), Data_N_Tree (tree, node));
+    return false;
+  }
+  if (linked < 0 || !ReserveList (index, node->Id) || !ReserveList (index, on->Id)) {
+
+    // 고친 순위는 그대로 두어도 맞다
+    printf ("Error! The dynamic memory allocation failed. AddDependency_N_Tree()\n");
+    DropEmptyList (index, node->Id);
+    DropEmptyList (index, on->Id);
+    return false;
+  }
+
+  InsertId (ListOf (index, node->Id), on->Id, false);
+  InsertId (ListOf (index, on->Id), node->Id, true);
+  index->EdgeCount++;
+  return true;
+}
+
+bool RemoveDependency_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, struct TreeNodeType* on) {
+
+  if (tree == NULL || node == NULL || on == NULL) return false;
+
+  struct DependencyIndexType* index = tree->Dependencies;
+  struct DependencyListType* list = ListOf (index, node->Id);
+  if (list == NULL || !RemoveId (list, on->Id, false)) return false;
+
+  RemoveId (ListOf (index, on->Id), node->Id, true);
+  DropEmptyList (index, node->Id);
+  DropEmptyList (index, on->Id);
+  index->EdgeCount--;
+  return true;
+}
+
+// node 가 기다리는 노드 번호 (없으면 NULL, count 는 0)
+const int* DependsOn_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, int* count) {
+
+  if (tree != NULL) Settle (tree);
+  const struct DependencyListType* list = tree == NULL || node == NULL ? NULL : ListOf (tree->Dependencies, node->Id);
+  *count = list != NULL ? list->OnCount : 0;
+  return list != NULL ? list->Ids : NULL;
+}
+
+// node 를 기다리는 노드 번호 (없으면 NULL, count 는 0)
+const int* DependedBy_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, int* count) {
+
+  if (tree != NULL) Settle (tree);
+  const struct DependencyListType* list = tree == NULL || node == NULL ? NULL : ListOf (tree->Dependencies, node->Id);
+  *count = list != NULL ? list->ByCount : 0;
+  return list != NULL ? list->Ids + list->OnCount : NULL;
+}
+
+bool HasDependencies_N_Tree (struct N_TreeType* tree, int id) {
+
+  if (tree != NULL) Settle (tree);
+  return tree != NULL && ListOf (tree->Dependencies, id) != NULL;
+}
+
+long DependencyCount_N_Tree (struct N_TreeType* tree) {
+
+  if (tree != NULL) Settle (tree);
+  return tree != NULL && tree->Dependencies != NULL ? tree->Dependencies->EdgeCount : 0;
+}
+
+// root 서브트리의 메모리에 있는 노드를 순위 순서로 order 에 덧붙인다 (자식과 기다리는 노드가 항상 먼저)
+bool TopologicalOrder_N_Tree (struct N_TreeType* tree, struct TreeNodeType* root, struct NodeListType* order) {
+
+  if (tree == NULL || tree->Head == NULL || order == NULL) return false;
+  if (root == NULL) root = tree->Head;
+
+  Settle (tree);
+  struct DependencyIndexType* index = IndexOf (tree);
+  if (index == NULL || !EnsureOrder (tree, index)) return false;
+
+  long first = order->Size;
+  bool ok = AppendNodeList (order, root);
+  for (long at = first; ok && at < order->Size; at++) {
+
+    struct TreeNodeType* node = order->Items[at];
+    FOR_EACH_CHILD_SLOT (node, slot) {
+
+      if (ok) ok = AppendNodeList (order, node->Children[slot]);
+    }
+  }
+  if (!ok) {
+
+    printf ("Error! The dynamic memory allocation failed. TopologicalOrder_N_Tree()\n");
+    return false;
+  }
+
+  SortRank = index->Rank;
+  qsort (order->Items + first, order->Size - first, sizeof (struct TreeNodeType*), CompareRank);
+  return true;
+}
+
+// 루트에서 node 까지의 슬롯 번호를 slots 에 채우고 깊이를 돌려준다 (capacity 를 넘으면 세기만 한다)
+int SlotPath_N_Tree (struct TreeNodeType* node, int* slots, int capacity) {
+
+  int depth = 0;
+  for (struct TreeNodeType* at = node; at != NULL && at->Parent != NULL; at = at->Parent) depth++;
+
+  int level = depth;
+  for (struct TreeNodeType* at = node; at != NULL && at->Parent != NULL; at = at->Parent) {
+
+    if (--level < capacity) slots[level] = at->Slot;
+  }
+  return depth;
+}
+
+// 슬롯 경로를 따라 내려간다 (지연 로딩 트리는 지나는 노드의 자식을 읽는다)
+struct TreeNodeType* NodeBySlotPath_N_Tree (struct N_TreeType* tree, const int* slots, int depth) {
+
+  if (tree == NULL) return NULL;
+
+  struct TreeNodeType* node = tree->Head;
+  for (int level = 0; node != NULL && level < depth; level++) {
+
+    if (slots[level] < 0 || slots[level] >= tree->ChildSize) return NULL;
+    node = Access_N_Tree (tree, node, slots[level]);
+  }
+  return node;
+}
+
+static unsigned long long MixPath (unsigned long long value) {
+
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdULL;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ULL;
+  value ^= value >> 33;
+  return value;
+}
+
+// 슬롯 경로의 해시 (노드 번호와 달리 다시 읽은 트리에서도 같다)
+unsigned long long SlotPathHash_N_Tree (struct TreeNodeType* node) {
+
+  unsigned long long hash = 0x9e3779b97f4a7c15ULL;
+  for (; node != NULL && node->Parent != NULL; node = node->Parent) hash = MixPath (hash ^ (unsigned long long) (node->Slot + 1));
+  return hash;
+}
+
+// 간선 집합의 요약 값 (노드 번호 대신 슬롯 경로로 계산하므로 다시 읽은 트리와 비교할 수 있다, 간선이 없으면 0)
+unsigned long long DependencyDigest_N_Tree (struct N_TreeType* tree) {
+
+  if (tree != NULL) Settle (tree);
+  struct DependencyIndexType* index = tree != NULL ? tree->Dependencies : NULL;
+  if (index == NULL || index->EdgeCount == 0) return 0;
+
+  unsigned long long digest = 0;
+  for (int at = 0; at < index->ListCount; at++) {
+
+    const struct DependencyListType* list = &index->Lists[at];
+    unsigned long long node = SlotPathHash_N_Tree (tree->Nodes[list->Id]);
+    for (int edge = 0; edge < list->OnCount; edge++) {
+
+      digest += MixPath (node * 31 + SlotPathHash_N_Tree (tree->Nodes[list->Ids[edge]]));
+    }
+  }
+  return digest != 0 ? digest : 1;
+}
+
+// 새 노드는 자식도 간선도 없으므로 가장 앞 순위에 둔다 (RegisterNode_N_Tree 가 부름)
+void OrderNewNode_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node) {
+
+  struct DependencyIndexType* index = tree->Dependencies;
+  if (index == NULL || !index->Ordered) return;
+
+  if (!EnsureDependencyCapacity (index, node->Id + 1)) {
+
+    index->Ordered = false;
+    return;
+  }
+  index->Rank[node->Id] = --index->Low;
+}
+
+// 기존 노드 위에 끼운 부모: 가장 뒤 순위에 둔 뒤 자기 부모보다 앞으로 당긴다
+void OrderNewParent_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node) {
+
+  struct DependencyIndexType* index = tree->Dependencies;
+  if (index == NULL || !index->Ordered) return;
+
+  Settle (tree);
+  index->Rank[node->Id] = ++index->High;
+  if (node->Parent != NULL && Link (tree, index, node, node->Parent) != 1) index->Ordered = false;
+}
+
+// node 를 newParent 아래로 옮겨도 되는지 확인하고 순위를 맞춘다 (옮기기 전에 부름).
+// 옮길 서브트리 안의 노드가 newParent 나 그 뒤에 올 노드를 기다리면 순환이므로 false.
+bool OrderMove_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, struct TreeNodeType* newParent) {
+
+  Settle (tree);
+  struct DependencyIndexType* index = tree->Dependencies;
+  if (index == NULL || index->EdgeCount == 0) {
+
+    // 간선이 없으면 트리 순서만 지키면 되므로 다음에 쓸 때 다시 정렬한다
+    if (index != NULL) index->Ordered = false;
+    return true;
+  }
+  if (!EnsureOrder (tree, index)) return false;
+
+  int linked = Link (tree, index, node, newParent);
+  if (linked == 0) {
+
+    printf ("Error! '%s' waits for a node that would have to finish after it (dependency cycle). OrderMove_N_Tree()\n",
+      Data_N_Tree (tree, node));
+    return false;
+  }
+  if (linked < 0) {
+
+    printf ("Error! The dynamic memory allocation failed. OrderMove_N_Tree()\n");
+    return false;
+  }
+  return true;
+}
+
+// 노드를 해제할 때 양쪽 간선을 모두 지운다
+void ClearDependencies_N_Tree (struct N_TreeType* tree, int id) {
+
+  struct DependencyIndexType* index = tree != NULL ? tree->Dependencies : NULL;
+  struct DependencyListType* list = ListOf (index, id);
+  if (list == NULL) return;
+
+  // 상대 목록에서 먼저 지우고, 비게 된 목록은 내 목록을 치운 뒤에 정리한다 (치우면 목록 자리가 옮겨짐)
+  int count = list->OnCount + list->ByCount;
+  for (int edge = 0; edge < count; edge++) RemoveId (ListOf (index, list->Ids[edge]), id, edge < list->OnCount);
+  index->EdgeCount -= count;
+
+  int* others = list->Ids;
+  list->Ids = NULL;
+  list->OnCount = 0;
+  list->ByCount = 0;
+  DropEmptyList (index, id);
+  for (int edge = 0; edge < count; edge++) DropEmptyList (index, others[edge]);
+  free (others);
+}
+
+size_t DependencyBytes_N_Tree (struct N_TreeType* tree) {
+
+  struct DependencyIndexType* index = tree != NULL ? tree->Dependencies : NULL;
+  if (index == NULL) return 0;
+
+  size_t bytes = sizeof (struct DependencyIndexType) + (size_t) index->Capacity * (2 * sizeof (int) + sizeof (unsigned int)) +
+                 (size_t) index->ListCapacity * sizeof (struct DependencyListType) + (size_t) index->PoolCapacity * sizeof (int) +
+                 (size_t) (index->Forward.Capacity + index->Backward.Capacity + index->Stack.Capacity) * sizeof (struct TreeNodeType*);
+  for (int at = 0; at < index->ListCount; at++) bytes += (size_t) index->Lists[at].Capacity * sizeof (int);
+  return bytes;
+}
+
+void Delete_Dependencies (struct N_TreeType* tree) {
+
+  struct DependencyIndexType* index = tree != NULL ? tree->Dependencies : NULL;
+  if (index == NULL) return;
+
+  for (int at = 0; at < index->ListCount; at++) free (index->Lists[at].Ids);
+  free (index->Lists);
+  free (index->Slots);
+  free (index->Rank);
+  free (index->Visit);
+  free (index->Pool);
+  FreeNodeList (&index->Forward);
+  FreeNodeList (&index->Backward);
+  FreeNodeList (&index->Stack);
+  free (index);
+  tree->Dependencies = NULL;
+}
\ No newline at end of file
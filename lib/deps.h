@@ -0,0 +1,62 @@
+#ifndef _DEPS_H_
+#define _DEPS_H_
+
+#include "n_tree.h"
+
+// 간선이 있는 노드 하나의 목록. Ids 앞쪽 OnCount 칸은 이 노드가 기다리는 노드,
+// 뒤쪽 ByCount 칸은 이 노드를 기다리는 노드의 번호다.
+struct DependencyListType {
+
+  int Id;
+  int OnCount;
+  int ByCount;
+  int Capacity;
+  int* Ids;
+};
+
+// 트리 위에 겹친 의존 간선 ("node 는 on 이 끝난 뒤에 시작").
+// 간선이 있는 노드만 목록을 가지므로 노드마다 드는 것은 번호 표 한 칸과 순위뿐이다.
+//
+// 순위는 트리 간선(자식이 부모보다 먼저)과 의존 간선(on 이 node 보다 먼저)을 함께 만족하는 위상 순서다.
+// 처음 쓸 때 한 번 전체를 정렬하고, 그 뒤로는 간선을 더하거나 노드를 옮길 때 순서가 어긋난 구간만
+// 다시 매긴다 (Pearce-Kelly). 새 노드는 자식이 없으므로 가장 앞 순위를 받는다.
+struct DependencyIndexType {
+
+  int* Slots;          // 노드 번호 -> Lists 칸 (-1 이면 간선 없음)
+  int* Rank;           // 노드 번호 -> 순위 (작을수록 먼저 끝나야 한다)
+  unsigned int* Visit; // 순위를 고칠 때 방문 표시 (Epoch 와 같으면 방문함)
+  int Capacity;        // Slots, Rank, Visit 칸 수
+  struct DependencyListType* Lists;
+  int ListCount;
+  int ListCapacity;
+  long EdgeCount;
+  bool Ordered;        // Rank 가 맞다 (할당에 실패하면 내리고 다음에 전체를 다시 정렬)
+  int Low;             // 지금까지 준 가장 작은/큰 순위
+  int High;
+  unsigned int Epoch;
+  struct NodeListType Forward;    // 순위를 고칠 때 쓰는 작업 목록
+  struct NodeListType Backward;
+  struct NodeListType Stack;
+  int* Pool;
+  int PoolCapacity;
+};
+
+bool AddDependency_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, struct TreeNodeType* on);
+bool RemoveDependency_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, struct TreeNodeType* on);
+const int* DependsOn_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, int* count);
+const int* DependedBy_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, int* count);
+bool HasDependencies_N_Tree (struct N_TreeType* tree, int id);
+long DependencyCount_N_Tree (struct N_TreeType* tree);
+bool TopologicalOrder_N_Tree (struct N_TreeType* tree, struct TreeNodeType* root, struct NodeListType* order);
+int SlotPath_N_Tree (struct TreeNodeType* node, int* slots, int capacity);
+struct TreeNodeType* NodeBySlotPath_N_Tree (struct N_TreeType* tree, const int* slots, int depth);
+unsigned long long SlotPathHash_N_Tree (struct TreeNodeType* node);
+unsigned long long DependencyDigest_N_Tree (struct N_TreeType* tree);
+void OrderNewNode_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node);
+void OrderNewParent_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node);
+bool OrderMove_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, struct TreeNodeType* newParent);
+void ClearDependencies_N_Tree (struct N_TreeType* tree, int id);
+size_t DependencyBytes_N_Tree (struct N_TreeType* tree);
+void Delete_Dependencies (struct N_TreeType* tree);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,505 @@
+#include "diff.h"
+#include "attr.h"
+#include "deps.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void FormatSlotPath (struct TreeNodeType* node, char* out, int outSize) {
+
+  int slots[DIFF_PATH_SIZE];
+  int depth = 0;
+
+  while (node != NULL && node->Parent != NULL && depth < DIFF_PATH_SIZE) {
+
+    slots[depth++] = node->Slot;
+    node = node->Parent;
+  }
+
+  int length = 0;
+  out[0] = '\0';
+  if (depth == 0) snprintf (out, outSize, "/");
+  for (int index = depth - 1; index >= 0 && length < outSize; index--) {
+
+    length += snprintf (out + length, outSize - length, "/%d", slots[index]);
+  }
+}
+
+static bool AppendDiff (struct DiffListType* diff, enum DiffKindType kind, struct TreeNodeType* before, struct TreeNodeType* after) {
+
+  if (diff->Size == diff->Capacity) {
+
+    long capacity = diff->Capacity == 0 ? 64 : diff->Capacity * 2;
+    struct DiffOpType* items = (struct DiffOpType*) realloc (diff->Items, capacity * sizeof (struct DiffOpType));
+    if (items == NULL) return false;
+
+    diff->Items = items;
+    diff->Capacity = capacity;
+  }
+
+  diff->Items[diff->Size].Kind = kind;
+  diff->Items[diff->Size].Before = before;
+  diff->Items[diff->Size].After = after;
+  diff->Size++;
+  return true;
+}
+
+struct HashedNodeType {
+
+  unsigned long long Hash;
+  long Op;  // diff 목록에서의 위치
+};
+
+static int CompareHashed (const void* left, const void* right) {
+
+  const struct HashedNodeType* a = (const struct HashedNodeType*) left;
+  const struct HashedNodeType* b = (const struct HashedNodeType*) right;
+  if (a->Hash != b->Hash) return a->Hash < b->Hash ? -1 : 1;
+  return (a->Op > b->Op) - (a->Op < b->Op);
+}
+
+// 같은 해시의 삭제/삽입 쌍을 이동으로 합친다
+static bool PairMoves (struct DiffListType* diff) {
+
+  long deletes = 0;
+  for (long index = 0; index < diff->Size; index++) {
+
+    if (diff->Items[index].Kind == DIFF_DELETE) deletes++;
+  }
+  if (deletes == 0) return true;
+
+  struct HashedNodeType* table = (struct HashedNodeType*) malloc (deletes * sizeof (struct HashedNodeType));
+  if (table == NULL) return false;
+
+  long count = 0;
+  for (long index = 0; index < diff->Size; index++) {
+
+    if (diff->Items[index].Kind != DIFF_DELETE) continue;
+    table[count].Hash = diff->Items[index].Before->Hash;
+    table[count].Op = index;
+    count++;
+  }
+  qsort (table, count, sizeof (struct HashedNodeType), CompareHashed);
+
+  for (long index = 0; index < diff->Size; index++) {
+
+    struct DiffOpType* insert = &diff->Items[index];
+    if (insert->Kind != DIFF_INSERT) continue;
+
+    unsigned long long hash = insert->After->Hash;
+    long low = 0, high = count;
+    while (low < high) {
+
+      long middle = (low + high) / 2;
+      if (table[middle].Hash < hash) low = middle + 1;
+      else high = middle;
+    }
+
+    // 아직 짝이 정해지지 않은 첫 삭제와 묶는다
+    while (low < count && table[low].Hash == hash && diff->Items[table[low].Op].Kind != DIFF_DELETE) low++;
+    if (low == count || table[low].Hash != hash) continue;
+
+    struct DiffOpType* removal = &diff->Items[table[low].Op];
+    insert->Kind = DIFF_MOVE;
+    insert->Before = removal->Before;
+    removal->Kind = DIFF_MOVE;  // 표시만 해 두고 아래에서 지운다
+    removal->After = NULL;
+  }
+  free (table);
+
+  // 이동의 삭제 쪽 기록 제거
+  long kept = 0;
+  for (long index = 0; index < diff->Size; index++) {
+
+    if (diff->Items[index].Kind == DIFF_MOVE && diff->Items[index].After == NULL) continue;
+    diff->Items[kept++] = diff->Items[index];
+  }
+  diff->Size = kept;
+  return true;
+}
+
+bool Diff_N_Tree (struct N_TreeType* before, struct N_TreeType* after, struct DiffListType* diff) {
+
+  if (before == NULL || after == NULL || diff == NULL || before->Head == NULL || after->Head == NULL) {
+
+    printf ("Error! Invalid arguments. Diff_N_Tree()\n");
+    return false;
+  }
+  if (before->ChildSize != after->ChildSize) {
+
+    printf ("Error! Child sizes differ (%d vs %d). Diff_N_Tree()\n", before->ChildSize, after->ChildSize);
+    return false;
+  }
+
+  struct NodeListType stack = { NULL, 0, 0 };
+
+  // 같은 위치의 노드 쌍을 스택에 번갈아 쌓는다. 머클 해시가 같으면 서브트리 전체를 건너뛴다.
+  bool ok = AppendNodeList (&stack, before->Head) && AppendNodeList (&stack, after->Head);
+
+  while (ok && stack.Size > 0) {
+
+    struct TreeNodeType* right = stack.Items[--stack.Size];
+    struct TreeNodeType* left = stack.Items[--stack.Size];
+
+    if (left->Hash == right->Hash) continue;
+    diff->Compared++;
+
+    if (strcmp (Label_Text (before->Labels, left->Label), Label_Text (after->Labels, right->Label)) != 0) {
+
+      ok = AppendDiff (diff, DIFF_EDIT, left, right);
+    }
+
+    // 두 쪽 중 더 높은 점유 슬롯부터 내려온다
+    int last = LastChildSlot_N_Tree (left) > LastChildSlot_N_Tree (right) ? LastChildSlot_N_Tree (left) : LastChildSlot_N_Tree (right);
+    for (int slot = last; ok && slot >= 0; slot--) {
+
+      struct TreeNodeType* leftChild = ChildAt_N_Tree (left, slot);
+      struct TreeNodeType* rightChild = ChildAt_N_Tree (right, slot);
+
+      if (leftChild != NULL && rightChild != NULL) ok = AppendNodeList (&stack, leftChild) && AppendNodeList (&stack, rightChild);
+      else if (leftChild != NULL) ok = AppendDiff (diff, DIFF_DELETE, leftChild, NULL);
+      else if (rightChild != NULL) ok = AppendDiff (diff, DIFF_INSERT, NULL, rightChild);
+    }
+  }
+
+  if (ok) ok = PairMoves (diff);
+  if (!ok) printf ("Error! The dynamic memory allocation failed. Diff_N_Tree()\n");
+
+  FreeNodeList (&stack);
+  return ok;
+}
+
+void FreeDiffList (struct DiffListType* diff) {
+
+  if (diff == NULL) return;
+
+  free (diff->Items);
+  diff->Items = NULL;
+  diff->Size = 0;
+  diff->Capacity = 0;
+  diff->Compared = 0;
+}
+
+// 노드 번호 -> 자기 속성과 서브트리 속성의 요약 값 (속성이 없는 트리는 둘 다 NULL, 값은 0 으로 본다)
+struct MergeDigestType {
+
+  unsigned long long* Own;
+  unsigned long long* Subtree;
+};
+
+struct MergeContextType {
+
+  struct N_TreeType* Base;
+  struct N_TreeType* Ours;
+  struct N_TreeType* Theirs;
+  struct N_TreeType* Result;
+  struct MergeConflictListType* Conflicts;
+  bool Failed;
+  struct MergeDigestType BaseDigest;
+  struct MergeDigestType OurDigest;
+  struct MergeDigestType TheirDigest;
+};
+
+static unsigned long long MixDigest (unsigned long long value) {
+
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdULL;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ULL;
+  value ^= value >> 33;
+  return value;
+}
+
+static unsigned long long DigestSubtree (struct N_TreeType* tree, struct TreeNodeType* node, struct MergeDigestType* digest) {
+
+  unsigned long long sum = digest->Own[node->Id] = NodeAttributeDigest_N_Tree (tree, node->Id);
+  FOR_EACH_CHILD_SLOT (node, slot) {
+
+    // 속성이 없는 서브트리는 0 으로 두고, 값이 있으면 슬롯과 섞어 위치가 바뀐 값도 다르게 센다
+    unsigned long long child = DigestSubtree (tree, node->Children[slot], digest);
+    if (child != 0) sum += MixDigest (child ^ ((unsigned long long) slot + 1) * 0x9e3779b97f4a7c15ULL);
+  }
+  return digest->Subtree[node->Id] = sum;
+}
+
+// Merkle 해시에는 속성이 들어 있지 않으므로 노드마다 속성 요약 값을 따로 구해 둔다
+static bool DigestAttributes (struct N_TreeType* tree, struct MergeDigestType* digest) {
+
+  digest->Own = NULL;
+  digest->Subtree = NULL;
+  if (AttributeDigest_N_Tree (tree) == 0) return true;
+
+  digest->Own = (unsigned long long*) calloc (tree->NextId, sizeof (unsigned long long));
+  digest->Subtree = (unsigned long long*) calloc (tree->NextId, sizeof (unsigned long long));
+  if (digest->Own == NULL || digest->Subtree == NULL) return false;
+
+  DigestSubtree (tree, tree->Head, digest);
+  return true;
+}
+
+static void FreeDigest (struct MergeDigestType* digest) {
+
+  free (digest->Own);
+  free (digest->Subtree);
+}
+
+static unsigned long long OwnDigest (struct MergeDigestType* digest, struct TreeNodeType* node) {
+
+  return node == NULL || digest->Own == NULL ? 0 : digest->Own[node->Id];
+}
+
+static void AddConflict (struct MergeContextType* merge, const char* path, const char* format, ...) {
+
+  struct MergeConflictListType* conflicts = merge->Conflicts;
+  conflicts->Total++;
+  if (conflicts->Size == MERGE_MAX_CONFLICTS) return;
+
+  struct MergeConflictType* conflict = &conflicts->Items[conflicts->Size++];
+  snprintf (conflict->Path, sizeof (conflict->Path), "%s", path[0] == '\0' ? "/" : path);
+
+  va_list args;
+  va_start (args, format);
+  vsnprintf (conflict->Message, sizeof (conflict->Message), format, args);
+  va_end (args);
+}
+
+// parent 의 slot 에 노드 하나를 만들고 source 의 sourceNode 속성을 복사한다 (parent 가 NULL 이면 결과 트리의 루트)
+static struct TreeNodeType* PlaceNode (struct MergeContextType* merge, struct TreeNodeType* parent, int slot,
+                                       const char* data, struct N_TreeType* source, struct TreeNodeType* sourceNode) {
+
+  struct N_TreeType* result = merge->Result;
+  struct TreeNodeType* node;
+
+  if (parent == NULL) {
+
+    node = result->Head;
+    if (!SetData_N_Tree (result, node, data)) node = NULL;
+  } else {
+
+    Insert_ChildNode_N_Tree (result, parent, (char*) data, slot);
+    node = ChildAt_N_Tree (parent, slot);
+  }
+
+  if (node == NULL || !CopyAttributes_N_Tree (result, node, source, sourceNode)) {
+
+    merge->Failed = true;
+    return NULL;
+  }
+  return node;
+}
+
+static void CopySubtree (struct MergeContextType* merge, struct TreeNodeType* parent, int slot, struct N_TreeType* source, struct TreeNodeType* node) {
+
+  if (node == NULL || merge->Failed) return;
+
+  struct TreeNodeType* copy = PlaceNode (merge, parent, slot, Label_Text (source->Labels, node->Label), source, node);
+  if (copy == NULL) return;
+
+  FOR_EACH_CHILD_SLOT (node, index) {
+
+    CopySubtree (merge, copy, index, source, node->Children[index]);
+  }
+}
+
+// 해시와 속성 요약 값이 모두 같아야 같은 서브트리다
+static bool SameSubtree (struct TreeNodeType* left, struct MergeDigestType* leftDigest, struct TreeNodeType* right, struct MergeDigestType* rightDigest) {
+
+  if (left == NULL || right == NULL) return left == right;
+  if (left->Hash != right->Hash) return false;
+
+  unsigned long long leftAttributes = leftDigest->Subtree != NULL ? leftDigest->Subtree[left->Id] : 0;
+  unsigned long long rightAttributes = rightDigest->Subtree != NULL ? rightDigest->Subtree[right->Id] : 0;
+  return leftAttributes == rightAttributes;
+}
+
+// 슬롯 위치마다 base/ours/theirs 를 비교한다. 한쪽만 바뀐 서브트리는 그대로 가져오고, 양쪽이 바뀌었으면 내려가며 합친다.
+static void MergeNodes (struct MergeContextType* merge, struct TreeNodeType* base, struct TreeNodeType* ours, struct TreeNodeType* theirs,
+                        struct TreeNodeType* parent, int slot, char* path, int pathLength) {
+
+  if (merge->Failed) return;
+
+  if (SameSubtree (ours, &merge->OurDigest, theirs, &merge->TheirDigest) || SameSubtree (base, &merge->BaseDigest, theirs, &merge->TheirDigest)) {
+
+    CopySubtree (merge, parent, slot, merge->Ours, ours);
+    return;
+  }
+  if (SameSubtree (base, &merge->BaseDigest, ours, &merge->OurDigest)) {
+
+    CopySubtree (merge, parent, slot, merge->Theirs, theirs);
+    return;
+  }
+
+  // 양쪽 모두 바뀜
+  if (ours == NULL || theirs == NULL) {
+
+    AddConflict (merge, path, ours == NULL ? "deleted in ours, modified in theirs (kept deletion)"
+                                           : "modified in ours, deleted in theirs (kept ours)");
+    CopySubtree (merge, parent, slot, merge->Ours, ours);
+    return;
+  }
+
+  const char* baseData = base == NULL ? NULL : Label_Text (merge->Base->Labels, base->Label);
+  const char* ourData = Label_Text (merge->Ours->Labels, ours->Label);
+  const char* theirData = Label_Text (merge->Theirs->Labels, theirs->Label);
+  const char* data = ourData;
+
+  if (strcmp (ourData, theirData) != 0) {
+
+    if (baseData != NULL && strcmp (baseData, ourData) == 0) data = theirData;
+    else if (baseData == NULL || strcmp (baseData, theirData) != 0) {
+
+      AddConflict (merge, path, base == NULL ? "added '%.40s' in ours and '%.40s' in theirs (kept ours)"
+                                             : "edited to '%.40s' in ours and '%.40s' in theirs (kept ours)", ourData, theirData);
+    }
+  }
+
+  // 노드 자신의 속성도 한쪽만 바꿨으면 그쪽을 가져온다
+  struct N_TreeType* source = merge->Ours;
+  struct TreeNodeType* sourceNode = ours;
+  unsigned long long ourAttributes = OwnDigest (&merge->OurDigest, ours);
+  unsigned long long theirAttributes = OwnDigest (&merge->TheirDigest, theirs);
+  if (ourAttributes != theirAttributes) {
+
+    unsigned long long baseAttributes = OwnDigest (&merge->BaseDigest, base);
+    if (base != NULL && baseAttributes == ourAttributes) {
+
+      source = merge->Theirs;
+      sourceNode = theirs;
+    } else if (base == NULL || baseAttributes != theirAttributes) {
+
+      AddConflict (merge, path, "attributes changed in ours and theirs (kept ours)");
+    }
+  }
+
+  struct TreeNodeType* node = PlaceNode (merge, parent, slot, data, source, sourceNode);
+  if (node == NULL) return;
+
+  int last = LastChildSlot_N_Tree (ours) > LastChildSlot_N_Tree (theirs) ? LastChildSlot_N_Tree (ours) : LastChildSlot_N_Tree (theirs);
+  if (base != NULL && LastChildSlot_N_Tree (base) > last) last = LastChildSlot_N_Tree (base);
+  for (int index = 0; index <= last; index++) {
+
+    int length = pathLength + snprintf (path + pathLength, DIFF_PATH_SIZE - pathLength, "/%d", index);
+    if (length >= DIFF_PATH_SIZE) length = DIFF_PATH_SIZE - 1;
+
+    MergeNodes (merge, base == NULL ? NULL : ChildAt_N_Tree (base, index), ChildAt_N_Tree (ours, index), ChildAt_N_Tree (theirs, index),
+                node, index, path, length);
+    path[pathLength] = '\0';
+  }
+}
+
+// node 와 같은 슬롯 경로에 있는 target 의 노드 (없으면 NULL)
+static struct TreeNodeType* Counterpart (struct N_TreeType* target, struct TreeNodeType* node) {
+
+  if (node->Parent == NULL) return target->Head;
+
+  struct TreeNodeType* parent = Counterpart (target, node->Parent);
+  return parent == NULL ? NULL : ChildAt_N_Tree (parent, node->Slot);
+}
+
+static bool HasEdge (struct N_TreeType* tree, struct TreeNodeType* node, struct TreeNodeType* on) {
+
+  if (node == NULL || on == NULL) return false;
+
+  int count;
+  const int* ids = DependsOn_N_Tree (tree, node, &count);
+  for (int edge = 0; edge < count; edge++) {
+
+    if (ids[edge] == on->Id) return true;
+  }
+  return false;
+}
+
+// source 의 간선 node -> on 을 결과 트리의 같은 위치에 더한다. 끝이 없어졌거나 순환이 생기면 충돌로 남긴다.
+static void PlaceEdge (struct MergeContextType* merge, struct TreeNodeType* node, struct TreeNodeType* on) {
+
+  struct TreeNodeType* from = Counterpart (merge->Result, node);
+  struct TreeNodeType* to = Counterpart (merge->Result, on);
+  if (from != NULL && to != NULL && HasEdge (merge->Result, from, to)) return;
+
+  char path[DIFF_PATH_SIZE];
+  char onPath[DIFF_PATH_SIZE];
+  FormatSlotPath (node, path, sizeof (path));
+  FormatSlotPath (on, onPath, sizeof (onPath));
+
+  if (from == NULL || to == NULL) {
+
+    AddConflict (merge, path, "dependency on %.60s dropped (node is gone after the merge)", onPath[0] == '\0' ? "/" : onPath);
+  } else if (!AddDependency_N_Tree (merge->Result, from, to)) {
+
+    AddConflict (merge, path, "dependency on %.60s dropped (it would form a cycle)", onPath[0] == '\0' ? "/" : onPath);
+  }
+}
+
+// 간선은 슬롯 경로로 맞춘다: theirs 가 지운 간선을 뺀 ours 의 간선에 theirs 가 더한 간선을 더한다
+static void MergeDependencies (struct MergeContextType* merge) {
+
+  struct DependencyIndexType* ours = DependencyCount_N_Tree (merge->Ours) > 0 ? merge->Ours->Dependencies : NULL;
+  for (int at = 0; ours != NULL && at < ours->ListCount; at++) {
+
+    const struct DependencyListType* list = &ours->Lists[at];
+    struct TreeNodeType* node = merge->Ours->Nodes[list->Id];
+    for (int edge = 0; edge < list->OnCount; edge++) {
+
+      struct TreeNodeType* on = merge->Ours->Nodes[list->Ids[edge]];
+      bool removed = HasEdge (merge->Base, Counterpart (merge->Base, node), Counterpart (merge->Base, on)) &&
+                     !HasEdge (merge->Theirs, Counterpart (merge->Theirs, node), Counterpart (merge->Theirs, on));
+      if (!removed) PlaceEdge (merge, node, on);
+    }
+  }
+
+  struct DependencyIndexType* theirs = DependencyCount_N_Tree (merge->Theirs) > 0 ? merge->Theirs->Dependencies : NULL;
+  for (int at = 0; theirs != NULL && at < theirs->ListCount; at++) {
+
+    const struct DependencyListType* list = &theirs->Lists[at];
+    struct TreeNodeType* node = merge->Theirs->Nodes[list->Id];
+    for (int edge = 0; edge < list->OnCount; edge++) {
+
+      struct TreeNodeType* on = merge->Theirs->Nodes[list->Ids[edge]];
+      if (!HasEdge (merge->Base, Counterpart (merge->Base, node), Counterpart (merge->Base, on))) PlaceEdge (merge, node, on);
+    }
+  }
+}
+
+struct N_TreeType* Merge_N_Tree (struct N_TreeType* base, struct N_TreeType* ours, struct N_TreeType* theirs, struct MergeConflictListType* conflicts) {
+
+  if (base == NULL || ours == NULL || theirs == NULL || conflicts == NULL) {
+
+    printf ("Error! Invalid arguments. Merge_N_Tree()\n");
+    return NULL;
+  }
+  if (base->ChildSize != ours->ChildSize || ours->ChildSize != theirs->ChildSize) {
+
+    printf ("Error! Child sizes differ (%d, %d, %d). Merge_N_Tree()\n", base->ChildSize, ours->ChildSize, theirs->ChildSize);
+    return NULL;
+  }
+
+  conflicts->Size = 0;
+  conflicts->Total = 0;
+
+  struct MergeContextType merge = { base, ours, theirs, NULL, conflicts, false, { NULL, NULL }, { NULL, NULL }, { NULL, NULL } };
+  merge.Result = Create_N_Tree (ours->ChildSize);
+
+  if (merge.Result != NULL && DigestAttributes (base, &merge.BaseDigest) && DigestAttributes (ours, &merge.OurDigest) &&
+      DigestAttributes (theirs, &merge.TheirDigest)) {
+
+    char path[DIFF_PATH_SIZE] = "";
+    merge.Result->Count = 1;
+    MergeNodes (&merge, base->Head, ours->Head, theirs->Head, NULL, 0, path, 0);
+    if (!merge.Failed) MergeDependencies (&merge);
+  } else {
+
+    merge.Failed = true;
+  }
+  FreeDigest (&merge.BaseDigest);
+  FreeDigest (&merge.OurDigest);
+  FreeDigest (&merge.TheirDigest);
+
+  if (merge.Failed) {
+
+    printf ("Error! The dynamic memory allocation failed. Merge_N_Tree()\n");
+    Delete_N_Tree (merge.Result);
+    return NULL;
+  }
+  return merge.Result;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef _DIFF_H_
+#define _DIFF_H_
+
+#include "n_tree.h"
+
+#define MERGE_MAX_CONFLICTS 100
+#define DIFF_PATH_SIZE 128
+
+// 두 트리의 차이. 노드는 슬롯 위치로 대응시키며, 같은 서브트리가 다른 위치로 옮겨졌으면 MOVE 로 묶는다.
+enum DiffKindType { DIFF_INSERT, DIFF_DELETE, DIFF_EDIT, DIFF_MOVE };
+
+struct DiffOpType {
+
+  enum DiffKindType Kind;
+  struct TreeNodeType* Before;  // 이전 트리의 노드 (INSERT 는 NULL)
+  struct TreeNodeType* After;   // 새 트리의 노드 (DELETE 는 NULL)
+};
+
+struct DiffListType {
+
+  struct DiffOpType* Items;
+  long Size;
+  long Capacity;
+  long Compared;  // 해시가 달라 실제로 비교한 노드 쌍 수
+};
+
+struct MergeConflictType {
+
+  char Path[DIFF_PATH_SIZE];    // 슬롯 경로 ("/0/2")
+  char Message[128];
+};
+
+struct MergeConflictListType {
+
+  struct MergeConflictType Items[MERGE_MAX_CONFLICTS];
+  int Size;   // 기록된 충돌 수
+  int Total;  // 전체 충돌 수 (Size 를 넘을 수 있음)
+};
+
+bool Diff_N_Tree (struct N_TreeType* before, struct N_TreeType* after, struct DiffListType* diff);
+void FreeDiffList (struct DiffListType* diff);
+struct N_TreeType* Merge_N_Tree (struct N_TreeType* base, struct N_TreeType* ours, struct N_TreeType* theirs, struct MergeConflictListType* conflicts);
+void FormatSlotPath (struct TreeNodeType* node, char* out, int outSize);
+
+#endif
\ No newline at end of file
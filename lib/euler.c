@@ -0,0 +1,239 @@
+#include "euler.h"
+#include "pager.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// 읽기 연산은 색인이 최신일 때만 번호를 쓰고, 아니면 다시 매기지 않고 부모를 따라가거나 서브트리만 센다.
+// 편집 뒤 첫 질의가 트리 전체를 훑거나 지연 로딩 트리를 모두 읽지 않게 하려는 것이다.
+static bool Indexed (struct N_TreeType* tree) {
+
+  return tree != NULL && tree->Euler != NULL && tree->Euler->Valid;
+}
+
+static int CountDepth (struct TreeNodeType* node) {
+
+  int depth = 0;
+  for (node = node->Parent; node != NULL; node = node->Parent) depth++;
+  return depth;
+}
+
+// 읽지 않은 서브트리는 조각에 기록된 크기를 쓴다
+static int CountSubtree (struct N_TreeType* tree, struct TreeNodeType* node) {
+
+  if (node->Paged) return PagedSize_N_Tree (tree, node);
+
+  int count = 1;
+  FOR_EACH_CHILD_SLOT (node, slot) {
+
+    count += CountSubtree (tree, node->Children[slot]);
+  }
+  return count;
+}
+
+bool Renumber_N_Tree (struct N_TreeType* tree) {
+
+  if (tree == NULL || tree->Head == NULL) {
+
+    printf ("Error! N_TreeType pointer is NULL. Renumber_N_Tree()\n");
+    return false;
+  }
+
+  // 번호는 트리 전체가 있어야 매길 수 있다
+  if (tree->Pager != NULL && !LoadAll_N_Tree (tree)) return false;
+
+  struct EulerIndexType* index = tree->Euler;
+  if (index == NULL) {
+
+    index = (struct EulerIndexType*) calloc (1, sizeof (struct EulerIndexType));
+    if (index == NULL) {
+
+      printf ("Error! The dynamic memory allocation failed. Renumber_N_Tree()\n");
+      return false;
+    }
+    tree->Euler = index;
+  }
+  index->Valid = false;
+
+  // 전위 순서 배열을 스택으로도 쓴다: 앞쪽은 확정된 순서, 뒤쪽은 방문 대기
+  int capacity = tree->Count > 0 ? tree->Count + 1 : 64;
+  struct TreeNodeType** order = (struct TreeNodeType**) realloc (index->Order, capacity * sizeof (struct TreeNodeType*));
+  if (order == NULL) {
+
+    printf ("Error! The dynamic memory allocation failed(2). Renumber_N_Tree()\n");
+    return false;
+  }
+  index->Order = order;
+
+  struct TreeNodeType** stack = (struct TreeNodeType**) malloc (capacity * sizeof (struct TreeNodeType*));
+  if (stack == NULL) {
+
+    printf ("Error! The dynamic memory allocation failed(3). Renumber_N_Tree()\n");
+    return false;
+  }
+
+  int stackCapacity = capacity;
+  int top = 0;
+  int size = 0;
+  stack[top++] = tree->Head;
+  tree->Head->Depth = 0;
+
+  while (top > 0) {
+
+    struct TreeNodeType* node = stack[--top];
+
+    if (size == capacity) {
+
+      capacity *= 2;
+      order = (struct TreeNodeType**) realloc (index->Order, capacity * sizeof (struct TreeNodeType*));
+      if (order == NULL) {
+
+        printf ("Error! The dynamic memory allocation failed(2). Renumber_N_Tree()\n");
+        free (stack);
+        return false;
+      }
+      index->Order = order;
+    }
+
+    node->Entry = size;
+    node->Exit = size + 1;
+    index->Order[size++] = node;
+
+    FOR_EACH_CHILD_SLOT_REVERSE (node, slot) {
+
+      struct TreeNodeType* child = node->Children[slot];
+
+      if (top == stackCapacity) {
+
+        stackCapacity *= 2;
+        struct TreeNodeType** grown = (struct TreeNodeType**) realloc (stack, stackCapacity * sizeof (struct TreeNodeType*));
+        if (grown == NULL) {
+
+          printf ("Error! The dynamic memory allocation failed(3). Renumber_N_Tree()\n");
+          free (stack);
+          return false;
+        }
+        stack = grown;
+      }
+      child->Depth = node->Depth + 1;
+      stack[top++] = child;
+    }
+  }
+  free (stack);
+
+  // 역순으로 훑으며 자식의 탈출 번호를 부모에게 올린다
+  for (int entry = size - 1; entry > 0; entry--) {
+
+    struct TreeNodeType* node = index->Order[entry];
+    if (node->Exit > node->Parent->Exit) node->Parent->Exit = node->Exit;
+  }
+
+  int levels = 1;
+  while ((1 << levels) < size) levels++;
+
+  int* jump = (int*) realloc (index->Jump, (size_t) levels * size * sizeof (int));
+  if (jump == NULL) {
+
+    printf ("Error! The dynamic memory allocation failed(4). Renumber_N_Tree()\n");
+    return false;
+  }
+  index->Jump = jump;
+
+  for (int entry = 0; entry < size; entry++) {
+
+    struct TreeNodeType* parent = index->Order[entry]->Parent;
+    jump[entry] = parent == NULL ? -1 : parent->Entry;
+  }
+  for (int level = 1; level < levels; level++) {
+
+    int* previous = jump + (size_t) (level - 1) * size;
+    int* current = jump + (size_t) level * size;
+    for (int entry = 0; entry < size; entry++) {
+
+      current[entry] = previous[entry] < 0 ? -1 : previous[previous[entry]];
+    }
+  }
+
+  index->Size = size;
+  index->Levels = levels;
+  index->Valid = true;
+  return true;
+}
+
+bool IsAncestor_N_Tree (struct N_TreeType* tree, struct TreeNodeType* ancestor, struct TreeNodeType* node) {
+
+  if (ancestor == NULL || node == NULL) return false;
+  if (Indexed (tree)) return ancestor->Entry <= node->Entry && node->Exit <= ancestor->Exit;
+
+  for (; node != NULL; node = node->Parent) {
+
+    if (node == ancestor) return true;
+  }
+  return false;
+}
+
+int SubtreeSize_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node) {
+
+  if (node == NULL) return 0;
+  if (Indexed (tree)) return node->Exit - node->Entry;
+
+  return CountSubtree (tree, node);
+}
+
+int Depth_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node) {
+
+  if (node == NULL) return -1;
+  if (Indexed (tree)) return node->Depth;
+
+  return CountDepth (node);
+}
+
+struct TreeNodeType* LowestCommonAncestor_N_Tree (struct N_TreeType* tree, struct TreeNodeType* first, struct TreeNodeType* second) {
+
+  if (first == NULL || second == NULL) return NULL;
+  if (!Indexed (tree)) {
+
+    // 색인 없이: 깊은 쪽을 같은 깊이까지 올린 뒤 둘을 함께 올린다
+    int firstDepth = CountDepth (first);
+    int secondDepth = CountDepth (second);
+    for (; firstDepth > secondDepth; firstDepth--) first = first->Parent;
+    for (; secondDepth > firstDepth; secondDepth--) second = second->Parent;
+    while (first != second) {
+
+      first = first->Parent;
+      second = second->Parent;
+    }
+    return first;
+  }
+
+  if (IsAncestor_N_Tree (tree, first, second)) return first;
+  if (IsAncestor_N_Tree (tree, second, first)) return second;
+
+  struct EulerIndexType* index = tree->Euler;
+  int entry = first->Entry;
+
+  // second 를 포함하지 않는 가장 높은 조상까지 2^k 씩 올라간다
+  for (int level = index->Levels - 1; level >= 0; level--) {
+
+    int up = index->Jump[(size_t) level * index->Size + entry];
+    if (up < 0) continue;
+    if (!IsAncestor_N_Tree (tree, index->Order[up], second)) entry = up;
+  }
+
+  return index->Order[entry]->Parent;
+}
+
+void Invalidate_Euler_Index (struct N_TreeType* tree) {
+
+  if (tree == NULL || tree->Euler == NULL) return;
+  tree->Euler->Valid = false;
+}
+
+void Delete_Euler_Index (struct N_TreeType* tree) {
+
+  if (tree == NULL || tree->Euler == NULL) return;
+
+  free (tree->Euler->Jump);
+  free (tree->Euler->Order);
+  free (tree->Euler);
+  tree->Euler = NULL;
+}
@@ -0,0 +1,26 @@
+#ifndef _EULER_H_
+#define _EULER_H_
+
+#include "n_tree.h"
+
+// 전위 진입/탈출 번호와 이진 올림(binary lifting) 표.
+// 트리가 바뀌면 Valid 만 내려 둔다. 번호는 저장처럼 트리 전체를 훑는 연산이 Renumber_N_Tree 로 다시 매기고,
+// 그 사이의 질의는 부모 포인터와 서브트리 순회로 답한다 (지연 로딩 트리를 모두 읽지 않음).
+struct EulerIndexType {
+
+  bool Valid;
+  int Size;                     // 번호가 매겨진 노드 수
+  int Levels;                   // Jump 표의 높이 (2^Levels >= Size)
+  int* Jump;                    // Jump[k * Size + e] = e 의 2^k 번째 조상 번호 (-1 이면 없음)
+  struct TreeNodeType** Order;  // 진입 번호 -> 노드
+};
+
+bool Renumber_N_Tree (struct N_TreeType* tree);
+bool IsAncestor_N_Tree (struct N_TreeType* tree, struct TreeNodeType* ancestor, struct TreeNodeType* node);
+int SubtreeSize_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node);
+int Depth_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node);
+struct TreeNodeType* LowestCommonAncestor_N_Tree (struct N_TreeType* tree, struct TreeNodeType* first, struct TreeNodeType* second);
+void Invalidate_Euler_Index (struct N_TreeType* tree);
+void Delete_Euler_Index (struct N_TreeType* tree);
+
+#endif
@@ -0,0 +1,430 @@
+#include "fixed.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// 반복 횟수가 상수인 슬롯 반복문을 끝까지 풀도록 컴파일러에 알린다
+#if defined (__GNUC__) && !defined (__clang__)
+#define FIXED_UNROLL _Pragma ("GCC unroll 8")
+#elif defined (__clang__)
+#define FIXED_UNROLL _Pragma ("clang loop unroll(full)")
+#else
+#define FIXED_UNROLL
+#endif
+
+// 깊이 우선 순회용 스택 (노드 포인터와 깊이). 모든 특수화가 같이 쓴다.
+struct FixedFrameType {
+
+  void* Node;
+  int Depth;
+};
+
+struct FixedStackType {
+
+  struct FixedFrameType* Items;
+  int Size;
+  int Capacity;
+};
+
+static bool PushFixedStack (struct FixedStackType* stack, void* node, int depth) {
+
+  if (stack->Size == stack->Capacity) {
+
+    int capacity = stack->Capacity == 0 ? 64 : stack->Capacity * 2;
+    struct FixedFrameType* items = (struct FixedFrameType*) realloc (stack->Items, capacity * sizeof (struct FixedFrameType));
+    if (items == NULL) return false;
+
+    stack->Items = items;
+    stack->Capacity = capacity;
+  }
+  stack->Items[stack->Size].Node = node;
+  stack->Items[stack->Size++].Depth = depth;
+  return true;
+}
+
+#define FIXED_N_TREE_DEFINE(N) \
+\
+static struct Fixed##N##_NodeType* MakeFixed##N##Node (struct Fixed##N##_N_TreeType* tree, struct Fixed##N##_NodeType* parent, const char* data) { \
+\
+  LabelType label = Intern_Label (tree->Labels, data); \
+  if (label == LABEL_NONE) return NULL; \
+\
+  struct Fixed##N##_NodeType* node = (struct Fixed##N##_NodeType*) calloc (1, sizeof (struct Fixed##N##_NodeType)); \
+  if (node == NULL) { \
+\
+    printf ("Error! The dynamic memory allocation failed. Fixed" #N "_N_Tree\n"); \
+    return NULL; \
+  } \
+  node->Label = label; \
+  node->Parent = parent; \
+  return node; \
+} \
+\
+struct Fixed##N##_N_TreeType* Create_Fixed##N##_N_Tree (void) { \
+\
+  struct Fixed##N##_N_TreeType* tree = (struct Fixed##N##_N_TreeType*) calloc (1, sizeof (struct Fixed##N##_N_TreeType)); \
+  if (tree == NULL) { \
+\
+    printf ("Error! The dynamic memory allocation failed. Create_Fixed" #N "_N_Tree()\n"); \
+    return NULL; \
+  } \
+  tree->Labels = Create_Label_Pool (); \
+  if (tree->Labels != NULL) tree->Head = MakeFixed##N##Node (tree, NULL, ""); \
+  if (tree->Head == NULL) { \
+\
+    Delete_Label_Pool (tree->Labels); \
+    free (tree); \
+    return NULL; \
+  } \
+  tree->Count = 1; \
+  return tree; \
+} \
+\
+struct Fixed##N##_NodeType* Insert_ChildNode_Fixed##N##_N_Tree (struct Fixed##N##_N_TreeType* tree, struct Fixed##N##_NodeType* parent, const char* data, int position) { \
+\
+  if (tree == NULL || parent == NULL || data == NULL) { \
+\
+    printf ("Error! Invalid arguments. Insert_ChildNode_Fixed" #N "_N_Tree()\n"); \
+    return NULL; \
+  } \
+  if (position < 0 || position >= N) { \
+\
+    printf ("Error! position %d is out of range (0 ~ %d). Insert_ChildNode_Fixed" #N "_N_Tree()\n", position, N - 1); \
+    return NULL; \
+  } \
+  if (parent->Children[position] != NULL) { \
+\
+    printf ("Error! Position %d is already occupied. Insert_ChildNode_Fixed" #N "_N_Tree()\n", position); \
+    return NULL; \
+  } \
+\
+  struct Fixed##N##_NodeType* node = MakeFixed##N##Node (tree, parent, data); \
+  if (node == NULL) return NULL; \
+\
+  parent->Children[position] = node; \
+  tree->Count++; \
+  return node; \
+} \
+\
+struct Fixed##N##_NodeType* Access_Fixed##N##_N_Tree (struct Fixed##N##_N_TreeType* tree, struct Fixed##N##_NodeType* parent, int position) { \
+\
+  if (tree == NULL || parent == NULL || position < 0 || position >= N) return NULL; \
+  return parent->Children[position]; \
+} \
+\
+const char* Data_Fixed##N##_N_Tree (struct Fixed##N##_N_TreeType* tree, struct Fixed##N##_NodeType* node) { \
+\
+  if (tree == NULL || node == NULL) return NULL; \
+  return Label_Text (tree->Labels, node->Label); \
+} \
+\
+int ChildCount_Fixed##N##_N_Tree (struct Fixed##N##_NodeType* node) { \
+\
+  int count = 0; \
+  FIXED_UNROLL \
+  for (int slot = 0; slot < N; slot++) count += node->Children[slot] != NULL; \
+  return count; \
+} \
+\
+/* 높이와 리프 수를 한 번에 센다 (실패하면 -1) */ \
+static int MeasureFixed##N (struct Fixed##N##_N_TreeType* tree, int* leaves) { \
+\
+  struct FixedStackType stack = { NULL, 0, 0 }; \
+  int height = 0; \
+  *leaves = 0; \
+  if (!PushFixedStack (&stack, tree->Head, 1)) return -1; \
+\
+  while (stack.Size > 0) { \
+\
+    struct FixedFrameType frame = stack.Items[--stack.Size]; \
+    struct Fixed##N##_NodeType* node = (struct Fixed##N##_NodeType*) frame.Node; \
+    if (frame.Depth > height) height = frame.Depth; \
+\
+    int children = 0; \
+    FIXED_UNROLL \
+    for (int slot = 0; slot < N; slot++) { \
+\
+      if (node->Children[slot] == NULL) continue; \
+      children++; \
+      if (!PushFixedStack (&stack, node->Children[slot], frame.Depth + 1)) { \
+\
+        free (stack.Items); \
+        return -1; \
+      } \
+    } \
+    if (children == 0) (*leaves)++; \
+  } \
+  free (stack.Items); \
+  return height; \
+} \
+\
+int Height_Fixed##N##_N_Tree (struct Fixed##N##_N_TreeType* tree) { \
+\
+  if (tree == NULL || tree->Head == NULL) return 0; \
+  int leaves; \
+  return MeasureFixed##N (tree, &leaves); \
+} \
+\
+int CountLeaves_Fixed##N##_N_Tree (struct Fixed##N##_N_TreeType* tree) { \
+\
+  if (tree == NULL || tree->Head == NULL) return 0; \
+  int leaves; \
+  return MeasureFixed##N (tree, &leaves) < 0 ? -1 : leaves; \
+} \
+\
+/* 부모 포인터를 따라 아래에서부터 해제한다 (재귀나 추가 할당 없음). node 는 이미 부모에서 떼어 낸 상태 */ \
+static int ClearFixed##N##Subtree (struct Fixed##N##_NodeType* node) { \
+\
+  struct Fixed##N##_NodeType* stop = node->Parent; \
+  struct Fixed##N##_NodeType* current = node; \
+  int count = 0; \
+\
+  while (current != stop) { \
+\
+    struct Fixed##N##_NodeType* next = NULL; \
+    FIXED_UNROLL \
+    for (int slot = 0; slot < N; slot++) { \
+\
+      if (next == NULL) next = current->Children[slot]; \
+    } \
+    if (next != NULL) { \
+\
+      current = next; \
+      continue; \
+    } \
+\
+    struct Fixed##N##_NodeType* parent = current->Parent; \
+    if (parent != stop) { \
+\
+      FIXED_UNROLL \
+      for (int slot = 0; slot < N; slot++) { \
+\
+        if (parent->Children[slot] == current) parent->Children[slot] = NULL; \
+      } \
+    } \
+    free (current); \
+    count++; \
+    current = parent; \
+  } \
+  return count; \
+} \
+\
+/* 서브트리를 부모에서 떼어 내고 해제한다 (루트를 주면 트리가 비므로 Delete 를 쓴다) */ \
+void Clear_Fixed##N##_N_Tree (struct Fixed##N##_N_TreeType* tree, struct Fixed##N##_NodeType* node) { \
+\
+  if (tree == NULL || node == NULL || node == tree->Head) return; \
+\
+  FIXED_UNROLL \
+  for (int slot = 0; slot < N; slot++) { \
+\
+    if (node->Parent->Children[slot] == node) node->Parent->Children[slot] = NULL; \
+  } \
+  tree->Count -= ClearFixed##N##Subtree (node); \
+} \
+\
+void Delete_Fixed##N##_N_Tree (struct Fixed##N##_N_TreeType* tree) { \
+\
+  if (tree == NULL) return; \
+\
+  ClearFixed##N##Subtree (tree->Head); \
+  Delete_Label_Pool (tree->Labels); \
+  free (tree); \
+} \
+\
+/* 실행 시간 트리를 복사한다. N 이상의 슬롯에 자식이 있으면 NULL */ \
+struct Fixed##N##_N_TreeType* Convert_Fixed##N##_N_Tree (struct N_TreeType* tree) { \
+\
+  if (tree == NULL || tree->Head == NULL) { \
+\
+    printf ("Error! N_TreeType pointer is NULL. Convert_Fixed" #N "_N_Tree()\n"); \
+    return NULL; \
+  } \
+\
+  struct Fixed##N##_N_TreeType* fixed = Create_Fixed##N##_N_Tree (); \
+  if (fixed == NULL) return NULL; \
+  fixed->Head->Label = Intern_Label (fixed->Labels, Data_N_Tree (tree, tree->Head)); \
+\
+  /* 원본 노드와 복사본을 번갈아 쌓는다 */ \
+  struct FixedStackType stack = { NULL, 0, 0 }; \
+  bool ok = PushFixedStack (&stack, tree->Head, 0) && PushFixedStack (&stack, fixed->Head, 0); \
+\
+  while (ok && stack.Size > 0) { \
+\
+    struct Fixed##N##_NodeType* copy = (struct Fixed##N##_NodeType*) stack.Items[--stack.Size].Node; \
+    struct TreeNodeType* node = (struct TreeNodeType*) stack.Items[--stack.Size].Node; \
+\
+    FOR_EACH_CHILD_SLOT (node, slot) { \
+\
+      struct TreeNodeType* child = node->Children[slot]; \
+      if (!ok) continue; \
+      if (slot >= N) { \
+\
+        ok = false; \
+        continue; \
+      } \
+      struct Fixed##N##_NodeType* made = Insert_ChildNode_Fixed##N##_N_Tree (fixed, copy, Data_N_Tree (tree, child), slot); \
+      ok = made != NULL && PushFixedStack (&stack, child, 0) && PushFixedStack (&stack, made, 0); \
+    } \
+  } \
+  free (stack.Items); \
+\
+  if (!ok) { \
+\
+    Delete_Fixed##N##_N_Tree (fixed); \
+    return NULL; \
+  } \
+  return fixed; \
+}
+
+FIXED_N_TREE_DEFINE (2)
+FIXED_N_TREE_DEFINE (4)
+FIXED_N_TREE_DEFINE (8)
+
+static int MeasureRuntime (struct N_TreeType* tree, int* leaves) {
+
+  struct FixedStackType stack = { NULL, 0, 0 };
+  int height = 0;
+  *leaves = 0;
+  if (!PushFixedStack (&stack, tree->Head, 1)) return -1;
+
+  while (stack.Size > 0) {
+
+    struct FixedFrameType frame = stack.Items[--stack.Size];
+    struct TreeNodeType* node = (struct TreeNodeType*) frame.Node;
+    if (frame.Depth > height) height = frame.Depth;
+
+    int children = 0;
+    FOR_EACH_CHILD_SLOT (node, slot) {
+
+      children++;
+      if (!PushFixedStack (&stack, node->Children[slot], frame.Depth + 1)) {
+
+        free (stack.Items);
+        return -1;
+      }
+    }
+    if (children == 0) (*leaves)++;
+  }
+  free (stack.Items);
+  return height;
+}
+
+int Height_Runtime_N_Tree (struct N_TreeType* tree) {
+
+  if (tree == NULL || tree->Head == NULL) return 0;
+  int leaves;
+  return MeasureRuntime (tree, &leaves);
+}
+
+int CountLeaves_Runtime_N_Tree (struct N_TreeType* tree) {
+
+  if (tree == NULL || tree->Head == NULL) return 0;
+  int leaves;
+  return MeasureRuntime (tree, &leaves) < 0 ? -1 : leaves;
+}
+
+// 실제로 쓰는 가장 높은 슬롯 + 1
+static int UsedSpan (struct N_TreeType* tree) {
+
+  struct FixedStackType stack = { NULL, 0, 0 };
+  int span = 0;
+  if (!PushFixedStack (&stack, tree->Head, 0)) return -1;
+
+  while (stack.Size > 0) {
+
+    struct TreeNodeType* node = (struct TreeNodeType*) stack.Items[--stack.Size].Node;
+    FOR_EACH_CHILD_SLOT (node, slot) {
+
+      if (slot + 1 > span) span = slot + 1;
+      if (!PushFixedStack (&stack, node->Children[slot], 0)) {
+
+        free (stack.Items);
+        return -1;
+      }
+    }
+  }
+  free (stack.Items);
+  return span;
+}
+
+// 쓰는 슬롯이 모두 들어가는 가장 작은 특수화를 고른다 (ChildSize 128 트리도 이진 트리처럼 쓰면 Fixed2).
+// 8 을 넘거나 복사에 실패하면 원본을 그대로 쓴다.
+struct Fixed_N_TreeType Specialize_N_Tree (struct N_TreeType* tree) {
+
+  struct Fixed_N_TreeType fixed = { 0, { NULL }, NULL };
+  if (tree == NULL || tree->Head == NULL) return fixed;
+
+  int span = tree->Pager == NULL ? UsedSpan (tree) : -1;  // 지연 로딩 트리는 특수화하지 않는다
+  if (span >= 0 && span <= 2) {
+
+    fixed.Tree.Fixed2 = Convert_Fixed2_N_Tree (tree);
+    if (fixed.Tree.Fixed2 != NULL) fixed.ChildSize = 2;
+  } else if (span >= 0 && span <= 4) {
+
+    fixed.Tree.Fixed4 = Convert_Fixed4_N_Tree (tree);
+    if (fixed.Tree.Fixed4 != NULL) fixed.ChildSize = 4;
+  } else if (span >= 0 && span <= 8) {
+
+    fixed.Tree.Fixed8 = Convert_Fixed8_N_Tree (tree);
+    if (fixed.Tree.Fixed8 != NULL) fixed.ChildSize = 8;
+  }
+
+  if (fixed.ChildSize == 0) {
+
+    fixed.ChildSize = tree->ChildSize;
+    fixed.Runtime = tree;
+  }
+  return fixed;
+}
+
+int Count_Fixed_N_Tree (const struct Fixed_N_TreeType* fixed) {
+
+  if (fixed->Runtime != NULL) return fixed->Runtime->Count;
+
+  switch (fixed->ChildSize) {
+
+    case 2: return fixed->Tree.Fixed2->Count;
+    case 4: return fixed->Tree.Fixed4->Count;
+    case 8: return fixed->Tree.Fixed8->Count;
+  }
+  return 0;
+}
+
+int Height_Fixed_N_Tree (const struct Fixed_N_TreeType* fixed) {
+
+  if (fixed->Runtime != NULL) return Height_Runtime_N_Tree (fixed->Runtime);
+
+  switch (fixed->ChildSize) {
+
+    case 2: return Height_Fixed2_N_Tree (fixed->Tree.Fixed2);
+    case 4: return Height_Fixed4_N_Tree (fixed->Tree.Fixed4);
+    case 8: return Height_Fixed8_N_Tree (fixed->Tree.Fixed8);
+  }
+  return 0;
+}
+
+int CountLeaves_Fixed_N_Tree (const struct Fixed_N_TreeType* fixed) {
+
+  if (fixed->Runtime != NULL) return CountLeaves_Runtime_N_Tree (fixed->Runtime);
+
+  switch (fixed->ChildSize) {
+
+    case 2: return CountLeaves_Fixed2_N_Tree (fixed->Tree.Fixed2);
+    case 4: return CountLeaves_Fixed4_N_Tree (fixed->Tree.Fixed4);
+    case 8: return CountLeaves_Fixed8_N_Tree (fixed->Tree.Fixed8);
+  }
+  return 0;
+}
+
+void Delete_Fixed_N_Tree (struct Fixed_N_TreeType* fixed) {
+
+  if (fixed == NULL || fixed->Runtime != NULL) return;
+
+  switch (fixed->ChildSize) {
+
+    case 2: Delete_Fixed2_N_Tree (fixed->Tree.Fixed2); break;
+    case 4: Delete_Fixed4_N_Tree (fixed->Tree.Fixed4); break;
+    case 8: Delete_Fixed8_N_Tree (fixed->Tree.Fixed8); break;
+  }
+  fixed->Tree.Fixed2 = NULL;
+  fixed->ChildSize = 0;
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#ifndef _FIXED_H_
+#define _FIXED_H_
+
+#include "n_tree.h"
+
+// 자식 수가 컴파일 시간 상수인 트리.
+// 자식 배열을 노드 안에 두므로 노드 하나가 한 번의 할당이고, 슬롯 반복문은 모두 풀린다.
+// FIXED_N_TREE_DECLARE (N) 이 Fixed##N##_ 접두어의 타입과 함수를 만든다 (2, 4, 8 을 미리 만들어 둠).
+
+#define FIXED_N_TREE_DECLARE(N) \
+  struct Fixed##N##_NodeType { \
+    LabelType Label; \
+    struct Fixed##N##_NodeType* Parent; \
+    struct Fixed##N##_NodeType* Children[N]; \
+  }; \
+  struct Fixed##N##_N_TreeType { \
+    struct Fixed##N##_NodeType* Head; \
+    int Count; \
+    struct LabelPoolType* Labels; \
+  }; \
+  struct Fixed##N##_N_TreeType* Create_Fixed##N##_N_Tree (void); \
+  struct Fixed##N##_N_TreeType* Convert_Fixed##N##_N_Tree (struct N_TreeType* tree); \
+  struct Fixed##N##_NodeType* Insert_ChildNode_Fixed##N##_N_Tree (struct Fixed##N##_N_TreeType* tree, struct Fixed##N##_NodeType* parent, const char* data, int position); \
+  struct Fixed##N##_NodeType* Access_Fixed##N##_N_Tree (struct Fixed##N##_N_TreeType* tree, struct Fixed##N##_NodeType* parent, int position); \
+  const char* Data_Fixed##N##_N_Tree (struct Fixed##N##_N_TreeType* tree, struct Fixed##N##_NodeType* node); \
+  int ChildCount_Fixed##N##_N_Tree (struct Fixed##N##_NodeType* node); \
+  int Height_Fixed##N##_N_Tree (struct Fixed##N##_N_TreeType* tree); \
+  int CountLeaves_Fixed##N##_N_Tree (struct Fixed##N##_N_TreeType* tree); \
+  void Clear_Fixed##N##_N_Tree (struct Fixed##N##_N_TreeType* tree, struct Fixed##N##_NodeType* node); \
+  void Delete_Fixed##N##_N_Tree (struct Fixed##N##_N_TreeType* tree);
+
+FIXED_N_TREE_DECLARE (2)
+FIXED_N_TREE_DECLARE (4)
+FIXED_N_TREE_DECLARE (8)
+
+// 실행 시간 ChildSize 용 (특수화가 없는 크기의 대체 경로)
+int Height_Runtime_N_Tree (struct N_TreeType* tree);
+int CountLeaves_Runtime_N_Tree (struct N_TreeType* tree);
+
+// 정적 타입으로 고르는 호출
+#define Height_Any_N_Tree(tree) _Generic ((tree), \
+  struct Fixed2_N_TreeType*: Height_Fixed2_N_Tree, \
+  struct Fixed4_N_TreeType*: Height_Fixed4_N_Tree, \
+  struct Fixed8_N_TreeType*: Height_Fixed8_N_Tree, \
+  struct N_TreeType*: Height_Runtime_N_Tree) (tree)
+
+#define CountLeaves_Any_N_Tree(tree) _Generic ((tree), \
+  struct Fixed2_N_TreeType*: CountLeaves_Fixed2_N_Tree, \
+  struct Fixed4_N_TreeType*: CountLeaves_Fixed4_N_Tree, \
+  struct Fixed8_N_TreeType*: CountLeaves_Fixed8_N_Tree, \
+  struct N_TreeType*: CountLeaves_Runtime_N_Tree) (tree)
+
+// 실행 시간에 고른 특수화. 맞는 크기가 없으면 원본 트리를 빌려 쓴다.
+struct Fixed_N_TreeType {
+
+  int ChildSize;  // 2, 4, 8 또는 원본의 ChildSize
+  union {
+
+    struct Fixed2_N_TreeType* Fixed2;
+    struct Fixed4_N_TreeType* Fixed4;
+    struct Fixed8_N_TreeType* Fixed8;
+  } Tree;
+  struct N_TreeType* Runtime;  // 특수화하지 않았을 때만 (해제하지 않는다)
+};
+
+struct Fixed_N_TreeType Specialize_N_Tree (struct N_TreeType* tree);
+int Count_Fixed_N_Tree (const struct Fixed_N_TreeType* fixed);
+int Height_Fixed_N_Tree (const struct Fixed_N_TreeType* fixed);
+int CountLeaves_Fixed_N_Tree (const struct Fixed_N_TreeType* fixed);
+void Delete_Fixed_N_Tree (struct Fixed_N_TreeType* fixed);
+
+#endif
\ No newline at end of file
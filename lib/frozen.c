@@ -0,0 +1,239 @@
+#include "frozen.h"
+#include "pager.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static int CountReachable (struct TreeNodeType* root, struct TreeNodeType*** stackOut) {
+
+  int capacity = 256;
+  struct TreeNodeType** stack = (struct TreeNodeType**) malloc (capacity * sizeof (struct TreeNodeType*));
+  if (stack == NULL) return -1;
+
+  int count = 0;
+  int top = 0;
+  stack[top++] = root;
+
+  while (top > 0) {
+
+    struct TreeNodeType* node = stack[--top];
+    count++;
+
+    FOR_EACH_CHILD_SLOT (node, index) {
+
+      if (top == capacity) {
+
+        capacity *= 2;
+        struct TreeNodeType** grown = (struct TreeNodeType**) realloc (stack, capacity * sizeof (struct TreeNodeType*));
+        if (grown == NULL) {
+
+          free (stack);
+          return -1;
+        }
+        stack = grown;
+      }
+      stack[top++] = node->Children[index];
+    }
+  }
+
+  // 두 번째 순회에서 그대로 재사용한다 (스택 높이는 노드 수를 넘지 않는다)
+  if (count + 1 > capacity) {
+
+    struct TreeNodeType** grown = (struct TreeNodeType**) realloc (stack, (count + 1) * sizeof (struct TreeNodeType*));
+    if (grown == NULL) {
+
+      free (stack);
+      return -1;
+    }
+    stack = grown;
+  }
+  *stackOut = stack;
+  return count;
+}
+
+struct Frozen_N_TreeType* Freeze_N_Tree (struct N_TreeType* tree) {
+
+  if (tree == NULL || tree->Head == NULL) {
+
+    printf ("Error! N_TreeType pointer is NULL. Freeze_N_Tree()\n");
+    return NULL;
+  }
+  // 지연 로딩 트리는 아직 파일에만 있는 서브트리까지 읽어야 빠짐없이 담는다
+  if (tree->Pager != NULL && !LoadAll_N_Tree (tree)) {
+
+    printf ("Error! Failed to load the paged subtrees. Freeze_N_Tree()\n");
+    return NULL;
+  }
+
+  struct TreeNodeType** stack = NULL;
+  int count = CountReachable (tree->Head, &stack);
+  if (count < 0) {
+
+    printf ("Error! The dynamic memory allocation failed. Freeze_N_Tree()\n");
+    return NULL;
+  }
+
+  // 모든 열을 한 번에 할당한다
+  size_t intColumns = (size_t) count * 6 + 1;
+  size_t bytes = sizeof (struct Frozen_N_TreeType) + intColumns * sizeof (int) + (size_t) count * sizeof (LabelType);
+  struct Frozen_N_TreeType* frozen = (struct Frozen_N_TreeType*) malloc (bytes);
+  if (frozen == NULL) {
+
+    printf ("Error! The dynamic memory allocation failed(2). Freeze_N_Tree()\n");
+    free (stack);
+    return NULL;
+  }
+
+  int* column = (int*) (frozen + 1);
+  frozen->Count = count;
+  frozen->ChildSize = tree->ChildSize;
+  frozen->Parent = column;
+  frozen->Slot = column + count;
+  frozen->Depth = column + count * 2;
+  frozen->SubtreeEnd = column + count * 3;
+  frozen->Children = column + count * 4;
+  frozen->ChildOffset = column + count * 5;
+  frozen->Label = (LabelType*) (column + intColumns);
+  frozen->Labels = tree->Labels;
+
+  // 전위 순서로 번호를 매긴다. 아직 채우지 않은 열을 작업 공간으로 빌려 쓴다.
+  int* childCount = frozen->SubtreeEnd;
+  int* ids = frozen->Children;
+  int* slots = frozen->ChildOffset;
+  int top = 0;
+  int next = 0;
+
+  stack[top] = tree->Head;
+  slots[top] = -1;
+  ids[top++] = -1;
+
+  while (top > 0) {
+
+    top--;
+    struct TreeNodeType* node = stack[top];
+    int parent = ids[top];
+    int slot = slots[top];
+    int id = next++;
+
+    frozen->Parent[id] = parent;
+    frozen->Depth[id] = parent < 0 ? 0 : frozen->Depth[parent] + 1;
+    frozen->Slot[id] = slot;
+    childCount[id] = 0;
+    if (parent >= 0) childCount[parent]++;
+
+    frozen->Label[id] = node->Label;
+
+    FOR_EACH_CHILD_SLOT_REVERSE (node, index) {
+
+      stack[top] = node->Children[index];
+      slots[top] = index;
+      ids[top++] = id;
+    }
+  }
+  free (stack);
+
+  // CSR 오프셋, 자식 목록 (전위 순서가 곧 슬롯 순서)
+  int offset = 0;
+  for (int id = 0; id < count; id++) {
+
+    frozen->ChildOffset[id] = offset;
+    offset += childCount[id];
+  }
+  frozen->ChildOffset[count] = offset;
+
+  int* cursor = frozen->SubtreeEnd;
+  for (int id = 0; id < count; id++) {
+
+    cursor[id] = frozen->ChildOffset[id];
+  }
+  for (int id = 1; id < count; id++) {
+
+    frozen->Children[cursor[frozen->Parent[id]]++] = id;
+  }
+
+  // 서브트리 끝은 마지막 자식의 서브트리 끝과 같다
+  for (int id = count - 1; id >= 0; id--) {
+
+    int last = frozen->ChildOffset[id + 1] - 1;
+    frozen->SubtreeEnd[id] = last < frozen->ChildOffset[id] ? id + 1 : frozen->SubtreeEnd[frozen->Children[last]];
+  }
+
+  return frozen;
+}
+
+int Access_Frozen_N_Tree (struct Frozen_N_TreeType* frozen, int parent, int position) {
+
+  if (frozen == NULL || parent < 0 || parent >= frozen->Count) return -1;
+  if (position < 0 || position >= frozen->ChildSize) {
+
+    printf ("Error! position %d is out of range (0 ~ %d). Access_Frozen_N_Tree()\n",
+      position, frozen->ChildSize - 1);
+    return -1;
+  }
+
+  // 자식 목록은 슬롯 순서로 정렬되어 있으므로 이분 탐색
+  int low = frozen->ChildOffset[parent];
+  int high = frozen->ChildOffset[parent + 1] - 1;
+  while (low <= high) {
+
+    int middle = (low + high) / 2;
+    int slot = frozen->Slot[frozen->Children[middle]];
+
+    if (slot == position) return frozen->Children[middle];
+    if (slot < position) low = middle + 1;
+    else high = middle - 1;
+  }
+  return -1;
+}
+
+const char* Data_Frozen_N_Tree (struct Frozen_N_TreeType* frozen, int node) {
+
+  if (frozen == NULL || node < 0 || node >= frozen->Count) return NULL;
+  return Label_Text (frozen->Labels, frozen->Label[node]);
+}
+
+int ChildCount_Frozen_N_Tree (struct Frozen_N_TreeType* frozen, int node) {
+
+  if (frozen == NULL || node < 0 || node >= frozen->Count) return 0;
+  return frozen->ChildOffset[node + 1] - frozen->ChildOffset[node];
+}
+
+int SubtreeSize_Frozen_N_Tree (struct Frozen_N_TreeType* frozen, int node) {
+
+  if (frozen == NULL || node < 0 || node >= frozen->Count) return 0;
+  return frozen->SubtreeEnd[node] - node;
+}
+
+bool IsAncestor_Frozen_N_Tree (struct Frozen_N_TreeType* frozen, int ancestor, int node) {
+
+  if (frozen == NULL || ancestor < 0 || node < 0 || ancestor >= frozen->Count || node >= frozen->Count) return false;
+  return ancestor <= node && node < frozen->SubtreeEnd[ancestor];
+}
+
+int CountLeaves_Frozen_N_Tree (struct Frozen_N_TreeType* frozen) {
+
+  if (frozen == NULL) return 0;
+
+  int leaves = 0;
+  for (int id = 0; id < frozen->Count; id++) {
+
+    leaves += (frozen->SubtreeEnd[id] == id + 1);
+  }
+  return leaves;
+}
+
+int Height_Frozen_N_Tree (struct Frozen_N_TreeType* frozen) {
+
+  if (frozen == NULL) return 0;
+
+  int height = 0;
+  for (int id = 0; id < frozen->Count; id++) {
+
+    if (frozen->Depth[id] + 1 > height) height = frozen->Depth[id] + 1;
+  }
+  return height;
+}
+
+void Delete_Frozen_N_Tree (struct Frozen_N_TreeType* frozen) {
+
+  free (frozen);
+}
\ No newline at end of file
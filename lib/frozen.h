@@ -0,0 +1,32 @@
+#ifndef _FROZEN_H_
+#define _FROZEN_H_
+
+#include "n_tree.h"
+
+// 읽기 전용 분석용 SoA(Structure of Arrays) 트리.
+// 노드 번호는 전위 순회 순서이므로 서브트리 i 는 [i, SubtreeEnd[i]) 구간이다.
+struct Frozen_N_TreeType {
+
+  int Count;
+  int ChildSize;
+  int* Parent;        // 부모 번호 (루트는 -1)
+  int* Slot;          // 부모의 몇 번째 슬롯인지 (루트는 -1)
+  int* Depth;         // 루트의 깊이는 0
+  int* SubtreeEnd;
+  int* ChildOffset;   // CSR: 자식 목록은 Children[ChildOffset[i] .. ChildOffset[i + 1])
+  int* Children;      // 슬롯 순서로 정렬된 자식 번호
+  LabelType* Label;   // 레이블 핸들 열
+  struct LabelPoolType* Labels;  // 원본 트리의 문자열 표 (원본 트리가 살아 있는 동안만 유효)
+};
+
+struct Frozen_N_TreeType* Freeze_N_Tree (struct N_TreeType* tree);
+int Access_Frozen_N_Tree (struct Frozen_N_TreeType* frozen, int parent, int position);
+const char* Data_Frozen_N_Tree (struct Frozen_N_TreeType* frozen, int node);
+int ChildCount_Frozen_N_Tree (struct Frozen_N_TreeType* frozen, int node);
+int SubtreeSize_Frozen_N_Tree (struct Frozen_N_TreeType* frozen, int node);
+bool IsAncestor_Frozen_N_Tree (struct Frozen_N_TreeType* frozen, int ancestor, int node);
+int CountLeaves_Frozen_N_Tree (struct Frozen_N_TreeType* frozen);
+int Height_Frozen_N_Tree (struct Frozen_N_TreeType* frozen);
+void Delete_Frozen_N_Tree (struct Frozen_N_TreeType* frozen);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,596 @@
+#include "handle.h"
+#include "pager.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 변환할 때 쓰는 깊이 우선 스택 (포인터 노드와 번호 노드를 짝지음)
+struct HandleFrameType {
+
+  struct TreeNodeType* Node;
+  NodeHandle Handle;
+};
+
+struct HandleStackType {
+
+  struct HandleFrameType* Items;
+  int Size;
+  int Capacity;
+};
+
+static bool PushHandleStack (struct HandleStackType* stack, struct TreeNodeType* node, NodeHandle handle) {
+
+  if (stack->Size == stack->Capacity) {
+
+    int capacity = stack->Capacity == 0 ? 64 : stack->Capacity * 2;
+    struct HandleFrameType* items = (struct HandleFrameType*) realloc (stack->Items, capacity * sizeof (struct HandleFrameType));
+    if (items == NULL) return false;
+
+    stack->Items = items;
+    stack->Capacity = capacity;
+  }
+  stack->Items[stack->Size].Node = node;
+  stack->Items[stack->Size++].Handle = handle;
+  return true;
+}
+
+static bool IsLive (const struct Handle_N_TreeType* tree, NodeHandle node) {
+
+  return tree != NULL && node < tree->NodeUsed && tree->Nodes[node].Label != LABEL_NONE;
+}
+
+// 2 의 거듭제곱 블록은 지수로, ChildSize 로 자른 블록은 마지막 칸으로 모은다
+static int BlockClass (unsigned int capacity) {
+
+  return (capacity & (capacity - 1)) == 0 ? __builtin_ctz (capacity) : HANDLE_BLOCK_CLASSES - 1;
+}
+
+// capacity 칸짜리 빈 블록을 잡는다 (해제된 같은 크기 블록을 먼저 쓴다). 실패하면 NODE_HANDLE_NONE.
+static unsigned int AllocBlock (struct Handle_N_TreeType* tree, unsigned int capacity) {
+
+  int class = BlockClass (capacity);
+  unsigned int offset = tree->FreeBlocks[class];
+  if (offset != NODE_HANDLE_NONE) {
+
+    tree->FreeBlocks[class] = tree->ChildPool[offset];
+  } else {
+
+    if (tree->PoolUsed > NODE_HANDLE_NONE - 1 - capacity) {
+
+      printf ("Error! Child pool is full. AllocBlock()\n");
+      return NODE_HANDLE_NONE;
+    }
+    if (tree->PoolUsed + capacity > tree->PoolCapacity) {
+
+      unsigned long long grown = tree->PoolCapacity == 0 ? 256 : (unsigned long long) tree->PoolCapacity * 2;
+      while (grown < tree->PoolUsed + capacity) grown *= 2;
+      if (grown > NODE_HANDLE_NONE - 1) grown = NODE_HANDLE_NONE - 1;
+
+      NodeHandle* pool = (NodeHandle*) realloc (tree->ChildPool, grown * sizeof (NodeHandle));
+      if (pool == NULL) {
+
+        printf ("Error! The dynamic memory allocation failed. AllocBlock()\n");
+        return NODE_HANDLE_NONE;
+      }
+      tree->ChildPool = pool;
+      tree->PoolCapacity = (unsigned int) grown;
+    }
+    offset = tree->PoolUsed;
+    tree->PoolUsed += capacity;
+  }
+  memset (tree->ChildPool + offset, 0xFF, capacity * sizeof (NodeHandle));
+  return offset;
+}
+
+static void FreeBlock (struct Handle_N_TreeType* tree, unsigned int offset, unsigned int capacity) {
+
+  int class = BlockClass (capacity);
+  tree->ChildPool[offset] = tree->FreeBlocks[class];
+  tree->FreeBlocks[class] = offset;
+}
+
+// 자식 블록을 slot 이 들어가는 크기로 늘린다 (두 배씩, ChildSize 까지)
+static bool GrowChildren (struct Handle_N_TreeType* tree, NodeHandle node, int slot) {
+
+  unsigned int old = tree->Nodes[node].Capacity;
+  if ((unsigned int) slot < old) return true;
+
+  unsigned int capacity = old > 0 ? old : CHILD_MIN_CAPACITY;
+  while (capacity <= (unsigned int) slot) capacity *= 2;
+  if (capacity > (unsigned int) tree->ChildSize) capacity = (unsigned int) tree->ChildSize;
+
+  unsigned int offset = AllocBlock (tree, capacity);
+  if (offset == NODE_HANDLE_NONE) return false;
+
+  struct HandleNodeType* entry = &tree->Nodes[node];
+  if (old > 0) {
+
+    memcpy (tree->ChildPool + offset, tree->ChildPool + entry->Children, old * sizeof (NodeHandle));
+    FreeBlock (tree, entry->Children, old);
+  }
+  entry->Children = offset;
+  entry->Capacity = (unsigned short) capacity;
+  return true;
+}
+
+// 자식 슬롯을 바꾸고 자식의 부모와 슬롯도 맞춘다. 블록이 모자라면 늘린다 (실패하면 false).
+static bool SetChild (struct Handle_N_TreeType* tree, NodeHandle node, int slot, NodeHandle child) {
+
+  if (child != NODE_HANDLE_NONE && !GrowChildren (tree, node, slot)) return false;
+  if (slot >= tree->Nodes[node].Capacity) return true;
+
+  tree->ChildPool[tree->Nodes[node].Children + slot] = child;
+  if (child != NODE_HANDLE_NONE) {
+
+    tree->Nodes[child].Parent = node;
+    tree->Nodes[child].Slot = (unsigned short) slot;
+  }
+  return true;
+}
+
+// 빈 칸을 하나 잡는다 (해제된 칸을 먼저 쓴다). 노드 표가 옮겨질 수 있으므로 호출한 쪽은 번호만 들고 있어야 한다.
+static NodeHandle AllocNode (struct Handle_N_TreeType* tree, LabelType label, NodeHandle parent) {
+
+  NodeHandle node = tree->FreeNodes;
+  if (node != NODE_HANDLE_NONE) {
+
+    tree->FreeNodes = tree->Nodes[node].Parent;
+  } else {
+
+    if (tree->NodeUsed == tree->NodeCapacity) {
+
+      if (tree->NodeCapacity >= NODE_HANDLE_NONE / 2) {
+
+        printf ("Error! Node table is full. AllocNode()\n");
+        return NODE_HANDLE_NONE;
+      }
+      unsigned int capacity = tree->NodeCapacity == 0 ? 64 : tree->NodeCapacity * 2;
+      struct HandleNodeType* nodes = (struct HandleNodeType*) realloc (tree->Nodes, capacity * sizeof (struct HandleNodeType));
+      if (nodes == NULL) {
+
+        printf ("Error! The dynamic memory allocation failed. AllocNode()\n");
+        return NODE_HANDLE_NONE;
+      }
+      tree->Nodes = nodes;
+      tree->NodeCapacity = capacity;
+    }
+    node = tree->NodeUsed++;
+  }
+
+  struct HandleNodeType* entry = &tree->Nodes[node];
+  entry->Label = label;
+  entry->Parent = parent;
+  entry->Children = NODE_HANDLE_NONE;
+  entry->Capacity = 0;
+  entry->Slot = 0;
+  return node;
+}
+
+static void FreeNode (struct Handle_N_TreeType* tree, NodeHandle node) {
+
+  struct HandleNodeType* entry = &tree->Nodes[node];
+  if (entry->Capacity > 0) FreeBlock (tree, entry->Children, entry->Capacity);
+  entry->Label = LABEL_NONE;
+  entry->Capacity = 0;
+  entry->Parent = tree->FreeNodes;
+  tree->FreeNodes = node;
+}
+
+// node 아래를 모두 해제하고 해제한 수를 돌려준다 (node 는 남김).
+// 처리할 노드 목록을 곧 해제될 노드의 Parent 칸으로 이어 쓰므로 추가 할당이 없다.
+static int FreeDescendants (struct Handle_N_TreeType* tree, NodeHandle node) {
+
+  NodeHandle pending = NODE_HANDLE_NONE;
+  NodeHandle current = node;
+  int count = 0;
+
+  while (current != NODE_HANDLE_NONE) {
+
+    struct HandleNodeType* entry = &tree->Nodes[current];
+    for (int slot = 0; slot < entry->Capacity; slot++) {
+
+      NodeHandle child = tree->ChildPool[entry->Children + slot];
+      if (child == NODE_HANDLE_NONE) continue;
+      tree->Nodes[child].Parent = pending;
+      pending = child;
+    }
+    if (current == node) {
+
+      if (entry->Capacity > 0) FreeBlock (tree, entry->Children, entry->Capacity);
+      entry->Children = NODE_HANDLE_NONE;
+      entry->Capacity = 0;
+    } else {
+
+      FreeNode (tree, current);
+      count++;
+    }
+
+    current = pending;
+    if (pending != NODE_HANDLE_NONE) pending = tree->Nodes[pending].Parent;
+  }
+  return count;
+}
+
+struct Handle_N_TreeType* Create_Handle_N_Tree (int number_of_children) {
+
+  if (number_of_children < 1 || number_of_children > CHILD_SIZE_MAX) {
+
+    printf ("Error! Invalid number_of_children: %d (must be between 1 and %d). Create_Handle_N_Tree()\n",
+      number_of_children, CHILD_SIZE_MAX);
+    return NULL;
+  }
+
+  struct Handle_N_TreeType* tree = (struct Handle_N_TreeType*) calloc (1, sizeof (struct Handle_N_TreeType));
+  if (tree == NULL) {
+
+    printf ("Error! The dynamic memory allocation failed. Create_Handle_N_Tree()\n");
+    return NULL;
+  }
+
+  tree->FreeNodes = NODE_HANDLE_NONE;
+  for (int class = 0; class < HANDLE_BLOCK_CLASSES; class++) tree->FreeBlocks[class] = NODE_HANDLE_NONE;
+  tree->ChildSize = number_of_children;
+  tree->Labels = Create_Label_Pool ();
+  tree->Head = tree->Labels == NULL ? NODE_HANDLE_NONE : AllocNode (tree, Intern_Label (tree->Labels, ""), NODE_HANDLE_NONE);
+  if (tree->Head == NODE_HANDLE_NONE) {
+
+    printf ("Error! The dynamic memory allocation failed(2). Create_Handle_N_Tree()\n");
+    Delete_Label_Pool (tree->Labels);
+    free (tree);
+    return NULL;
+  }
+  return tree;
+}
+
+NodeHandle Access_Handle_N_Tree (struct Handle_N_TreeType* tree, NodeHandle parent, int position) {
+
+  if (!IsLive (tree, parent)) return NODE_HANDLE_NONE;
+  if (position < 0 || position >= tree->ChildSize) {
+
+    printf ("Error! position %d is out of range (0 ~ %d). Access_Handle_N_Tree()\n",
+      position, tree->ChildSize - 1);
+    return NODE_HANDLE_NONE;
+  }
+  return ChildAt_Handle_N_Tree (tree, parent, position);
+}
+
+NodeHandle Parent_Handle_N_Tree (struct Handle_N_TreeType* tree, NodeHandle node) {
+
+  if (!IsLive (tree, node)) return NODE_HANDLE_NONE;
+  return tree->Nodes[node].Parent;
+}
+
+const char* Data_Handle_N_Tree (struct Handle_N_TreeType* tree, NodeHandle node) {
+
+  if (!IsLive (tree, node)) return "";
+  return Label_Text (tree->Labels, tree->Nodes[node].Label);
+}
+
+bool SetData_Handle_N_Tree (struct Handle_N_TreeType* tree, NodeHandle node, const char* data) {
+
+  if (!IsLive (tree, node) || data == NULL) return false;
+
+  LabelType label = Intern_Label (tree->Labels, data);
+  if (label == LABEL_NONE) return false;
+  tree->Nodes[node].Label = label;
+  return true;
+}
+
+int ChildCount_Handle_N_Tree (struct Handle_N_TreeType* tree, NodeHandle node) {
+
+  if (!IsLive (tree, node)) return 0;
+
+  const struct HandleNodeType* entry = &tree->Nodes[node];
+  int count = 0;
+  for (int slot = 0; slot < entry->Capacity; slot++) count += tree->ChildPool[entry->Children + slot] != NODE_HANDLE_NONE;
+  return count;
+}
+
+NodeHandle Insert_ChildNode_Handle_N_Tree (struct Handle_N_TreeType* tree, NodeHandle parent, const char* data, int position) {
+
+  if (tree == NULL || data == NULL) {
+
+    printf ("Error! Invalid arguments. Insert_ChildNode_Handle_N_Tree()\n");
+    return NODE_HANDLE_NONE;
+  }
+  if (!IsLive (tree, parent)) {
+
+    printf ("Error! Parent node is invalid. Insert_ChildNode_Handle_N_Tree()\n");
+    return NODE_HANDLE_NONE;
+  }
+  if (position < 0 || position >= tree->ChildSize) {
+
+    printf ("Error! position %d is out of range (0 ~ %d). Insert_ChildNode_Handle_N_Tree()\n",
+      position, tree->ChildSize - 1);
+    return NODE_HANDLE_NONE;
+  }
+  if (ChildAt_Handle_N_Tree (tree, parent, position) != NODE_HANDLE_NONE) {
+
+    printf ("Error! Position %d is already occupied. Insert_ChildNode_Handle_N_Tree()\n", position);
+    return NODE_HANDLE_NONE;
+  }
+
+  LabelType label = Intern_Label (tree->Labels, data);
+  if (label == LABEL_NONE) return NODE_HANDLE_NONE;
+  NodeHandle node = AllocNode (tree, label, parent);
+  if (node == NODE_HANDLE_NONE) return NODE_HANDLE_NONE;
+
+  if (!SetChild (tree, parent, position, node)) {
+
+    FreeNode (tree, node);
+    return NODE_HANDLE_NONE;
+  }
+  tree->Count++;
+  return node;
+}
+
+NodeHandle Insert_ParentNode_Handle_N_Tree (struct Handle_N_TreeType* tree, NodeHandle child, const char* data) {
+
+  if (tree == NULL || data == NULL) {
+
+    printf ("Error! Invalid arguments. Insert_ParentNode_Handle_N_Tree()\n");
+    return NODE_HANDLE_NONE;
+  }
+  if (!IsLive (tree, child)) {
+
+    printf ("Error! Child node is invalid. Insert_ParentNode_Handle_N_Tree()\n");
+    return NODE_HANDLE_NONE;
+  }
+  if (child == tree->Head) {
+
+    printf ("Error! Cannot insert a parent above the head node. Insert_ParentNode_Handle_N_Tree()\n");
+    return NODE_HANDLE_NONE;
+  }
+
+  LabelType label = Intern_Label (tree->Labels, data);
+  if (label == LABEL_NONE) return NODE_HANDLE_NONE;
+
+  NodeHandle parent = tree->Nodes[child].Parent;
+  int position = tree->Nodes[child].Slot;
+  NodeHandle node = AllocNode (tree, label, parent);
+  if (node == NODE_HANDLE_NONE) return NODE_HANDLE_NONE;
+
+  if (!SetChild (tree, node, 0, child)) {
+
+    FreeNode (tree, node);
+    return NODE_HANDLE_NONE;
+  }
+  SetChild (tree, parent, position, node);
+  tree->Count++;
+  return node;
+}
+
+bool Move_Subtree_Handle_N_Tree (struct Handle_N_TreeType* tree, NodeHandle node, NodeHandle newParent, int position) {
+
+  if (!IsLive (tree, node) || !IsLive (tree, newParent)) {
+
+    printf ("Error! Node or new parent is invalid. Move_Subtree_Handle_N_Tree()\n");
+    return false;
+  }
+  if (node == tree->Head) {
+
+    printf ("Error! Cannot move the head node. Move_Subtree_Handle_N_Tree()\n");
+    return false;
+  }
+  if (position < 0 || position >= tree->ChildSize) {
+
+    printf ("Error! position %d is out of range (0 ~ %d). Move_Subtree_Handle_N_Tree()\n",
+      position, tree->ChildSize - 1);
+    return false;
+  }
+  if (ChildAt_Handle_N_Tree (tree, newParent, position) != NODE_HANDLE_NONE) {
+
+    printf ("Error! Position %d is already occupied. Move_Subtree_Handle_N_Tree()\n", position);
+    return false;
+  }
+
+  // 목적지가 옮길 서브트리 안에 있으면 순환이 생긴다
+  for (NodeHandle ancestor = newParent; ancestor != NODE_HANDLE_NONE; ancestor = tree->Nodes[ancestor].Parent) {
+
+    if (ancestor == node) {
+
+      printf ("Error! Cannot move a node under its own subtree. Move_Subtree_Handle_N_Tree()\n");
+      return false;
+    }
+  }
+
+  // 새 자리를 먼저 잡는다 (자식 블록을 늘리다 실패하면 아무것도 바꾸지 않음)
+  NodeHandle oldParent = tree->Nodes[node].Parent;
+  int oldPosition = tree->Nodes[node].Slot;
+  if (!SetChild (tree, newParent, position, node)) return false;
+  SetChild (tree, oldParent, oldPosition, NODE_HANDLE_NONE);
+  return true;
+}
+
+bool Remove_Handle_N_Tree (struct Handle_N_TreeType* tree, NodeHandle target, bool clearAll) {
+
+  if (!IsLive (tree, target)) {
+
+    printf ("Error! Target node is invalid. Remove_Handle_N_Tree()\n");
+    return false;
+  }
+  if (target == tree->Head) {
+
+    printf ("Error! Cannot remove the head node. Remove_Handle_N_Tree()\n");
+    return false;
+  }
+  if (clearAll) {
+
+    Clear_Handle_N_Tree (tree, target);
+    return true;
+  }
+
+  int children = ChildCount_Handle_N_Tree (tree, target);
+  if (children > 1) return false;
+
+  NodeHandle parent = tree->Nodes[target].Parent;
+  int position = tree->Nodes[target].Slot;
+  NodeHandle child = NODE_HANDLE_NONE;
+  for (int slot = 0; children == 1 && child == NODE_HANDLE_NONE; slot++) child = ChildAt_Handle_N_Tree (tree, target, slot);
+
+  // 자식이 하나면 그 자식이 target 의 자리를 잇는다
+  SetChild (tree, parent, position, child);
+  FreeNode (tree, target);
+  tree->Count--;
+  return true;
+}
+
+// 루트를 지우면 자식만 모두 지우고 빈 루트를 남긴다
+void Clear_Handle_N_Tree (struct Handle_N_TreeType* tree, NodeHandle node) {
+
+  if (!IsLive (tree, node)) return;
+
+  tree->Count -= FreeDescendants (tree, node);
+  if (node == tree->Head) return;
+
+  SetChild (tree, tree->Nodes[node].Parent, tree->Nodes[node].Slot, NODE_HANDLE_NONE);
+  FreeNode (tree, node);
+  tree->Count--;
+}
+
+void Delete_Handle_N_Tree (struct Handle_N_TreeType* tree) {
+
+  if (tree == NULL) return;
+
+  Delete_Label_Pool (tree->Labels);
+  free (tree->Nodes);
+  free (tree->ChildPool);
+  free (tree);
+}
+
+// 노드 표와 자식 표가 잡은 바이트 (레이블 표 제외)
+size_t Bytes_Handle_N_Tree (const struct Handle_N_TreeType* tree) {
+
+  if (tree == NULL) return 0;
+  return sizeof (struct Handle_N_TreeType) + (size_t) tree->NodeCapacity * sizeof (struct HandleNodeType) +
+         (size_t) tree->PoolCapacity * sizeof (NodeHandle);
+}
+
+// 원본 표의 레이블을 대상 표에 한 번씩만 등록한다 (map 은 원본 핸들 -> 대상 핸들)
+static LabelType MapLabel (LabelType* map, struct LabelPoolType* from, struct LabelPoolType* to, LabelType label) {
+
+  if (map[label] == LABEL_NONE) map[label] = Intern_Label (to, Label_Text (from, label));
+  return map[label];
+}
+
+struct Handle_N_TreeType* Convert_Handle_N_Tree (struct N_TreeType* tree) {
+
+  if (tree == NULL || tree->Head == NULL) {
+
+    printf ("Error! N_TreeType pointer is NULL. Convert_Handle_N_Tree()\n");
+    return NULL;
+  }
+
+  struct Handle_N_TreeType* handles = Create_Handle_N_Tree (tree->ChildSize);
+  if (handles == NULL) return NULL;
+
+  LabelType* map = (LabelType*) malloc ((tree->Labels->Count + 1) * sizeof (LabelType));
+  struct HandleStackType stack = { NULL, 0, 0 };
+  bool ok = map != NULL;
+  if (ok) {
+
+    memset (map, 0xFF, (tree->Labels->Count + 1) * sizeof (LabelType));
+    handles->Nodes[handles->Head].Label = MapLabel (map, tree->Labels, handles->Labels, tree->Head->Label);
+    ok = handles->Nodes[handles->Head].Label != LABEL_NONE && PushHandleStack (&stack, tree->Head, handles->Head);
+  }
+
+  while (ok && stack.Size > 0) {
+
+    struct HandleFrameType frame = stack.Items[--stack.Size];
+    // 지연 로딩한 트리는 변환하면서 모두 읽는다
+    if (tree->Pager != NULL && !Fault_N_Tree (tree, frame.Node)) {
+
+      ok = false;
+      break;
+    }
+    // 마지막 슬롯까지 블록을 한 번에 잡는다
+    int last = LastChildSlot_N_Tree (frame.Node);
+    if (last >= 0 && !GrowChildren (handles, frame.Handle, last)) {
+
+      ok = false;
+      break;
+    }
+
+    FOR_EACH_CHILD_SLOT_REVERSE (frame.Node, slot) {
+
+      if (!ok) continue;
+      struct TreeNodeType* child = frame.Node->Children[slot];
+      LabelType label = MapLabel (map, tree->Labels, handles->Labels, child->Label);
+      NodeHandle node = label == LABEL_NONE ? NODE_HANDLE_NONE : AllocNode (handles, label, frame.Handle);
+      ok = node != NODE_HANDLE_NONE && SetChild (handles, frame.Handle, slot, node) && PushHandleStack (&stack, child, node);
+      if (node != NODE_HANDLE_NONE) handles->Count++;
+    }
+  }
+  free (stack.Items);
+  free (map);
+
+  if (!ok) {
+
+    printf ("Error! The dynamic memory allocation failed. Convert_Handle_N_Tree()\n");
+    Delete_Handle_N_Tree (handles);
+    return NULL;
+  }
+  return handles;
+}
+
+struct N_TreeType* Expand_Handle_N_Tree (struct Handle_N_TreeType* handles) {
+
+  if (!IsLive (handles, handles == NULL ? NODE_HANDLE_NONE : handles->Head)) {
+
+    printf ("Error! Handle_N_TreeType pointer is NULL. Expand_Handle_N_Tree()\n");
+    return NULL;
+  }
+
+  struct N_TreeType* tree = Create_N_Tree (handles->ChildSize);
+  if (tree == NULL) return NULL;
+
+  LabelType* map = (LabelType*) malloc ((handles->Labels->Count + 1) * sizeof (LabelType));
+  struct HandleStackType stack = { NULL, 0, 0 };
+  bool ok = map != NULL;
+  if (ok) {
+
+    memset (map, 0xFF, (handles->Labels->Count + 1) * sizeof (LabelType));
+    tree->Head->Label = MapLabel (map, handles->Labels, tree->Labels, handles->Nodes[handles->Head].Label);
+    ok = tree->Head->Label != LABEL_NONE && PushHandleStack (&stack, tree->Head, handles->Head);
+  }
+
+  while (ok && stack.Size > 0) {
+
+    struct HandleFrameType frame = stack.Items[--stack.Size];
+    const struct HandleNodeType* entry = &handles->Nodes[frame.Handle];
+    if (entry->Capacity > 0 && !ReserveChildren_N_Tree (frame.Node, entry->Capacity)) {
+
+      ok = false;
+      break;
+    }
+
+    for (int slot = entry->Capacity - 1; ok && slot >= 0; slot--) {
+
+      NodeHandle child = handles->ChildPool[entry->Children + slot];
+      if (child == NODE_HANDLE_NONE) continue;
+
+      LabelType label = MapLabel (map, handles->Labels, tree->Labels, handles->Nodes[child].Label);
+      struct TreeNodeType* node = label == LABEL_NONE ? NULL : MakeTreeNode (tree, frame.Node, "");
+      if (node == NULL) {
+
+        ok = false;
+        break;
+      }
+      node->Label = label;
+      SetChild_N_Tree (frame.Node, slot, node);
+      tree->Count++;
+      ok = PushHandleStack (&stack, node, child);
+    }
+  }
+  free (stack.Items);
+  free (map);
+
+  if (!ok) {
+
+    printf ("Error! The dynamic memory allocation failed. Expand_Handle_N_Tree()\n");
+    Delete_N_Tree (tree);
+    return NULL;
+  }
+  Rehash_N_Tree (tree);
+  return tree;
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#ifndef _HANDLE_H_
+#define _HANDLE_H_
+
+#include "n_tree.h"
+
+// 포인터 대신 32 비트 번호로 연결한 트리.
+// 노드는 트리가 가진 노드 표의 칸이고, 자식 블록은 자식 표(ChildPool) 안의 구간이다.
+// 모든 연결이 표 안의 번호이므로 표를 통째로 옮기거나 파일에 그대로 써도 유효하다.
+
+typedef unsigned int NodeHandle;
+#define NODE_HANDLE_NONE 0xFFFFFFFFu
+#define HANDLE_BLOCK_CLASSES 17  // 2^0 ~ 2^15 칸 블록과 ChildSize 칸 블록 (2 의 거듭제곱이 아닐 때)
+
+// 노드 하나가 16 바이트 (포인터 트리의 연결 필드만 따져도 절반 이하)
+struct HandleNodeType {
+
+  LabelType Label;          // 해제된 칸은 LABEL_NONE
+  NodeHandle Parent;        // 해제된 칸은 다음 빈 칸 번호
+  unsigned int Children;    // 자식 블록이 시작하는 ChildPool 위치 (블록이 없으면 NODE_HANDLE_NONE)
+  unsigned short Capacity;  // 자식 블록 칸 수 (2 의 거듭제곱이되 ChildSize 를 넘지 않는다)
+  unsigned short Slot;      // 부모의 몇 번째 슬롯인지
+};
+
+struct Handle_N_TreeType {
+
+  struct HandleNodeType* Nodes;  // 노드 표
+  unsigned int NodeUsed;         // 한 번이라도 쓴 칸 수
+  unsigned int NodeCapacity;
+  NodeHandle FreeNodes;          // 해제된 칸 목록 (Parent 로 이어짐)
+  NodeHandle* ChildPool;         // 자식 블록들 (빈 슬롯은 NODE_HANDLE_NONE)
+  unsigned int PoolUsed;
+  unsigned int PoolCapacity;
+  unsigned int FreeBlocks[HANDLE_BLOCK_CLASSES];  // 크기별 해제된 블록 목록 (블록 첫 칸으로 이어짐)
+  NodeHandle Head;
+  int Count;      // 루트를 뺀 노드 수 (Create_N_Tree 와 같음)
+  int ChildSize;
+  struct LabelPoolType* Labels;
+};
+
+static inline NodeHandle ChildAt_Handle_N_Tree (const struct Handle_N_TreeType* tree, NodeHandle node, int slot) {
+
+  const struct HandleNodeType* entry = &tree->Nodes[node];
+  return slot >= 0 && slot < entry->Capacity ? tree->ChildPool[entry->Children + slot] : NODE_HANDLE_NONE;
+}
+
+struct Handle_N_TreeType* Create_Handle_N_Tree (int number_of_children);
+NodeHandle Access_Handle_N_Tree (struct Handle_N_TreeType* tree, NodeHandle parent, int position);
+NodeHandle Parent_Handle_N_Tree (struct Handle_N_TreeType* tree, NodeHandle node);
+const char* Data_Handle_N_Tree (struct Handle_N_TreeType* tree, NodeHandle node);
+bool SetData_Handle_N_Tree (struct Handle_N_TreeType* tree, NodeHandle node, const char* data);
+int ChildCount_Handle_N_Tree (struct Handle_N_TreeType* tree, NodeHandle node);
+NodeHandle Insert_ChildNode_Handle_N_Tree (struct Handle_N_TreeType* tree, NodeHandle parent, const char* data, int position);
+NodeHandle Insert_ParentNode_Handle_N_Tree (struct Handle_N_TreeType* tree, NodeHandle child, const char* data);
+bool Move_Subtree_Handle_N_Tree (struct Handle_N_TreeType* tree, NodeHandle node, NodeHandle newParent, int position);
+bool Remove_Handle_N_Tree (struct Handle_N_TreeType* tree, NodeHandle target, bool clearAll);
+void Clear_Handle_N_Tree (struct Handle_N_TreeType* tree, NodeHandle node);
+void Delete_Handle_N_Tree (struct Handle_N_TreeType* tree);
+size_t Bytes_Handle_N_Tree (const struct Handle_N_TreeType* tree);
+
+// 포인터 트리와 오가는 변환 (레이블은 새 트리의 문자열 표로 다시 등록한다)
+struct Handle_N_TreeType* Convert_Handle_N_Tree (struct N_TreeType* tree);
+struct N_TreeType* Expand_Handle_N_Tree (struct Handle_N_TreeType* handles);
+
+#endif
\ No newline at end of file
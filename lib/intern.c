@@ -0,0 +1,140 @@
+#include "intern.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static unsigned int HashText (const char* text, size_t length) {
+
+  // FNV-1a
+  unsigned int hash = 2166136261u;
+  for (size_t index = 0; index < length; index++) {
+
+    hash ^= (unsigned char) text[index];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static bool GrowBuckets (struct LabelPoolType* pool) {
+
+  unsigned int count = pool->BucketCount == 0 ? 256 : pool->BucketCount * 2;
+  unsigned int* buckets = (unsigned int*) calloc (count, sizeof (unsigned int));
+  if (buckets == NULL) return false;
+
+  for (unsigned int label = 0; label < pool->Count; label++) {
+
+    const char* text = pool->Bytes + pool->Offsets[label];
+    unsigned int slot = HashText (text, strlen (text)) & (count - 1);
+    while (buckets[slot] != 0) slot = (slot + 1) & (count - 1);
+    buckets[slot] = label + 1;
+  }
+
+  free (pool->Buckets);
+  pool->Buckets = buckets;
+  pool->BucketCount = count;
+  return true;
+}
+
+struct LabelPoolType* Create_Label_Pool (void) {
+
+  struct LabelPoolType* pool = (struct LabelPoolType*) calloc (1, sizeof (struct LabelPoolType));
+  if (pool == NULL) {
+
+    printf ("Error! The dynamic memory allocation failed. Create_Label_Pool()\n");
+    return NULL;
+  }
+
+  if (Intern_Label (pool, "") != 0) {
+
+    Delete_Label_Pool (pool);
+    return NULL;
+  }
+  return pool;
+}
+
+LabelType Find_Label (struct LabelPoolType* pool, const char* text) {
+
+  if (pool == NULL || text == NULL || pool->BucketCount == 0) return LABEL_NONE;
+
+  size_t length = strlen (text);
+  unsigned int slot = HashText (text, length) & (pool->BucketCount - 1);
+
+  while (pool->Buckets[slot] != 0) {
+
+    LabelType label = pool->Buckets[slot] - 1;
+    if (strcmp (pool->Bytes + pool->Offsets[label], text) == 0) return label;
+    slot = (slot + 1) & (pool->BucketCount - 1);
+  }
+  return LABEL_NONE;
+}
+
+LabelType Intern_Label (struct LabelPoolType* pool, const char* text) {
+
+  if (pool == NULL || text == NULL) return LABEL_NONE;
+
+  LabelType found = Find_Label (pool, text);
+  if (found != LABEL_NONE) return found;
+
+  // 적재율 1/2 를 넘기 전에 버킷을 늘린다
+  if ((pool->Count + 1) * 2 > pool->BucketCount && !GrowBuckets (pool)) {
+
+    printf ("Error! The dynamic memory allocation failed. Intern_Label()\n");
+    return LABEL_NONE;
+  }
+
+  size_t length = strlen (text);
+  if (pool->Used + length + 1 > pool->Capacity) {
+
+    size_t capacity = pool->Capacity == 0 ? 4096 : pool->Capacity;
+    while (capacity < pool->Used + length + 1) capacity *= 2;
+
+    char* bytes = (char*) realloc (pool->Bytes, capacity);
+    if (bytes == NULL) {
+
+      printf ("Error! The dynamic memory allocation failed(2). Intern_Label()\n");
+      return LABEL_NONE;
+    }
+    pool->Bytes = bytes;
+    pool->Capacity = capacity;
+  }
+
+  if (pool->Count == pool->OffsetCapacity) {
+
+    unsigned int capacity = pool->OffsetCapacity == 0 ? 256 : pool->OffsetCapacity * 2;
+    unsigned int* offsets = (unsigned int*) realloc (pool->Offsets, capacity * sizeof (unsigned int));
+    if (offsets == NULL) {
+
+      printf ("Error! The dynamic memory allocation failed(3). Intern_Label()\n");
+      return LABEL_NONE;
+    }
+    pool->Offsets = offsets;
+    pool->OffsetCapacity = capacity;
+  }
+
+  LabelType label = pool->Count++;
+  pool->Offsets[label] = (unsigned int) pool->Used;
+  memcpy (pool->Bytes + pool->Used, text, length + 1);
+  pool->Used += length + 1;
+
+  unsigned int slot = HashText (text, length) & (pool->BucketCount - 1);
+  while (pool->Buckets[slot] != 0) slot = (slot + 1) & (pool->BucketCount - 1);
+  pool->Buckets[slot] = label + 1;
+
+  return label;
+}
+
+const char* Label_Text (struct LabelPoolType* pool, LabelType label) {
+
+  if (pool == NULL || label >= pool->Count) return "";
+  return pool->Bytes + pool->Offsets[label];
+}
+
+void Delete_Label_Pool (struct LabelPoolType* pool) {
+
+  if (pool == NULL) return;
+
+  free (pool->Bytes);
+  free (pool->Offsets);
+  free (pool->Buckets);
+  free (pool);
+}
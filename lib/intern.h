@@ -0,0 +1,32 @@
+#ifndef _INTERN_H_
+#define _INTERN_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define LABEL_MAX_LENGTH 1024
+#define LABEL_NONE 0xFFFFFFFFu
+
+// 레이블 핸들: 트리가 소유한 문자열 표의 번호. 0 번은 빈 문자열이다.
+typedef unsigned int LabelType;
+
+// 추가만 하는 문자열 표. 같은 문자열은 한 번만 저장되므로 핸들끼리 비교하면 문자열 비교와 같다.
+struct LabelPoolType {
+
+  char* Bytes;            // NUL 로 끝나는 문자열들을 이어 붙인 저장소
+  size_t Used;
+  size_t Capacity;
+  unsigned int* Offsets;  // 핸들 -> Bytes 안의 위치
+  unsigned int Count;
+  unsigned int OffsetCapacity;
+  unsigned int* Buckets;  // 개방 주소법 해시 (핸들 + 1, 0 은 빈 칸)
+  unsigned int BucketCount;
+};
+
+struct LabelPoolType* Create_Label_Pool (void);
+LabelType Intern_Label (struct LabelPoolType* pool, const char* text);
+LabelType Find_Label (struct LabelPoolType* pool, const char* text);
+const char* Label_Text (struct LabelPoolType* pool, LabelType label);
+void Delete_Label_Pool (struct LabelPoolType* pool);
+
+#endif
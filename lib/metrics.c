@@ -0,0 +1,199 @@
+#include "metrics.h"
+#include <string.h>
+#include <time.h>
+
+static const char* CounterNames[METRIC_COUNTER_COUNT] = {
+
+  "nodes_allocated", "nodes_freed", "node_bytes", "json_bytes_written", "json_bytes_read"
+};
+
+static const char* OperationNames[METRIC_OPERATION_COUNT] = {
+
+  "insert_child", "insert_parent", "move_subtree", "clone_subtree", "remove", "clear", "detach", "reclaim", "set_data", "json_save", "json_parse"
+};
+
+struct NamedHistogramType {
+
+  char Name[METRIC_NAME_SIZE];
+  struct HistogramType Latency;
+};
+
+// CLI 는 한 스레드에서만 명령을 처리하므로 잠금 없이 전역 표를 쓴다
+static unsigned long long Counters[METRIC_COUNTER_COUNT];
+static struct HistogramType Operations[METRIC_OPERATION_COUNT];
+static struct NamedHistogramType Named[METRICS_MAX_NAMED];
+static int NamedCount;
+
+static int BucketIndex (unsigned long long value) {
+
+  if (value < 16) return (int) value;
+
+  int magnitude = 63 - __builtin_clzll (value);
+  int shift = magnitude - HISTOGRAM_SUB_BITS;
+  return 16 + (magnitude - 4) * (1 << HISTOGRAM_SUB_BITS) + (int) ((value >> shift) & ((1 << HISTOGRAM_SUB_BITS) - 1));
+}
+
+// 칸에 들어가는 가장 큰 값
+static unsigned long long BucketUpper (int index) {
+
+  if (index < 16) return (unsigned long long) index;
+
+  int magnitude = (index - 16) / (1 << HISTOGRAM_SUB_BITS) + 4;
+  int sub = (index - 16) % (1 << HISTOGRAM_SUB_BITS);
+  int shift = magnitude - HISTOGRAM_SUB_BITS;
+  unsigned long long lower = ((unsigned long long) ((1 << HISTOGRAM_SUB_BITS) + sub)) << shift;
+  return lower + ((1ULL << shift) - 1);
+}
+
+void RecordHistogram (struct HistogramType* histogram, unsigned long long value) {
+
+  histogram->Counts[BucketIndex (value)]++;
+  if (histogram->Total == 0 || value < histogram->Min) histogram->Min = value;
+  if (value > histogram->Max) histogram->Max = value;
+  histogram->Total++;
+  histogram->Sum += value;
+}
+
+// percentile 은 0 ~ 100. 칸의 상한을 돌려주되 실제 최댓값을 넘지 않는다.
+unsigned long long HistogramPercentile (const struct HistogramType* histogram, double percentile) {
+
+  if (histogram->Total == 0) return 0;
+
+  unsigned long long rank = (unsigned long long) (percentile / 100.0 * histogram->Total + 0.5);
+  if (rank < 1) rank = 1;
+
+  unsigned long long seen = 0;
+  for (int index = 0; index < HISTOGRAM_BUCKETS; index++) {
+
+    seen += histogram->Counts[index];
+    if (seen >= rank) {
+
+      unsigned long long upper = BucketUpper (index);
+      return upper < histogram->Max ? upper : histogram->Max;
+    }
+  }
+  return histogram->Max;
+}
+
+unsigned long long Metric_Now (void) {
+
+  struct timespec now;
+  clock_gettime (CLOCK_MONOTONIC, &now);
+  return (unsigned long long) now.tv_sec * 1000000000ULL + (unsigned long long) now.tv_nsec;
+}
+
+void Metric_Add (enum MetricCounterType counter, unsigned long long amount) {
+
+  Counters[counter] += amount;
+}
+
+void Metric_Record (enum MetricOperationType operation, unsigned long long nanoseconds) {
+
+  RecordHistogram (&Operations[operation], nanoseconds);
+}
+
+// 이름별 히스토그램 (CLI 명령). 표가 차면 기록하지 않는다.
+void Metric_RecordNamed (const char* name, unsigned long long nanoseconds) {
+
+  for (int index = 0; index < NamedCount; index++) {
+
+    if (strcmp (Named[index].Name, name) == 0) {
+
+      RecordHistogram (&Named[index].Latency, nanoseconds);
+      return;
+    }
+  }
+  if (NamedCount == METRICS_MAX_NAMED) return;
+
+  struct NamedHistogramType* named = &Named[NamedCount++];
+  strncpy (named->Name, name, METRIC_NAME_SIZE - 1);
+  named->Name[METRIC_NAME_SIZE - 1] = '\0';
+  RecordHistogram (&named->Latency, nanoseconds);
+}
+
+bool Metrics_Enabled (void) {
+
+#ifndef NO_TREE_METRICS
+  return true;
+#else
+  return false;
+#endif
+}
+
+void ResetMetrics (void) {
+
+  memset (Counters, 0, sizeof (Counters));
+  memset (Operations, 0, sizeof (Operations));
+  memset (Named, 0, sizeof (Named));
+  NamedCount = 0;
+}
+
+static void PrintHistogramRow (const char* name, const struct HistogramType* histogram) {
+
+  if (histogram->Total == 0) return;
+
+  printf ("  %-16s %8llu %10.1f %10.1f %10.1f %10.1f\n", name, histogram->Total,
+          HistogramPercentile (histogram, 50) / 1000.0, HistogramPercentile (histogram, 90) / 1000.0,
+          HistogramPercentile (histogram, 99) / 1000.0, histogram->Max / 1000.0);
+}
+
+void PrintMetrics (void) {
+
+  printf ("\nCounters:\n");
+  for (int index = 0; index < METRIC_COUNTER_COUNT; index++) {
+
+    printf ("  %-20s %llu\n", CounterNames[index], Counters[index]);
+  }
+
+  printf ("\nLatency (us)        count        p50        p90        p99        max\n");
+  for (int index = 0; index < METRIC_OPERATION_COUNT; index++) {
+
+    PrintHistogramRow (OperationNames[index], &Operations[index]);
+  }
+
+  printf ("\nCommands (us)       count        p50        p90        p99        max\n");
+  for (int index = 0; index < NamedCount; index++) {
+
+    PrintHistogramRow (Named[index].Name, &Named[index].Latency);
+  }
+  printf ("\n");
+}
+
+static void WriteHistogramJSON (FILE* fp, const char* name, const struct HistogramType* histogram, bool* first) {
+
+  if (histogram->Total == 0) return;
+
+  fprintf (fp, "%s\n    \"%s\": {\"count\": %llu, \"min\": %llu, \"mean\": %llu, \"p50\": %llu, \"p90\": %llu, \"p99\": %llu, \"max\": %llu}",
+           *first ? "" : ",", name, histogram->Total, histogram->Min, histogram->Sum / histogram->Total,
+           HistogramPercentile (histogram, 50), HistogramPercentile (histogram, 90), HistogramPercentile (histogram, 99), histogram->Max);
+  *first = false;
+}
+
+// 나노초 단위 JSON
+bool DumpMetricsJSON (FILE* fp) {
+
+  if (fp == NULL) return false;
+
+  fprintf (fp, "{\n  \"enabled\": %s,\n  \"counters\": {", Metrics_Enabled () ? "true" : "false");
+  for (int index = 0; index < METRIC_COUNTER_COUNT; index++) {
+
+    fprintf (fp, "%s\n    \"%s\": %llu", index == 0 ? "" : ",", CounterNames[index], Counters[index]);
+  }
+
+  bool first = true;
+  fprintf (fp, "\n  },\n  \"operations_ns\": {");
+  for (int index = 0; index < METRIC_OPERATION_COUNT; index++) {
+
+    WriteHistogramJSON (fp, OperationNames[index], &Operations[index], &first);
+  }
+
+  // 명령 이름은 파싱 단계에서 영숫자로 제한되므로 이스케이프가 필요 없다
+  first = true;
+  fprintf (fp, "\n  },\n  \"commands_ns\": {");
+  for (int index = 0; index < NamedCount; index++) {
+
+    WriteHistogramJSON (fp, Named[index].Name, &Named[index].Latency, &first);
+  }
+  fprintf (fp, "\n  }\n}\n");
+  return ferror (fp) == 0;
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef _METRICS_H_
+#define _METRICS_H_
+
+#include <stdbool.h>
+#include <stdio.h>
+
+// 계측: 카운터와 로그-선형(HDR 방식) 지연 시간 히스토그램.
+// -DNO_TREE_METRICS 로 빌드하면 아래 매크로가 모두 빈 문장이 되어 핫 패스에 비용이 남지 않는다.
+
+// 2^m 구간마다 8 칸 (상대 오차 12.5% 이내), 16 미만은 값 그대로
+#define HISTOGRAM_SUB_BITS 3
+#define HISTOGRAM_BUCKETS (16 + 60 * (1 << HISTOGRAM_SUB_BITS))
+#define METRICS_MAX_NAMED 64
+#define METRIC_NAME_SIZE 32
+
+enum MetricCounterType {
+
+  METRIC_NODES_ALLOCATED,
+  METRIC_NODES_FREED,
+  METRIC_NODE_BYTES,         // 노드와 자식 배열로 할당한 바이트
+  METRIC_JSON_BYTES_WRITTEN,
+  METRIC_JSON_BYTES_READ,
+  METRIC_COUNTER_COUNT
+};
+
+enum MetricOperationType {
+
+  METRIC_OP_INSERT_CHILD,
+  METRIC_OP_INSERT_PARENT,
+  METRIC_OP_MOVE_SUBTREE,
+  METRIC_OP_CLONE_SUBTREE,
+  METRIC_OP_REMOVE,
+  METRIC_OP_CLEAR,
+  METRIC_OP_DETACH,
+  METRIC_OP_RECLAIM,
+  METRIC_OP_SET_DATA,
+  METRIC_OP_JSON_SAVE,
+  METRIC_OP_JSON_PARSE,
+  METRIC_OPERATION_COUNT
+};
+
+struct HistogramType {
+
+  unsigned long long Counts[HISTOGRAM_BUCKETS];
+  unsigned long long Total;
+  unsigned long long Sum;
+  unsigned long long Min;
+  unsigned long long Max;
+};
+
+void RecordHistogram (struct HistogramType* histogram, unsigned long long value);
+unsigned long long HistogramPercentile (const struct HistogramType* histogram, double percentile);
+
+unsigned long long Metric_Now (void);
+void Metric_Add (enum MetricCounterType counter, unsigned long long amount);
+void Metric_Record (enum MetricOperationType operation, unsigned long long nanoseconds);
+void Metric_RecordNamed (const char* name, unsigned long long nanoseconds);
+bool Metrics_Enabled (void);
+void ResetMetrics (void);
+void PrintMetrics (void);
+bool DumpMetricsJSON (FILE* fp);
+
+#ifndef NO_TREE_METRICS
+#define METRIC_ADD(counter, amount) Metric_Add ((counter), (amount))
+#define METRIC_START(timer) unsigned long long timer = Metric_Now ()
+#define METRIC_STOP(operation, timer) Metric_Record ((operation), Metric_Now () - (timer))
+#define METRIC_STOP_NAMED(name, timer) Metric_RecordNamed ((name), Metric_Now () - (timer))
+#else
+#define METRIC_ADD(counter, amount) ((void) 0)
+#define METRIC_START(timer) ((void) 0)
+#define METRIC_STOP(operation, timer) ((void) 0)
+#define METRIC_STOP_NAMED(name, timer) ((void) 0)
+#endif
+
+#endif
\ No newline at end of file
@@ -1,23 +1,248 @@
 #include "n_tree.h"
+#include "euler.h"
+#include "rollup.h"
+#include "deps.h"
+#include "attr.h"
+#include "pager.h"
+#include "metrics.h"
 #include <malloc.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
-struct ChildPositionsType {
+int ClearRecursive (struct N_TreeType* tree, struct TreeNodeType* node);
+int GetChildPosition (struct TreeNodeType* child, int childSize);
 
-  int positions[CHILD_SIZE];
-  int size;
-};
+// 자식 블록의 펜윅 트리: Ranks[i] 는 점유 비트 워드 (i & (i + 1)) ~ i 의 자식 수 합
+static int* Ranks (const struct TreeNodeType* node) {
 
-int ClearRecursive (struct TreeNodeType* node, int childSize);
+  return (int*) (Occupied_N_Tree (node) + CHILD_WORDS (node->Capacity));
+}
+
+static void AddRank (struct TreeNodeType* node, int word, int delta) {
+
+  int* ranks = Ranks (node);
+  for (int index = word; index < CHILD_WORDS (node->Capacity); index |= index + 1) ranks[index] += delta;
+}
+
+// 자식 블록을 slot 이 들어가는 크기로 늘린다 (두 배씩). 펜윅 트리는 새 크기로 다시 만든다.
+static bool GrowChildren (struct TreeNodeType* node, int slot) {
+
+  int capacity = node->Capacity > 0 ? node->Capacity : CHILD_MIN_CAPACITY;
+  while (capacity <= slot) capacity *= 2;
+
+  struct TreeNodeType** block = (struct TreeNodeType**) calloc (1, CHILD_BLOCK_BYTES (capacity));
+  if (block == NULL) {
+
+    printf ("Error! The dynamic memory allocation failed. GrowChildren()\n");
+    return false;
+  }
+
+  int words = CHILD_WORDS (capacity);
+  unsigned long long* bits = (unsigned long long*) (block + capacity);
+  int* ranks = (int*) (bits + words);
+  if (node->Capacity > 0) {
+
+    memcpy (block, node->Children, (size_t) node->Capacity * sizeof (struct TreeNodeType*));
+    memcpy (bits, Occupied_N_Tree (node), (size_t) CHILD_WORDS (node->Capacity) * sizeof (unsigned long long));
+  }
+  for (int index = 0; index < words; index++) {
+
+    ranks[index] += __builtin_popcountll (bits[index]);
+    int up = index | (index + 1);
+    if (up < words) ranks[up] += ranks[index];
+  }
+
+  if (!node->ChildrenInSlab) free (node->Children);
+  METRIC_ADD (METRIC_NODE_BYTES, CHILD_BLOCK_BYTES (capacity) - (node->Capacity > 0 ? CHILD_BLOCK_BYTES (node->Capacity) : 0));
+  node->Children = block;
+  node->Capacity = capacity;
+  node->ChildrenInSlab = false;
+  return true;
+}
+
+// slots 개의 슬롯을 미리 잡아 둔다 (여러 슬롯을 옮기는 도중에 할당이 실패하지 않도록)
+bool ReserveChildren_N_Tree (struct TreeNodeType* node, int slots) {
+
+  if (node == NULL) return false;
+  return slots <= node->Capacity || GrowChildren (node, slots - 1);
+}
+
+// 자식 슬롯을 바꾸면서 점유 비트와 순위 표도 맞춘다. 블록이 모자라면 늘린다 (실패하면 false).
+bool SetChild_N_Tree (struct TreeNodeType* node, int slot, struct TreeNodeType* child) {
+
+  if (slot >= node->Capacity) {
+
+    if (child == NULL) return true;
+    if (!GrowChildren (node, slot)) return false;
+  }
+
+  unsigned long long* word = &Occupied_N_Tree (node)[slot >> 6];
+  unsigned long long bit = 1ULL << (slot & 63);
+  bool was = (*word & bit) != 0;
+
+  node->Children[slot] = child;
+  if (child != NULL) child->Slot = slot;
+  if (child != NULL && !was) {
+
+    *word |= bit;
+    AddRank (node, slot >> 6, 1);
+  } else if (child == NULL && was) {
+
+    *word &= ~bit;
+    AddRank (node, slot >> 6, -1);
+  }
+  return true;
+}
+
+int ChildCount_N_Tree (const struct TreeNodeType* node) {
+
+  int count = 0;
+  const int* ranks = node->Capacity > 0 ? Ranks (node) : NULL;
+  for (int index = CHILD_WORDS (node->Capacity) - 1; index >= 0; index = (index & (index + 1)) - 1) count += ranks[index];
+  return count;
+}
+
+// 순서로 nth 번째 (0 부터) 자식의 슬롯 (없으면 -1). 펜윅 트리를 내려가 워드를 찾고 그 안에서 비트를 고른다.
+int NthChildSlot_N_Tree (const struct TreeNodeType* node, int nth) {
+
+  int words = CHILD_WORDS (node->Capacity);
+  if (nth < 0 || words == 0) return -1;
+
+  const int* ranks = Ranks (node);
+  int word = 0;
+  for (int step = 1 << (31 - __builtin_clz (words)); step > 0; step >>= 1) {
+
+    if (word + step <= words && ranks[word + step - 1] <= nth) {
+
+      word += step;
+      nth -= ranks[word - 1];
+    }
+  }
+  if (word >= words) return -1;
+
+  unsigned long long bits = Occupied_N_Tree (node)[word];
+  for (; nth > 0; nth--) bits &= bits - 1;
+  return word * 64 + __builtin_ctzll (bits);
+}
+
+// 머클 해시: 노드의 HashSum 은 레이블 해시에 (슬롯 가중치 × 자식 해시)를 더한 값이라
+// 자식 하나가 바뀌면 차이만 더해 주면 된다. 조상 경로를 따라 올라가며 한 단계씩 갱신한다.
+static unsigned long long MixBits (unsigned long long value) {
+
+  value ^= value >> 30;
+  value *= 0xbf58476d1ce4e5b9ULL;
+  value ^= value >> 27;
+  value *= 0x94d049bb133111ebULL;
+  return value ^ (value >> 31);
+}
+
+static unsigned long long SlotWeight (int slot) {
+
+  return MixBits ((unsigned long long) slot + 0x9e3779b97f4a7c15ULL) | 1ULL;
+}
+
+static unsigned long long HashLabel (struct N_TreeType* tree, LabelType label) {
+
+  unsigned long long hash = 0xcbf29ce484222325ULL;
+  for (const char* text = Label_Text (tree->Labels, label); *text; text++) {
+
+    hash ^= (unsigned char) *text;
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+// node 의 HashSum 이 바뀐 뒤 호출: Hash 를 다시 구하고 달라진 만큼 조상에 반영한다
+static void PropagateHash (struct N_TreeType* tree, struct TreeNodeType* node) {
+
+  while (node != NULL) {
+
+    unsigned long long old = node->Hash;
+    node->Hash = MixBits (node->HashSum);
+    if (node->Hash == old || node->Parent == NULL) return;
+
+    int slot = GetChildPosition (node, tree->ChildSize);
+    if (slot == -1) return;
+
+    node->Parent->HashSum += SlotWeight (slot) * (node->Hash - old);
+    node = node->Parent;
+  }
+}
+
+// parent 의 slot 에 있던 서브트리 해시가 before 에서 after 로 바뀌었음 (빈 슬롯은 0)
+static void ReplaceChildHash (struct N_TreeType* tree, struct TreeNodeType* parent, int slot, unsigned long long before, unsigned long long after) {
+
+  parent->HashSum += SlotWeight (slot) * (after - before);
+  PropagateHash (tree, parent);
+}
+
+// 지연 로딩 트리에서 자식이 아직 파일에만 있으면 먼저 읽는다
+static bool LoadChildren (struct N_TreeType* tree, struct TreeNodeType* node) {
+
+  return !node->Paged || Fault_N_Tree (tree, node);
+}
+
+unsigned long long Hash_N_Tree (struct TreeNodeType* node) {
+
+  return node == NULL ? 0 : node->Hash;
+}
+
+// 자식 배열을 직접 바꾼 뒤(자식 순서 변경 등) 호출: node 의 해시를 처음부터 다시 구해 조상에 반영한다
+void UpdateHash_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node) {
+
+  if (tree == NULL || node == NULL || !LoadChildren (tree, node)) return;
+
+  node->HashSum = HashLabel (tree, node->Label);
+  FOR_EACH_CHILD_SLOT (node, slot) {
+
+    node->HashSum += SlotWeight (slot) * node->Children[slot]->Hash;
+  }
+  PropagateHash (tree, node);
+}
+
+// 트리 전체의 해시를 다시 계산한다 (파일에서 읽거나 일괄 생성한 트리)
+void Rehash_N_Tree (struct N_TreeType* tree) {
+
+  if (tree == NULL || tree->Head == NULL) return;
+  if (!Renumber_N_Tree (tree)) return;
+
+  // 전위 순서의 역순이면 자식이 항상 부모보다 먼저 계산된다
+  for (int entry = tree->Euler->Size - 1; entry >= 0; entry--) {
+
+    struct TreeNodeType* node = tree->Euler->Order[entry];
+    node->HashSum = HashLabel (tree, node->Label);
+    FOR_EACH_CHILD_SLOT (node, slot) {
+
+      node->HashSum += SlotWeight (slot) * node->Children[slot]->Hash;
+    }
+    node->Hash = MixBits (node->HashSum);
+  }
+}
+
+bool Equal_N_Tree (struct N_TreeType* first, struct N_TreeType* second) {
+
+  if (first == NULL || second == NULL || first->Head == NULL || second->Head == NULL) return first == second;
+  return first->ChildSize == second->ChildSize && first->Head->Hash == second->Head->Hash;
+}
 
 struct N_TreeType* Create_N_Tree (int number_of_children) {
 
-  if (number_of_children < 1 || number_of_children > CHILD_SIZE) {
+  return Create_Payload_N_Tree (number_of_children, 0, NULL);
+}
+
+struct N_TreeType* Create_Payload_N_Tree (int number_of_children, int payloadSize, const struct PayloadCodecType* codec) {
+
+  if (number_of_children < 1 || number_of_children > CHILD_SIZE_MAX) {
 
     printf("Error! Invalid number_of_children: %d (must be between 1 and %d). Create_N_Tree()\n",
-               number_of_children, CHILD_SIZE);
+               number_of_children, CHILD_SIZE_MAX);
+    return NULL;
+  }
+  if (payloadSize < 0 || payloadSize > PAYLOAD_SIZE_MAX) {
+
+    printf("Error! Invalid payloadSize: %d (must be between 0 and %d). Create_Payload_N_Tree()\n",
+               payloadSize, PAYLOAD_SIZE_MAX);
     return NULL;
   }
 
@@ -28,7 +253,9 @@ struct N_TreeType* Create_N_Tree (int number_of_children) {
     return NULL;
   }
 
-  tree->Head = (struct TreeNodeType*) calloc (1, sizeof (struct TreeNodeType));
+  tree->PayloadSize = payloadSize;
+  tree->Codec = codec;
+  tree->Head = (struct TreeNodeType*) calloc (1, NODE_BYTES (tree));
   if (tree->Head == NULL) {
 
     printf ("Error! The dynamic memory allocation failed(2). Create_N_Tree().\n");
@@ -36,10 +263,28 @@ struct N_TreeType* Create_N_Tree (int number_of_children) {
     return NULL;
   }
 
-  tree->Head->Children = (struct TreeNodeType**) calloc (number_of_children, sizeof (struct TreeNodeType*));
-  if (tree->Head->Children == NULL) {
+  tree->Labels = Create_Label_Pool ();
+  if (tree->Labels == NULL) {
 
-    printf ("Error! The dynamic memory allocation failed(3). Create_N_Tree().\n");
+    printf ("Error! The dynamic memory allocation failed(4). Create_N_Tree().\n");
+    free (tree->Head);
+    free (tree);
+    return NULL;
+  }
+
+  tree->Nodes = NULL;
+  tree->NodeCapacity = 0;
+  tree->NextId = 0;
+  tree->Attributes = NULL;
+  tree->Dependencies = NULL;
+  tree->Pager = NULL;
+  tree->Garbage.Items = NULL;
+  tree->Garbage.Size = 0;
+  tree->Garbage.Capacity = 0;
+  if (!RegisterNode_N_Tree (tree, tree->Head)) {
+
+    printf ("Error! The dynamic memory allocation failed(5). Create_N_Tree().\n");
+    Delete_Label_Pool (tree->Labels);
     free (tree->Head);
     free (tree);
     return NULL;
@@ -47,6 +292,11 @@ struct N_TreeType* Create_N_Tree (int number_of_children) {
 
   tree->ChildSize = number_of_children;
   tree->Count = 0;
+  tree->Euler = NULL;
+  tree->Rollup = NULL;
+  tree->Slabs = NULL;
+  tree->Head->HashSum = HashLabel (tree, tree->Head->Label);
+  tree->Head->Hash = MixBits (tree->Head->HashSum);
   return tree;
 }
 
@@ -59,31 +309,117 @@ struct TreeNodeType* Access_N_Tree (struct N_TreeType* tree, struct TreeNodeType
       position, tree->ChildSize - 1);
     return NULL;
   }
+  if (tree->Pager != NULL && !Fault_N_Tree (tree, parent)) return NULL;
+
+  return ChildAt_N_Tree (parent, position);
+}
+
+bool RegisterNode_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node) {
+
+  if (tree == NULL || node == NULL) return false;
+
+  if (tree->NextId == tree->NodeCapacity) {
+
+    int capacity = tree->NodeCapacity == 0 ? 256 : tree->NodeCapacity * 2;
+    struct TreeNodeType** nodes = (struct TreeNodeType**) realloc (tree->Nodes, capacity * sizeof (struct TreeNodeType*));
+    if (nodes == NULL) return false;
+
+    tree->Nodes = nodes;
+    tree->NodeCapacity = capacity;
+  }
+
+  node->Id = tree->NextId++;
+  tree->Nodes[node->Id] = node;
+  if (tree->Dependencies != NULL) OrderNewNode_N_Tree (tree, node);
+  return true;
+}
+
+// 외부에서 만든 서브트리(파일에서 읽은 트리 등)에 전위 순서로 번호를 매긴다
+bool RegisterNodes_N_Tree (struct N_TreeType* tree, struct TreeNodeType* root) {
+
+  if (tree == NULL || root == NULL) return false;
+
+  struct NodeListType stack = { NULL, 0, 0 };
+  if (!AppendNodeList (&stack, root)) return false;
+
+  while (stack.Size > 0) {
+
+    struct TreeNodeType* node = stack.Items[--stack.Size];
+    if (!RegisterNode_N_Tree (tree, node)) {
+
+      FreeNodeList (&stack);
+      return false;
+    }
+
+    FOR_EACH_CHILD_SLOT_REVERSE (node, index) {
+
+      if (!AppendNodeList (&stack, node->Children[index])) {
+
+        FreeNodeList (&stack);
+        return false;
+      }
+    }
+  }
 
-  return parent->Children[position];
+  FreeNodeList (&stack);
+  return true;
 }
 
-struct TreeNodeType* MakeTreeNode (struct TreeNodeType* parent, char* data, int childSize) {
+struct TreeNodeType* NodeById_N_Tree (struct N_TreeType* tree, int id) {
+
+  if (tree == NULL || id < 0 || id >= tree->NextId) return NULL;
+  return tree->Nodes[id];
+}
+
+const char* Data_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node) {
+
+  if (tree == NULL || node == NULL) return "";
+  return Label_Text (tree->Labels, node->Label);
+}
+
+bool SetData_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, const char* data) {
+
+  if (tree == NULL || node == NULL || data == NULL || !LoadChildren (tree, node)) return false;
+
+  METRIC_START (timer);
+  LabelType label = Intern_Label (tree->Labels, data);
+  if (label == LABEL_NONE) return false;
+  if (label == node->Label) return true;
 
-  struct TreeNodeType* newNode = (struct TreeNodeType*) calloc (1, sizeof (struct TreeNodeType));
+  node->HashSum += HashLabel (tree, label) - HashLabel (tree, node->Label);
+  node->Label = label;
+  PropagateHash (tree, node);
+  METRIC_STOP (METRIC_OP_SET_DATA, timer);
+  return true;
+}
+
+struct TreeNodeType* MakeTreeNode (struct N_TreeType* tree, struct TreeNodeType* parent, char* data) {
+
+  LabelType label = Intern_Label (tree->Labels, data);
+  if (label == LABEL_NONE) return NULL;
+
+
+  struct TreeNodeType* newNode = (struct TreeNodeType*) calloc (1, NODE_BYTES (tree));
   if (newNode == NULL) {
 
     printf ("Error! The dynamic memory allocation failed. MakeTreeNode()\n");
     return NULL;
   }
 
-  newNode->Children = (struct TreeNodeType**) calloc (childSize, sizeof (struct TreeNodeType*));
-  if (newNode->Children == NULL) {
- 
+  newNode->Label = label;
+  newNode->Parent = parent;
+  newNode->HashSum = HashLabel (tree, label);
+  newNode->Hash = MixBits (newNode->HashSum);
+
+  if (!RegisterNode_N_Tree (tree, newNode)) {
+
     printf ("Error! The dynamic memory allocation failed. MakeTreeNode()\n");
     free (newNode);
     return NULL;
   }
 
-  strncpy(newNode->Data, data, SIZE - 1);
-  newNode->Data[SIZE - 1] = '\0';
-  newNode->Parent = parent;
-
+  METRIC_ADD (METRIC_NODES_ALLOCATED, 1);
+  METRIC_ADD (METRIC_NODE_BYTES, NODE_BYTES (tree));
   return newNode;
 }
 
@@ -105,38 +441,56 @@ void Insert_ChildNode_N_Tree (struct N_TreeType* tree, struct TreeNodeType* pare
       position, tree->ChildSize - 1);
     return;
   }
-  if (parent->Children[position] != NULL) {
+  if (!LoadChildren (tree, parent)) return;
+  if (ChildAt_N_Tree (parent, position) != NULL) {
 
     printf("Error! Position %d is already occupied. Insert_ChildNode_N_Tree()\n", position);
     return;
   }
 
-  struct TreeNodeType* newNode = MakeTreeNode(parent, data, tree->ChildSize);
+  METRIC_START (timer);
+  struct TreeNodeType* newNode = MakeTreeNode(tree, parent, data);
   if (newNode == NULL) return;
 
-  if (parent->Children[position] == NULL) {
+  if (ChildAt_N_Tree (parent, position) == NULL) {
 
-    parent->Children[position] = newNode;
+    if (!SetChild_N_Tree (parent, position, newNode)) {
+
+      FreeTreeNode (tree, newNode);
+      return;
+    }
+    ReplaceChildHash (tree, parent, position, 0, newNode->Hash);
     tree->Count++;
+    Invalidate_Euler_Index (tree);
+    UpdateRollup_N_Tree (tree, newNode);
+    METRIC_STOP (METRIC_OP_INSERT_CHILD, timer);
     return;
   }
 
   struct TreeNodeType* childNode = parent->Children[position];
+  if (!SetChild_N_Tree (newNode, 0, childNode)) {
+
+    FreeTreeNode (tree, newNode);
+    return;
+  }
   childNode->Parent = newNode;
-  newNode->Children[0] = childNode;
   newNode->Parent = parent;
-  parent->Children[position] = newNode;
+  SetChild_N_Tree (parent, position, newNode);
+  newNode->HashSum += SlotWeight (0) * childNode->Hash;
+  newNode->Hash = MixBits (newNode->HashSum);
+  ReplaceChildHash (tree, parent, position, childNode->Hash, newNode->Hash);
   tree->Count++;
+  Invalidate_Euler_Index (tree);
+  UpdateRollup_N_Tree (tree, newNode);
+  METRIC_STOP (METRIC_OP_INSERT_CHILD, timer);
   return;
 }
 
 int GetChildPosition (struct TreeNodeType* child, int childSize) {
 
   struct TreeNodeType* parent = child->Parent;
-  for (int index = 0; index < childSize; index++) {
-
-    if (parent->Children[index] == child) return index;
-  }
+  if (parent == NULL) return -1;
+  if (child->Slot < childSize && ChildAt_N_Tree (parent, child->Slot) == child) return child->Slot;
 
   return -1;
 }
@@ -159,38 +513,280 @@ void Insert_ParentNode_N_Tree (struct N_TreeType* tree, struct TreeNodeType* chi
     return;
   }
 
-  struct TreeNodeType* newNode = MakeTreeNode (child->Parent, data, tree->ChildSize);
+  METRIC_START (timer);
+  struct TreeNodeType* newNode = MakeTreeNode (tree, child->Parent, data);
   if (newNode == NULL) return;
 
   int position = GetChildPosition(child, tree->ChildSize);
   if (position == -1) {
 
-    ClearRecursive(newNode, tree->ChildSize);
+    ClearRecursive(tree, newNode);
     return;
   }
 
   struct TreeNodeType* parentNode = child->Parent;
+  if (!SetChild_N_Tree (newNode, 0, child)) {
+
+    FreeTreeNode (tree, newNode);
+    return;
+  }
   child->Parent = newNode;
-  newNode->Children[0] = child;
   newNode->Parent = parentNode;
-  parentNode->Children[position] = newNode;
+  SetChild_N_Tree (parentNode, position, newNode);
+
+  newNode->HashSum += SlotWeight (0) * child->Hash;
+  newNode->Hash = MixBits (newNode->HashSum);
+  ReplaceChildHash (tree, parentNode, position, child->Hash, newNode->Hash);
 
   tree->Count++;
+  Invalidate_Euler_Index (tree);
+  UpdateRollup_N_Tree (tree, newNode);
+  OrderNewParent_N_Tree (tree, newNode);
+  METRIC_STOP (METRIC_OP_INSERT_PARENT, timer);
   return;
 }
 
-struct ChildPositionsType GetChildIndices (struct TreeNodeType* child, int childSize) {
+bool Move_Subtree_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, struct TreeNodeType* newParent, int position) {
+
+  if (tree == NULL || tree->Head == NULL) {
+
+    printf("Error! N_TreeType pointer is NULL. Move_Subtree_N_Tree()\n");
+    return false;
+  }
+  if (node == NULL || newParent == NULL) {
+
+    printf("Error! Node or new parent is NULL. Move_Subtree_N_Tree()\n");
+    return false;
+  }
+  if (node == tree->Head) {
+
+    printf("Error! Cannot move the head node. Move_Subtree_N_Tree()\n");
+    return false;
+  }
+  if (position < 0 || position >= tree->ChildSize) {
+
+    printf("Error! position %d is out of range (0 ~ %d). Move_Subtree_N_Tree()\n",
+      position, tree->ChildSize - 1);
+    return false;
+  }
+  if (!LoadChildren (tree, newParent)) return false;
+  if (ChildAt_N_Tree (newParent, position) != NULL) {
+
+    printf("Error! Position %d is already occupied. Move_Subtree_N_Tree()\n", position);
+    return false;
+  }
+
+  METRIC_START (timer);
+  // 목적지가 옮길 서브트리 안에 있으면 순환이 생긴다
+  for (struct TreeNodeType* ancestor = newParent; ancestor != NULL; ancestor = ancestor->Parent) {
+
+    if (ancestor == node) {
+
+      printf("Error! Cannot move a node under its own subtree. Move_Subtree_N_Tree()\n");
+      return false;
+    }
+  }
+  // 옮긴 서브트리 안의 노드가 새 조상을 기다리면 끝날 수 없다
+  if (!OrderMove_N_Tree (tree, node, newParent)) return false;
+
+  int oldPosition = GetChildPosition (node, tree->ChildSize);
+  if (oldPosition == -1) return false;
+
+  // 새 자리를 먼저 잡는다 (자식 블록을 늘리다 실패하면 아무것도 바꾸지 않음)
+  struct TreeNodeType* oldParent = node->Parent;
+  if (!SetChild_N_Tree (newParent, position, node)) return false;
+  SetChild_N_Tree (oldParent, oldPosition, NULL);
+  ReplaceChildHash (tree, oldParent, oldPosition, node->Hash, 0);
+  node->Parent = newParent;
+  ReplaceChildHash (tree, newParent, position, 0, node->Hash);
+
+  Invalidate_Euler_Index (tree);
+  UpdateRollup_N_Tree (tree, oldParent);
+  UpdateRollup_N_Tree (tree, newParent);
+  METRIC_STOP (METRIC_OP_MOVE_SUBTREE, timer);
+  return true;
+}
+
+// 자식이 있는 가장 큰 슬롯 (자식이 없으면 -1)
+static int LastChildSlot (const struct TreeNodeType* node) {
 
-  struct ChildPositionsType result = { 0, };
-  int location = 0;
-  for (int index = 0; index < childSize; index++) {
-    if (child->Children[index] == NULL) continue;
+  for (int word = CHILD_WORDS (node->Capacity) - 1; word >= 0; word--) {
 
-    result.positions[location++] = index;
+    unsigned long long bits = Occupied_N_Tree (node)[word];
+    if (bits != 0) return word * 64 + 63 - __builtin_clzll (bits);
   }
-  result.size = location;
+  return -1;
+}
+
+// 복사본의 자식 블록 크기 (가장 큰 슬롯이 들어가는 2 의 거듭제곱, 리프는 0)
+static int CloneCapacity (const struct TreeNodeType* node) {
+
+  int last = LastChildSlot (node);
+  if (last == -1) return 0;
 
-  return result;
+  int capacity = CHILD_MIN_CAPACITY;
+  while (capacity <= last) capacity *= 2;
+  return capacity;
+}
+
+// source 서브트리를 복사해 newParent 의 position 슬롯에 단다. 복사본의 노드와 자식 블록은 블록 하나로 할당한다.
+// 레이블은 같은 트리의 문자열 표를 함께 쓰고, 사용자 데이터와 속성은 노드마다 복사한다. 복사본의 루트를 돌려준다.
+struct TreeNodeType* Clone_Subtree_N_Tree (struct N_TreeType* tree, struct TreeNodeType* source, struct TreeNodeType* newParent, int position) {
+
+  if (tree == NULL || tree->Head == NULL) {
+
+    printf("Error! N_TreeType pointer is NULL. Clone_Subtree_N_Tree()\n");
+    return NULL;
+  }
+  if (source == NULL || newParent == NULL) {
+
+    printf("Error! Source node or new parent is NULL. Clone_Subtree_N_Tree()\n");
+    return NULL;
+  }
+  if (position < 0 || position >= tree->ChildSize) {
+
+    printf("Error! position %d is out of range (0 ~ %d). Clone_Subtree_N_Tree()\n",
+      position, tree->ChildSize - 1);
+    return NULL;
+  }
+  if (!LoadChildren (tree, newParent)) return NULL;
+  if (ChildAt_N_Tree (newParent, position) != NULL) {
+
+    printf("Error! Position %d is already occupied. Clone_Subtree_N_Tree()\n", position);
+    return NULL;
+  }
+  const struct PayloadCodecType* codec = tree->Codec;
+  if (codec != NULL && codec->Release != NULL && codec->Copy == NULL) {
+
+    printf("Error! Payloads that own resources need a Copy callback. Clone_Subtree_N_Tree()\n");
+    return NULL;
+  }
+  // 다는 자리를 먼저 잡아 두면 복사한 뒤에는 실패하지 않는다
+  if (!ReserveChildren_N_Tree (newParent, position + 1)) return NULL;
+
+  METRIC_START (timer);
+  // 너비 우선으로 원본 노드를 모으며 크기를 센다. 노드 i 의 자식은 목록에서 연달아 놓이므로
+  // 복사할 때 자식의 번호를 따로 기억하지 않아도 된다.
+  struct NodeListType sources = { NULL, 0, 0 };
+  size_t childBytes = 0;
+  if (!AppendNodeList (&sources, source)) {
+
+    printf ("Error! The dynamic memory allocation failed. Clone_Subtree_N_Tree()\n");
+    return NULL;
+  }
+  for (long index = 0; index < sources.Size; index++) {
+
+    struct TreeNodeType* node = sources.Items[index];
+    if (!LoadChildren (tree, node)) {
+
+      FreeNodeList (&sources);
+      return NULL;
+    }
+
+    int capacity = CloneCapacity (node);
+    if (capacity > 0) childBytes += CHILD_BLOCK_BYTES (capacity);
+    bool appended = true;
+    FOR_EACH_CHILD_SLOT (node, slot) {
+
+      if (appended) appended = AppendNodeList (&sources, node->Children[slot]);
+    }
+    if (!appended) {
+
+      printf ("Error! The dynamic memory allocation failed. Clone_Subtree_N_Tree()\n");
+      FreeNodeList (&sources);
+      return NULL;
+    }
+  }
+
+  // 노드 크기를 8 바이트 단위로 맞춰 사용자 데이터가 있어도 다음 노드가 정렬되게 한다
+  long count = sources.Size;
+  size_t stride = (NODE_BYTES (tree) + 7) & ~(size_t) 7;
+  size_t nodeBytes = (size_t) count * stride;
+  struct NodeSlabType* slab = (struct NodeSlabType*) calloc (1, sizeof (struct NodeSlabType));
+  char* memory = (char*) calloc (1, nodeBytes + childBytes);
+  if (slab == NULL || memory == NULL) {
+
+    printf ("Error! The dynamic memory allocation failed. Clone_Subtree_N_Tree()\n");
+    FreeNodeList (&sources);
+    free (slab);
+    free (memory);
+    return NULL;
+  }
+
+  char* children = memory + nodeBytes;
+  long next = 1;
+  long copied = 0;
+  long index = 0;
+  for (; index < count; index++) {
+
+    struct TreeNodeType* original = sources.Items[index];
+    struct TreeNodeType* node = (struct TreeNodeType*) (memory + (size_t) index * stride);
+
+    node->Label = original->Label;
+    node->Hash = original->Hash;
+    node->HashSum = original->HashSum;
+    node->InSlab = true;
+    if (codec == NULL || codec->Copy == NULL) memcpy (node->Payload, original->Payload, (size_t) tree->PayloadSize);
+    else if (!codec->Copy (node->Payload, original->Payload, (size_t) tree->PayloadSize)) break;
+    copied++;
+
+    int capacity = CloneCapacity (original);
+    if (capacity > 0) {
+
+      node->Children = (struct TreeNodeType**) children;
+      node->Capacity = capacity;
+      node->ChildrenInSlab = true;
+      children += CHILD_BLOCK_BYTES (capacity);
+    }
+    FOR_EACH_CHILD_SLOT (original, slot) {
+
+      struct TreeNodeType* child = (struct TreeNodeType*) (memory + (size_t) next++ * stride);
+      SetChild_N_Tree (node, slot, child);
+      child->Parent = node;
+    }
+
+    if (!RegisterNode_N_Tree (tree, node) || !CopyAttributes_N_Tree (tree, node, tree, original)) break;
+  }
+
+  // 복사가 중간에 실패하면 이미 등록한 복사본을 지우고 블록째 해제한다
+  if (index < count) {
+
+    printf ("Error! Copying node %ld of the subtree failed. Clone_Subtree_N_Tree()\n", index);
+    for (long undo = 0; undo < copied; undo++) {
+
+      struct TreeNodeType* node = (struct TreeNodeType*) (memory + (size_t) undo * stride);
+      if (codec != NULL && codec->Release != NULL) codec->Release (node->Payload);
+      if (NodeById_N_Tree (tree, node->Id) != node) continue;
+
+      ClearAttributes_N_Tree (tree, node->Id);
+      tree->Nodes[node->Id] = NULL;
+    }
+    FreeNodeList (&sources);
+    free (slab);
+    free (memory);
+    return NULL;
+  }
+  FreeNodeList (&sources);
+
+  slab->Memory = memory;
+  slab->Next = tree->Slabs;
+  tree->Slabs = slab;
+
+  struct TreeNodeType* root = (struct TreeNodeType*) memory;
+  SetChild_N_Tree (newParent, position, root);
+  root->Parent = newParent;
+  ReplaceChildHash (tree, newParent, position, 0, root->Hash);
+  tree->Count += (int) count;
+
+  // 너비 우선의 역순이면 자식의 합계가 부모보다 먼저 채워진다
+  for (long back = count - 1; back >= 0; back--) RefreshRollup_N_Tree (tree, (struct TreeNodeType*) (memory + (size_t) back * stride));
+  UpdateRollup_N_Tree (tree, newParent);
+
+  METRIC_ADD (METRIC_NODES_ALLOCATED, count);
+  METRIC_ADD (METRIC_NODE_BYTES, nodeBytes + childBytes);
+  Invalidate_Euler_Index (tree);
+  METRIC_STOP (METRIC_OP_CLONE_SUBTREE, timer);
+  return root;
 }
 
 bool Remove_N_Tree (struct N_TreeType* tree, struct TreeNodeType* target, bool clearAll) {
@@ -210,65 +806,233 @@ bool Remove_N_Tree (struct N_TreeType* tree, struct TreeNodeType* target, bool c
   int childSize = tree->ChildSize;
   int targetPosition = GetChildPosition(target, childSize);
 
+  // 통째 삭제는 clear 로 잰다
   if (clearAll) {
 
-    parentNode->Children[targetPosition] = NULL;
     Clear_N_Tree (tree, target);
     return true;
   }
 
-  struct ChildPositionsType childPositions = GetChildIndices (target, childSize);
+  METRIC_START (timer);
 
-  if (childPositions.size > 1) return false;
-  if (childPositions.size == 0) {
+  if (!LoadChildren (tree, target)) return false;
+  int children = ChildCount_N_Tree (target);
 
-    parentNode->Children[targetPosition] = NULL;
+  if (children > 1) return false;
+  if (children == 0) {
 
-    free (target->Children);
-    free (target);
+    SetChild_N_Tree (parentNode, targetPosition, NULL);
+    ReplaceChildHash (tree, parentNode, targetPosition, target->Hash, 0);
+
+    FreeTreeNode (tree, target);
 
     tree->Count--;
+    Invalidate_Euler_Index (tree);
+    UpdateRollup_N_Tree (tree, parentNode);
+    METRIC_STOP (METRIC_OP_REMOVE, timer);
     return true;
   }
   // if target child is 1.
-  struct TreeNodeType* childNode = target->Children[childPositions.positions[0]];
+  struct TreeNodeType* childNode = target->Children[FirstChildSlot_N_Tree (target)];
   childNode->Parent = parentNode;
-  parentNode->Children[targetPosition] = childNode;
+  SetChild_N_Tree (parentNode, targetPosition, childNode);
+  ReplaceChildHash (tree, parentNode, targetPosition, target->Hash, childNode->Hash);
 
-  free (target->Children);
-  free (target);
+  FreeTreeNode (tree, target);
 
   tree->Count--;
+  Invalidate_Euler_Index (tree);
+  UpdateRollup_N_Tree (tree, parentNode);
+  METRIC_STOP (METRIC_OP_REMOVE, timer);
   return true;
 }
 
-int ClearRecursive (struct TreeNodeType* node, int childSize) {
+void FreeTreeNode (struct N_TreeType* tree, struct TreeNodeType* node) {
 
-  if (node == NULL) return 0;
+  if (node == NULL) return;
 
-  int count = 1;
-  for (int index = 0; index < childSize; index++) {
+  if (tree != NULL && NodeById_N_Tree (tree, node->Id) == node) {
 
-    count += ClearRecursive (node->Children[index], childSize);
+    ClearAttributes_N_Tree (tree, node->Id);
+    ClearDependencies_N_Tree (tree, node->Id);
+    tree->Nodes[node->Id] = NULL;
   }
-  free (node->Children);
+  METRIC_ADD (METRIC_NODES_FREED, 1);
+  if (tree != NULL && tree->Codec != NULL && tree->Codec->Release != NULL) tree->Codec->Release (node->Payload);
+  // 슬랩에 속한 노드는 트리를 삭제할 때 블록째 해제된다
+  if (!node->ChildrenInSlab) free (node->Children);
+  if (node->InSlab) return;
+
   free (node);
+}
+
+int ClearRecursive (struct N_TreeType* tree, struct TreeNodeType* node) {
+
+  if (node == NULL) return 0;
+
+  // 읽지 않은 서브트리는 조각에 기록된 크기만큼 줄어든다
+  int count = node->Paged ? PagedSize_N_Tree (tree, node) : 1;
+  FOR_EACH_CHILD_SLOT (node, index) {
+
+    count += ClearRecursive (tree, node->Children[index]);
+  }
+  FreeTreeNode (tree, node);
   return count;
 }
 
 void Clear_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node) {
 
   if (tree == NULL || node == NULL) return;
-  int count = ClearRecursive (node, tree->ChildSize);
+
+  METRIC_START (timer);
+  // 부모에서 떼어 낸 뒤 해제한다
+  struct TreeNodeType* parent = node->Parent;
+  if (node->Parent != NULL) {
+
+    int position = GetChildPosition (node, tree->ChildSize);
+    if (position != -1) {
+
+      SetChild_N_Tree (node->Parent, position, NULL);
+      ReplaceChildHash (tree, node->Parent, position, node->Hash, 0);
+    }
+  }
+  int count = ClearRecursive (tree, node);
   tree->Count -= count;
+  Invalidate_Euler_Index (tree);
+  UpdateRollup_N_Tree (tree, parent);
+  METRIC_STOP (METRIC_OP_CLEAR, timer);
   return;
 }
 
+// node 를 부모에서 떼어 내 Garbage 에 넣는다 (루트면 자식을 모두 떼어 냄). 해제는 Reclaim_N_Tree 가 나누어 한다.
+// 떼기만 하므로 서브트리 크기와 상관없이 끝난다. 노드 수, 속성, 간선은 해제할 때 맞춘다.
+bool Detach_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node) {
+
+  if (tree == NULL || tree->Head == NULL || node == NULL) {
+
+    printf("Error! Invalid arguments. Detach_N_Tree()\n");
+    return false;
+  }
+
+  // 지연 로딩 트리는 페이지 내보내기가 떼어 낸 노드를 건드릴 수 있어 바로 해제한다
+  if (tree->Pager != NULL) {
+
+    if (node != tree->Head) {
+
+      Clear_N_Tree (tree, node);
+      return true;
+    }
+    FOR_EACH_CHILD_SLOT (node, slot) {
+
+      Clear_N_Tree (tree, node->Children[slot]);
+    }
+    return true;
+  }
+
+  METRIC_START (timer);
+  if (node == tree->Head) {
+
+    FOR_EACH_CHILD_SLOT (node, slot) {
+
+      struct TreeNodeType* child = node->Children[slot];
+      SetChild_N_Tree (node, slot, NULL);
+      child->Parent = NULL;
+      // 목록을 늘리지 못하면 그 자식만 바로 해제한다
+      if (!AppendNodeList (&tree->Garbage, child)) tree->Count -= ClearRecursive (tree, child);
+    }
+    node->HashSum = HashLabel (tree, node->Label);
+    node->Hash = MixBits (node->HashSum);
+    UpdateRollup_N_Tree (tree, node);
+  } else {
+
+    int position = GetChildPosition (node, tree->ChildSize);
+    if (position == -1 || !AppendNodeList (&tree->Garbage, node)) return false;
+
+    struct TreeNodeType* parent = node->Parent;
+    SetChild_N_Tree (parent, position, NULL);
+    ReplaceChildHash (tree, parent, position, node->Hash, 0);
+    node->Parent = NULL;
+    UpdateRollup_N_Tree (tree, parent);
+  }
+
+  Invalidate_Euler_Index (tree);
+  METRIC_STOP (METRIC_OP_DETACH, timer);
+  return true;
+}
+
+// 떼어 낸 노드를 budget 개까지 해제한다 (0 이하면 모두). 해제한 노드 수를 돌려준다.
+// 노드마다 속성과 간선도 지우고 Count 에서 뺀다.
+long Reclaim_N_Tree (struct N_TreeType* tree, long budget) {
+
+  if (tree == NULL || tree->Garbage.Size == 0) return 0;
+
+  METRIC_START (timer);
+  long freed = 0;
+  while (tree->Garbage.Size > 0 && (budget <= 0 || freed < budget)) {
+
+    struct TreeNodeType* node = tree->Garbage.Items[--tree->Garbage.Size];
+    FOR_EACH_CHILD_SLOT (node, slot) {
+
+      if (!AppendNodeList (&tree->Garbage, node->Children[slot])) freed += ClearRecursive (tree, node->Children[slot]);
+    }
+    FreeTreeNode (tree, node);
+    freed++;
+  }
+
+  tree->Count -= freed;
+  if (tree->Garbage.Size == 0) FreeNodeList (&tree->Garbage);
+  METRIC_STOP (METRIC_OP_RECLAIM, timer);
+  return freed;
+}
+
 void Delete_N_Tree (struct N_TreeType* tree) {
 
   if (tree == NULL) return;
 
-  ClearRecursive (tree->Head, tree->ChildSize);
+  // 노드마다 간선을 지우지 않도록 먼저 버린다
+  Delete_Dependencies (tree);
+  Reclaim_N_Tree (tree, 0);
+  ClearRecursive (tree, tree->Head);
+  Delete_Euler_Index (tree);
+  Delete_Rollup (tree);
+  Delete_Label_Pool (tree->Labels);
+  Delete_Attribute_Table (tree->Attributes);
+  Delete_Pager (tree->Pager);
+  free (tree->Nodes);
+
+  while (tree->Slabs != NULL) {
+
+    struct NodeSlabType* slab = tree->Slabs;
+    tree->Slabs = slab->Next;
+    free (slab->Memory);
+    free (slab);
+  }
   free (tree);
   return;
 }
+
+bool AppendNodeList (struct NodeListType* list, struct TreeNodeType* node) {
+
+  if (list->Size == list->Capacity) {
+
+    long capacity = list->Capacity == 0 ? 64 : list->Capacity * 2;
+    struct TreeNodeType** items = (struct TreeNodeType**) realloc (list->Items, capacity * sizeof (struct TreeNodeType*));
+    if (items == NULL) return false;
+
+    list->Items = items;
+    list->Capacity = capacity;
+  }
+
+  list->Items[list->Size++] = node;
+  return true;
+}
+
+void FreeNodeList (struct NodeListType* list) {
+
+  if (list == NULL) return;
+
+  free (list->Items);
+  list->Items = NULL;
+  list->Size = 0;
+  list->Capacity = 0;
+}
\ No newline at end of file
@@ -2,30 +2,204 @@
 #define _N_TREE_H_
 
 #include <stdbool.h>
+#include <stdio.h>
+#include "intern.h"
 
-#define CHILD_SIZE 128
-#define SIZE 32
+#define CHILD_SIZE 128          // 기본 자식 수 (CLI 가 새 트리를 만들 때)
+#define CHILD_SIZE_MAX 65535     // ChildSize 상한 (스냅숏이 슬롯 번호를 16 비트로 기록)
+#define CHILD_MIN_CAPACITY 4     // 자식 배열을 처음 만들 때의 칸 수
+#define PAYLOAD_SIZE_MAX 65536   // 노드 안에 두는 사용자 데이터의 최대 바이트
+
+// 자식 블록: [Capacity 개의 자식 포인터][점유 비트 워드][워드별 자식 수의 펜윅 트리]
+// Capacity 는 2 의 거듭제곱이고 필요한 슬롯을 넘으면 두 배로 늘린다 (자식이 없으면 블록도 없다).
+#define CHILD_WORDS(capacity) (((capacity) + 63) >> 6)
+#define CHILD_BLOCK_BYTES(capacity) (((size_t) (capacity) * sizeof (struct TreeNodeType*) + \
+  (size_t) CHILD_WORDS (capacity) * (sizeof (unsigned long long) + sizeof (int)) + 7) & ~(size_t) 7)
 
 struct TreeNodeType {
 
-  char Data[SIZE];
+  LabelType Label;  // 트리의 Labels 표에 등록된 데이터 핸들
+  int Id;           // 트리 안에서 고유한 노드 번호 (속성 표의 키)
   struct TreeNodeType* Parent;
-  struct TreeNodeType** Children;
+  struct TreeNodeType** Children;  // 자식 블록 (SetChild_N_Tree 로만 바꾸고, Capacity 밖의 슬롯은 비어 있다)
+  int Capacity;
+  int Slot;   // 부모의 몇 번째 슬롯에 달려 있는지 (SetChild_N_Tree 가 기록)
+  int Entry;  // 전위 진입 번호 (euler.c 가 지연 갱신)
+  int Exit;   // 서브트리 끝 번호 (Exit - Entry 가 서브트리 크기)
+  int Depth;
+  unsigned long long Hash;     // 서브트리 해시 (레이블 + 슬롯 순서의 자식 해시)
+  unsigned long long HashSum;  // 레이블 해시 + Σ 슬롯 가중치 × 자식 해시 (Hash 는 이것을 섞은 값)
+  bool InSlab;          // 일괄 할당된 노드는 개별로 free 하지 않는다
+  bool ChildrenInSlab;  // 자식 블록도 일괄 할당 블록 안에 있다 (늘릴 때 새로 할당)
+  bool Paged;   // 자식이 아직 스냅숏 파일에만 있다 (pager.c 가 처음 방문할 때 읽음)
+  _Alignas (8) unsigned char Payload[];  // 트리의 PayloadSize 바이트 (노드와 같은 할당, 0 으로 시작)
+};
+
+// 노드 하나를 할당할 때의 크기
+#define NODE_BYTES(tree) (sizeof (struct TreeNodeType) + (size_t) (tree)->PayloadSize)
+
+// 사용자 데이터 직렬화 (pack.c 가 노드마다 부른다). Write/Read 가 NULL 이면 바이트를 그대로 쓰고 읽는다.
+// Release 는 노드를 해제하기 직전에 부른다 (데이터가 따로 잡은 자원이 없으면 NULL).
+// Copy 는 서브트리를 복사할 때 source 를 payload 로 복사한다 (NULL 이면 바이트 복사, Release 가 있으면 반드시 필요).
+struct PayloadCodecType {
+
+  bool (*Write) (FILE* fp, const void* payload, size_t size);
+  bool (*Read) (FILE* fp, void* payload, size_t size);
+  void (*Release) (void* payload);
+  bool (*Copy) (void* payload, const void* source, size_t size);
+};
+
+static inline unsigned long long* Occupied_N_Tree (const struct TreeNodeType* node) {
+
+  return (unsigned long long*) (node->Children + node->Capacity);
+}
+
+// slot 의 자식 (Capacity 밖이면 NULL)
+static inline struct TreeNodeType* ChildAt_N_Tree (const struct TreeNodeType* node, int slot) {
+
+  return slot >= 0 && slot < node->Capacity ? node->Children[slot] : NULL;
+}
+
+// 가장 앞/뒤에 있는 자식의 슬롯 (없으면 -1)
+static inline int FirstChildSlot_N_Tree (const struct TreeNodeType* node) {
+
+  if (node->Capacity == 0) return -1;
+  const unsigned long long* bits = Occupied_N_Tree (node);
+  for (int word = 0; word < CHILD_WORDS (node->Capacity); word++) {
+
+    if (bits[word] != 0) return word * 64 + __builtin_ctzll (bits[word]);
+  }
+  return -1;
+}
+
+static inline int LastChildSlot_N_Tree (const struct TreeNodeType* node) {
+
+  if (node->Capacity == 0) return -1;
+  const unsigned long long* bits = Occupied_N_Tree (node);
+  for (int word = CHILD_WORDS (node->Capacity) - 1; word >= 0; word--) {
+
+    if (bits[word] != 0) return word * 64 + 63 - __builtin_clzll (bits[word]);
+  }
+  return -1;
+}
+
+// slot 다음으로 자식이 있는 슬롯 (없으면 -1)
+static inline int NextChildSlot_N_Tree (const struct TreeNodeType* node, int slot) {
+
+  int word = (slot + 1) >> 6;
+  if (word >= CHILD_WORDS (node->Capacity)) return -1;
+
+  const unsigned long long* bits = Occupied_N_Tree (node);
+  unsigned long long rest = (slot + 1) & 63 ? bits[word] & (~0ULL << ((slot + 1) & 63)) : bits[word];
+  while (rest == 0) {
+
+    if (++word >= CHILD_WORDS (node->Capacity)) return -1;
+    rest = bits[word];
+  }
+  return word * 64 + __builtin_ctzll (rest);
+}
+
+int ChildCount_N_Tree (const struct TreeNodeType* node);
+int NthChildSlot_N_Tree (const struct TreeNodeType* node, int nth);
+bool SetChild_N_Tree (struct TreeNodeType* node, int slot, struct TreeNodeType* child);
+bool ReserveChildren_N_Tree (struct TreeNodeType* node, int slots);
+
+static inline bool IsLeaf_N_Tree (const struct TreeNodeType* node) {
+
+  return ChildCount_N_Tree (node) == 0;
+}
+
+// 자식이 있는 슬롯만 작은 번호부터 돈다 (빈 슬롯은 읽지 않음).
+// 워드마다 점유 비트를 복사해 돌므로 본문에서 자식을 떼어 내도 된다. 본문에서 break 는 쓸 수 없다 (continue 는 가능).
+#define FOR_EACH_CHILD_SLOT(node, slot) \
+  for (int slot##Word = 0; slot##Word < CHILD_WORDS ((node)->Capacity); slot##Word++) \
+    for (unsigned long long slot##Bits = Occupied_N_Tree (node)[slot##Word]; slot##Bits != 0; slot##Bits &= slot##Bits - 1) \
+      for (int slot = slot##Word * 64 + __builtin_ctzll (slot##Bits), slot##Once = 1; slot##Once; slot##Once = 0)
+
+// 큰 번호부터 (스택에 넣어 전위 순서로 꺼낼 때)
+#define FOR_EACH_CHILD_SLOT_REVERSE(node, slot) \
+  for (int slot##Word = CHILD_WORDS ((node)->Capacity) - 1; slot##Word >= 0; slot##Word--) \
+    for (unsigned long long slot##Bits = Occupied_N_Tree (node)[slot##Word]; slot##Bits != 0; slot##Bits &= ~(1ULL << (63 - __builtin_clzll (slot##Bits)))) \
+      for (int slot = slot##Word * 64 + 63 - __builtin_clzll (slot##Bits), slot##Once = 1; slot##Once; slot##Once = 0)
+
+// 일괄 생성 시 노드와 자식 배열을 한 번에 할당한 블록
+struct NodeSlabType {
+
+  void* Memory;
+  struct NodeSlabType* Next;
+};
+
+// 노드 포인터 가변 배열
+struct NodeListType {
+
+  struct TreeNodeType** Items;
+  long Size;
+  long Capacity;
 };
 
+struct EulerIndexType;
+struct RollupIndexType;
+struct DependencyIndexType;
+struct AttributeTableType;
+struct PagerType;
+
 struct N_TreeType {
 
   struct TreeNodeType* Head;
   int Count;
   int ChildSize;
+  struct EulerIndexType* Euler;
+  struct RollupIndexType* Rollup;  // 소요 시간/비용 합계 (critical 이 처음 쓸 때 만듦, 그 전에는 NULL)
+  struct NodeSlabType* Slabs;
+  struct LabelPoolType* Labels;
+  struct TreeNodeType** Nodes;  // 노드 번호 -> 노드 (해제된 번호는 NULL)
+  int NodeCapacity;
+  int NextId;
+  struct AttributeTableType* Attributes;
+  struct DependencyIndexType* Dependencies;  // 노드 사이의 의존 간선과 위상 순서 (처음 간선을 더할 때 만듦, 그 전에는 NULL)
+  struct PagerType* Pager;  // 스냅숏에서 지연 로딩한 트리만 사용 (그 외에는 NULL)
+  int PayloadSize;          // 노드마다 붙는 사용자 데이터 바이트 (없으면 0)
+  const struct PayloadCodecType* Codec;
+  struct NodeListType Garbage;  // 떼어 냈지만 아직 해제하지 않은 서브트리 루트 (Reclaim_N_Tree 가 비움, 그때까지 Count 에 들어 있음)
 };
 
+// 컴파일 시간에 정한 타입을 노드 안에 두는 트리.
+// N_TREE_PAYLOAD_DECLARE (Task, struct TaskType) 이 Create_Task_N_Tree (n, codec) 와 Payload_Task_N_Tree (node) 를 만든다.
+#define N_TREE_PAYLOAD_DECLARE(Name, Type) \
+  _Static_assert (_Alignof (Type) <= 8 && sizeof (Type) <= PAYLOAD_SIZE_MAX, #Type " does not fit in a node payload"); \
+  static inline struct N_TreeType* Create_##Name##_N_Tree (int number_of_children, const struct PayloadCodecType* codec) { \
+\
+    return Create_Payload_N_Tree (number_of_children, sizeof (Type), codec); \
+  } \
+  static inline Type* Payload_##Name##_N_Tree (struct TreeNodeType* node) { \
+\
+    return (Type*) node->Payload; \
+  }
+
 struct N_TreeType* Create_N_Tree (int number_of_children);
+struct N_TreeType* Create_Payload_N_Tree (int number_of_children, int payloadSize, const struct PayloadCodecType* codec);
 struct TreeNodeType* Access_N_Tree (struct N_TreeType* tree, struct TreeNodeType* parent, int position);
+const char* Data_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node);
+bool SetData_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, const char* data);
 void Insert_ChildNode_N_Tree (struct N_TreeType* tree, struct TreeNodeType* parent, char* data, int position);
 void Insert_ParentNode_N_Tree (struct N_TreeType* tree, struct TreeNodeType* child, char* data);
+bool Move_Subtree_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, struct TreeNodeType* newParent, int position);
+struct TreeNodeType* Clone_Subtree_N_Tree (struct N_TreeType* tree, struct TreeNodeType* source, struct TreeNodeType* newParent, int position);
 bool Remove_N_Tree (struct N_TreeType* tree, struct TreeNodeType* target, bool clearAll);
 void Clear_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node);
+bool Detach_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node);
+long Reclaim_N_Tree (struct N_TreeType* tree, long budget);
 void Delete_N_Tree (struct N_TreeType* tree);
+unsigned long long Hash_N_Tree (struct TreeNodeType* node);
+void UpdateHash_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node);
+void Rehash_N_Tree (struct N_TreeType* tree);
+bool Equal_N_Tree (struct N_TreeType* first, struct N_TreeType* second);
+bool RegisterNode_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node);
+bool RegisterNodes_N_Tree (struct N_TreeType* tree, struct TreeNodeType* root);
+struct TreeNodeType* NodeById_N_Tree (struct N_TreeType* tree, int id);
+struct TreeNodeType* MakeTreeNode (struct N_TreeType* tree, struct TreeNodeType* parent, char* data);
+void FreeTreeNode (struct N_TreeType* tree, struct TreeNodeType* node);
+bool AppendNodeList (struct NodeListType* list, struct TreeNodeType* node);
+void FreeNodeList (struct NodeListType* list);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,363 @@
+#include "pack.h"
+#include "euler.h"
+#include "attr.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define PACK_MAGIC "WTPK"
+#define PACK_VERSION 1
+#define PACK_VERSION_PAYLOAD 2  // 노드 데이터가 있는 트리
+
+// 파일 형식
+//   "WTPK" u8 version, varint childSize, varint count [, varint payloadSize (version 2)]
+//   노드 기록 (전위 순서): [varint slotGap] label, varint childCount
+//     slotGap 은 바로 앞 형제 슬롯 + 1 과의 차이 (루트에는 없음, 빽빽한 자식은 모두 0)
+//     label 은 varint 로, 0 이면 새 레이블 (varint 앞 레이블과 공유하는 접두어 길이, varint 나머지 길이, 나머지),
+//     그 외에는 사전 번호 + 1
+//   u64 루트 해시 (읽은 뒤 다시 계산해 검증)
+//   속성 블록 (SaveAttributesBinary 형식)
+//   노드 데이터 (version 2, 전위 순서로 노드마다 PayloadCodecType 의 Write 결과 또는 payloadSize 바이트)
+static void WriteVarint (FILE* fp, unsigned long long value) {
+
+  while (value >= 0x80) {
+
+    fputc ((int) (value & 0x7F) | 0x80, fp);
+    value >>= 7;
+  }
+  fputc ((int) value, fp);
+}
+
+static bool ReadVarint (FILE* fp, unsigned long long* value) {
+
+  *value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+
+    int byte = fgetc (fp);
+    if (byte == EOF) return false;
+
+    *value |= (unsigned long long) (byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) return true;
+  }
+  return false;
+}
+
+// 레이블 핸들 -> 사전 번호 + 1 (0 은 아직 쓰지 않은 레이블)
+struct PackDictionaryType {
+
+  unsigned int* Codes;
+  unsigned int Count;
+  char Previous[LABEL_MAX_LENGTH + 1];  // 마지막으로 새로 쓴 레이블
+};
+
+static void WriteLabel (FILE* fp, struct N_TreeType* tree, struct PackDictionaryType* dictionary, LabelType label) {
+
+  if (dictionary->Codes[label] != 0) {
+
+    WriteVarint (fp, dictionary->Codes[label]);
+    return;
+  }
+
+  // 비슷한 이름이 이어지는 경우가 많아 앞 레이블과 같은 접두어는 길이만 쓴다
+  const char* text = Label_Text (tree->Labels, label);
+  size_t shared = 0;
+  while (text[shared] != '\0' && text[shared] == dictionary->Previous[shared]) shared++;
+  size_t rest = strlen (text + shared);
+
+  WriteVarint (fp, 0);
+  WriteVarint (fp, shared);
+  WriteVarint (fp, rest);
+  fwrite (text + shared, 1, rest, fp);
+
+  strcpy (dictionary->Previous + shared, text + shared);
+  dictionary->Codes[label] = ++dictionary->Count;
+}
+
+struct PackFrameType {
+
+  struct TreeNodeType* Node;
+  unsigned int Gap;
+};
+
+// 노드 데이터는 속성 블록 뒤에 전위 순서로 쓴다 (Renumber_N_Tree 가 만든 순서)
+static bool WritePayloads (struct N_TreeType* tree, FILE* fp) {
+
+  if (tree->PayloadSize == 0) return true;
+
+  const struct PayloadCodecType* codec = tree->Codec;
+  for (int entry = 0; entry < tree->Euler->Size; entry++) {
+
+    const void* payload = tree->Euler->Order[entry]->Payload;
+    bool ok = codec != NULL && codec->Write != NULL ? codec->Write (fp, payload, (size_t) tree->PayloadSize)
+                                                    : fwrite (payload, 1, (size_t) tree->PayloadSize, fp) == (size_t) tree->PayloadSize;
+    if (!ok) {
+
+      printf ("Error! Failed to write node payload. Save_Packed_N_Tree()\n");
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool ReadPayloads (struct N_TreeType* tree, FILE* fp) {
+
+  if (tree->PayloadSize == 0) return true;
+  if (!Renumber_N_Tree (tree)) return false;
+
+  const struct PayloadCodecType* codec = tree->Codec;
+  for (int entry = 0; entry < tree->Euler->Size; entry++) {
+
+    void* payload = tree->Euler->Order[entry]->Payload;
+    bool ok = codec != NULL && codec->Read != NULL ? codec->Read (fp, payload, (size_t) tree->PayloadSize)
+                                                   : fread (payload, 1, (size_t) tree->PayloadSize, fp) == (size_t) tree->PayloadSize;
+    if (!ok) return false;
+  }
+  return true;
+}
+
+bool Save_Packed_N_Tree (struct N_TreeType* tree, FILE* fp) {
+
+  if (tree == NULL || tree->Head == NULL || fp == NULL) {
+
+    printf ("Error! Invalid arguments. Save_Packed_N_Tree()\n");
+    return false;
+  }
+  // 헤더의 노드 수가 맞도록 떼어 낸 노드를 먼저 해제한다
+  Reclaim_N_Tree (tree, 0);
+  // 속성 블록이 전위 번호를 쓰고, 지연 로딩 트리는 여기서 모두 읽힌다
+  if (!Renumber_N_Tree (tree)) return false;
+
+  struct PackDictionaryType dictionary;
+  dictionary.Codes = (unsigned int*) calloc (tree->Labels->Count + 1, sizeof (unsigned int));
+  dictionary.Count = 0;
+  dictionary.Previous[0] = '\0';
+
+  struct PackFrameType* stack = (struct PackFrameType*) malloc ((tree->Count + 1) * sizeof (struct PackFrameType));
+  if (dictionary.Codes == NULL || stack == NULL) {
+
+    printf ("Error! The dynamic memory allocation failed. Save_Packed_N_Tree()\n");
+    free (dictionary.Codes);
+    free (stack);
+    return false;
+  }
+
+  fwrite (PACK_MAGIC, 1, 4, fp);
+  fputc (tree->PayloadSize > 0 ? PACK_VERSION_PAYLOAD : PACK_VERSION, fp);
+  WriteVarint (fp, tree->ChildSize);
+  WriteVarint (fp, tree->Count);
+  if (tree->PayloadSize > 0) WriteVarint (fp, tree->PayloadSize);
+
+  int size = 0;
+  stack[size].Node = tree->Head;
+  stack[size++].Gap = 0;
+
+  while (size > 0) {
+
+    struct PackFrameType frame = stack[--size];
+    struct TreeNodeType* node = frame.Node;
+
+    if (node != tree->Head) WriteVarint (fp, frame.Gap);
+    WriteLabel (fp, tree, &dictionary, node->Label);
+
+    // 자식은 거꾸로 쌓아야 슬롯 순서로 꺼낸다. 간격은 앞 형제 기준이라 먼저 구해 둔다.
+    int children = 0;
+    int first = size;
+    int previous = -1;
+    FOR_EACH_CHILD_SLOT (node, slot) {
+
+      stack[size].Node = node->Children[slot];
+      stack[size++].Gap = (unsigned int) (slot - previous - 1);
+      previous = slot;
+      children++;
+    }
+    for (int low = first, high = size - 1; low < high; low++, high--) {
+
+      struct PackFrameType swap = stack[low];
+      stack[low] = stack[high];
+      stack[high] = swap;
+    }
+    WriteVarint (fp, children);
+  }
+
+  for (int shift = 0; shift < 64; shift += 8) fputc ((int) ((tree->Head->Hash >> shift) & 0xFF), fp);
+
+  free (stack);
+  free (dictionary.Codes);
+  return SaveAttributesBinary (tree, fp) && WritePayloads (tree, fp) && ferror (fp) == 0;
+}
+
+static bool ReadLabel (FILE* fp, struct N_TreeType* tree, LabelType** labels, unsigned int* count, unsigned int* capacity, char* previous, LabelType* label) {
+
+  unsigned long long code;
+  if (!ReadVarint (fp, &code)) return false;
+
+  if (code != 0) {
+
+    if (code > *count) return false;
+    *label = (*labels)[code - 1];
+    return true;
+  }
+
+  unsigned long long shared, rest;
+  if (!ReadVarint (fp, &shared) || !ReadVarint (fp, &rest) || shared > strlen (previous) || shared + rest > LABEL_MAX_LENGTH ||
+      fread (previous + shared, 1, rest, fp) != rest) return false;
+  previous[shared + rest] = '\0';
+
+  if (*count == *capacity) {
+
+    unsigned int grown = *capacity == 0 ? 256 : *capacity * 2;
+    LabelType* items = (LabelType*) realloc (*labels, grown * sizeof (LabelType));
+    if (items == NULL) return false;
+
+    *labels = items;
+    *capacity = grown;
+  }
+
+  *label = Intern_Label (tree->Labels, previous);
+  if (*label == LABEL_NONE) return false;
+  (*labels)[(*count)++] = *label;
+  return true;
+}
+
+// 자식을 채우는 중인 부모
+struct UnpackFrameType {
+
+  struct TreeNodeType* Node;
+  unsigned int Remaining;
+  int NextSlot;
+};
+
+struct N_TreeType* Load_Packed_N_Tree (FILE* fp) {
+
+  return Load_Packed_Payload_N_Tree (fp, NULL);
+}
+
+struct N_TreeType* Load_Packed_Payload_N_Tree (FILE* fp, const struct PayloadCodecType* codec) {
+
+  char magic[4];
+  unsigned long long childSize, expected, payloadSize = 0;
+  int version = EOF;
+  if (fp == NULL || fread (magic, 1, 4, fp) != 4 || memcmp (magic, PACK_MAGIC, 4) != 0 ||
+      ((version = fgetc (fp)) != PACK_VERSION && version != PACK_VERSION_PAYLOAD) ||
+      !ReadVarint (fp, &childSize) || !ReadVarint (fp, &expected) || childSize < 1 || childSize > CHILD_SIZE_MAX ||
+      (version == PACK_VERSION_PAYLOAD && (!ReadVarint (fp, &payloadSize) || payloadSize > PAYLOAD_SIZE_MAX))) {
+
+    printf ("Error! Not a packed tree file. Load_Packed_N_Tree()\n");
+    return NULL;
+  }
+
+  struct N_TreeType* tree = Create_Payload_N_Tree ((int) childSize, (int) payloadSize, codec);
+  if (tree == NULL) return NULL;
+
+  LabelType* labels = NULL;
+  unsigned int labelCount = 0, labelCapacity = 0;
+  char* previous = (char*) calloc (LABEL_MAX_LENGTH + 1, 1);
+  struct UnpackFrameType* stack = NULL;
+  int size = 0, capacity = 0;
+  unsigned long long children;
+
+  bool ok = previous != NULL && ReadLabel (fp, tree, &labels, &labelCount, &labelCapacity, previous, &tree->Head->Label) &&
+            ReadVarint (fp, &children) && children <= childSize;
+  tree->Count = 1;
+
+  if (ok && children > 0) {
+
+    capacity = 64;
+    stack = (struct UnpackFrameType*) malloc (capacity * sizeof (struct UnpackFrameType));
+    ok = stack != NULL;
+    if (ok) {
+
+      stack[0].Node = tree->Head;
+      stack[0].Remaining = (unsigned int) children;
+      stack[0].NextSlot = 0;
+      size = 1;
+    }
+  }
+
+  while (ok && size > 0) {
+
+    struct UnpackFrameType* frame = &stack[size - 1];
+    if (frame->Remaining == 0) {
+
+      size--;
+      continue;
+    }
+
+    unsigned long long gap;
+    LabelType label;
+    ok = ReadVarint (fp, &gap) && gap < childSize && frame->NextSlot + gap < childSize &&
+         ReadLabel (fp, tree, &labels, &labelCount, &labelCapacity, previous, &label) && ReadVarint (fp, &children) && children <= childSize;
+    if (!ok) break;
+
+    int slot = frame->NextSlot + (int) gap;
+    struct TreeNodeType* node = MakeTreeNode (tree, frame->Node, "");
+    if (node == NULL) {
+
+      ok = false;
+      break;
+    }
+    node->Label = label;
+    if (!SetChild_N_Tree (frame->Node, slot, node)) {
+
+      FreeTreeNode (tree, node);
+      ok = false;
+      break;
+    }
+    frame->NextSlot = slot + 1;
+    frame->Remaining--;
+    tree->Count++;
+
+    if (children == 0) continue;
+
+    if (size == capacity) {
+
+      capacity *= 2;
+      struct UnpackFrameType* grown = (struct UnpackFrameType*) realloc (stack, capacity * sizeof (struct UnpackFrameType));
+      if (grown == NULL) {
+
+        ok = false;
+        break;
+      }
+      stack = grown;
+    }
+    stack[size].Node = node;
+    stack[size].Remaining = (unsigned int) children;
+    stack[size].NextSlot = 0;
+    size++;
+  }
+
+  // 다시 계산한 해시가 기록과 같아야 온전한 복원이다
+  unsigned long long hash = 0;
+  for (int shift = 0; ok && shift < 64; shift += 8) {
+
+    int byte = fgetc (fp);
+    ok = byte != EOF;
+    hash |= (unsigned long long) (byte & 0xFF) << shift;
+  }
+  if (ok) {
+
+    Rehash_N_Tree (tree);
+    ok = tree->Head->Hash == hash && (unsigned long long) tree->Count == expected;
+  }
+
+  free (stack);
+  free (labels);
+  free (previous);
+
+  if (!ok) {
+
+    printf ("Error! Packed tree file is truncated or corrupt. Load_Packed_N_Tree()\n");
+    Delete_N_Tree (tree);
+    return NULL;
+  }
+  if (!LoadAttributesBinary (tree, fp)) {
+
+    printf ("Warning! Failed to read attributes of packed tree. Load_Packed_N_Tree()\n");
+  }
+  if (!ReadPayloads (tree, fp)) {
+
+    printf ("Error! Failed to read node payloads of packed tree. Load_Packed_N_Tree()\n");
+    Delete_N_Tree (tree);
+    return NULL;
+  }
+  return tree;
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#ifndef _PACK_H_
+#define _PACK_H_
+
+#include "n_tree.h"
+#include <stdio.h>
+
+// 압축 저장 형식: 레이블 사전 + 가변 길이 정수로 쓴 전위 순서 노드 표.
+// 파일을 통째로 메모리에 올리지 않고 FILE 스트림에서 바로 읽고 쓴다.
+// 노드 데이터가 있는 트리는 codec 으로 읽는다 (NULL 이면 바이트를 그대로 읽음).
+bool Save_Packed_N_Tree (struct N_TreeType* tree, FILE* fp);
+struct N_TreeType* Load_Packed_N_Tree (FILE* fp);
+struct N_TreeType* Load_Packed_Payload_N_Tree (FILE* fp, const struct PayloadCodecType* codec);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,351 @@
+#include "pager.h"
+#include "euler.h"
+#include "rollup.h"
+#include "attr.h"
+#include "deps.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct N_TreeType* Open_Paged_N_Tree (struct SnapshotType* snapshot, long budget) {
+
+  if (snapshot == NULL || !snapshot->HasRoot) {
+
+    printf ("Error! Snapshot has no saved tree. Open_Paged_N_Tree()\n");
+    return NULL;
+  }
+
+  struct N_TreeType* tree = Create_N_Tree (snapshot->RootChildSize);
+  if (tree == NULL) return NULL;
+
+  struct PagerType* pager = (struct PagerType*) calloc (1, sizeof (struct PagerType));
+  if (pager != NULL) pager->Chunk = (struct SnapshotChunkType*) calloc (1, sizeof (struct SnapshotChunkType));
+  if (pager == NULL || pager->Chunk == NULL) {
+
+    printf ("Error! The dynamic memory allocation failed. Open_Paged_N_Tree()\n");
+    Delete_Pager (pager);
+    Delete_N_Tree (tree);
+    return NULL;
+  }
+  pager->Snapshot = snapshot;
+  pager->Budget = budget > 0 ? budget : PAGER_DEFAULT_BUDGET;
+  pager->Resident = 1;
+
+  FILE* fp = fopen (snapshot->Path, "rb");
+  bool ok = fp != NULL && ReadChunk_Snapshot (snapshot, fp, snapshot->Root, pager->Chunk) &&
+            SetData_N_Tree (tree, tree->Head, pager->Chunk->Text);
+  if (fp != NULL) fclose (fp);
+
+  if (!ok) {
+
+    printf ("Error! Failed to read %s. Open_Paged_N_Tree()\n", snapshot->Path);
+    Delete_Pager (pager);
+    Delete_N_Tree (tree);
+    return NULL;
+  }
+
+  // 루트의 자식은 처음 방문할 때 읽는다
+  tree->Pager = pager;
+  tree->Count = snapshot->RootCount;
+  tree->Head->Hash = snapshot->Root;
+  tree->Head->Paged = pager->Chunk->ChildCount > 0;
+
+  // 간선의 두 끝과 속성이 있는 노드는 여기서 읽어 두며, 이런 노드는 내보내지 않는다
+  if (!ReadDependencies_Snapshot (snapshot, tree) || !ReadAttributes_Snapshot (snapshot, tree)) {
+
+    Delete_N_Tree (tree);
+    return NULL;
+  }
+  return tree;
+}
+
+static void TouchNode (struct PagerType* pager, struct TreeNodeType* node) {
+
+  if (node->Id >= pager->UseCapacity) {
+
+    int capacity = pager->UseCapacity == 0 ? 256 : pager->UseCapacity;
+    while (capacity <= node->Id) capacity *= 2;
+
+    unsigned long* lastUse = (unsigned long*) realloc (pager->LastUse, capacity * sizeof (unsigned long));
+    if (lastUse == NULL) return;  // 방문 시각은 내보내기 순서에만 쓰이므로 잃어도 된다
+
+    memset (lastUse + pager->UseCapacity, 0, (capacity - pager->UseCapacity) * sizeof (unsigned long));
+    pager->LastUse = lastUse;
+    pager->UseCapacity = capacity;
+  }
+  pager->LastUse[node->Id] = ++pager->Clock;
+}
+
+static bool AddEntry (struct PagerType* pager, int id, int loaded) {
+
+  if (pager->EntryCount == pager->EntryCapacity) {
+
+    long capacity = pager->EntryCapacity == 0 ? 64 : pager->EntryCapacity * 2;
+    struct PagerEntryType* entries = (struct PagerEntryType*) realloc (pager->Entries, capacity * sizeof (struct PagerEntryType));
+    if (entries == NULL) return false;
+
+    pager->Entries = entries;
+    pager->EntryCapacity = capacity;
+  }
+  pager->Entries[pager->EntryCount].Id = id;
+  pager->Entries[pager->EntryCount].Loaded = loaded;
+  pager->EntryCount++;
+  return true;
+}
+
+// node 조각을 읽어 자식 자리표시자를 만든다. 자식 레이블은 자식 조각에서 읽는다.
+static bool FaultNode (struct N_TreeType* tree, FILE* fp, struct TreeNodeType* node) {
+
+  struct PagerType* pager = tree->Pager;
+  struct SnapshotChunkType* chunk = pager->Chunk;
+  if (!ReadChunk_Snapshot (pager->Snapshot, fp, node->Hash, chunk)) return false;
+
+  // 자식 조각을 읽으면 버퍼가 덮이므로 목록을 먼저 옮겨 둔다
+  int count = chunk->ChildCount;
+  int* slots = (int*) malloc ((size_t) (count > 0 ? count : 1) * sizeof (int));
+  unsigned long long* hashes = (unsigned long long*) malloc ((size_t) (count > 0 ? count : 1) * sizeof (unsigned long long));
+  if (slots == NULL || hashes == NULL) {
+
+    free (slots);
+    free (hashes);
+    return false;
+  }
+  memcpy (slots, chunk->Slots, count * sizeof (int));
+  memcpy (hashes, chunk->Hashes, count * sizeof (unsigned long long));
+
+  bool ok = true;
+  int made = 0;
+  for (; ok && made < count; made++) {
+
+    ok = slots[made] < tree->ChildSize && ChildAt_N_Tree (node, slots[made]) == NULL && ReadChunk_Snapshot (pager->Snapshot, fp, hashes[made], chunk);
+    struct TreeNodeType* child = ok ? MakeTreeNode (tree, node, chunk->Text) : NULL;
+    if (child == NULL) {
+
+      ok = false;
+      break;
+    }
+
+    // 자식이 없는 노드는 레이블만으로 완성된다
+    child->Paged = chunk->ChildCount > 0;
+    if (child->Paged) {
+
+      child->Hash = hashes[made];
+      child->HashSum = 0;
+    }
+    if (!SetChild_N_Tree (node, slots[made], child)) {
+
+      FreeTreeNode (tree, child);
+      ok = false;
+      break;
+    }
+  }
+
+  unsigned long long expected = node->Hash;
+  if (ok) {
+
+    node->Paged = false;
+    UpdateHash_N_Tree (tree, node);
+    ok = node->Hash == expected;
+  }
+
+  if (!ok) {
+
+    // 만든 자식을 되돌리고 자리표시자로 남긴다
+    for (int index = 0; index < made && index < count; index++) {
+
+      if (slots[index] >= tree->ChildSize || ChildAt_N_Tree (node, slots[index]) == NULL) continue;
+      FreeTreeNode (tree, node->Children[slots[index]]);
+      SetChild_N_Tree (node, slots[index], NULL);
+    }
+    node->Paged = true;
+    node->Hash = expected;
+    free (slots);
+    free (hashes);
+    return false;
+  }
+
+  free (slots);
+  free (hashes);
+
+  pager->Resident += count;
+  pager->Faults++;
+  AddEntry (pager, node->Id, count);  // 목록에 넣지 못하면 내보내지 않을 뿐이다
+  Invalidate_Euler_Index (tree);
+  Invalidate_Rollup (tree);
+  return true;
+}
+
+// node 의 자식이 아직 파일에만 있으면 읽어 온다. 이미 읽은 노드는 방문 시각만 갱신한다.
+bool Fault_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node) {
+
+  if (tree == NULL || tree->Pager == NULL || node == NULL) return true;
+
+  TouchNode (tree->Pager, node);
+  if (!node->Paged) return true;
+
+  FILE* fp = fopen (tree->Pager->Snapshot->Path, "rb");
+  bool ok = fp != NULL && FaultNode (tree, fp, node);
+  if (fp != NULL) fclose (fp);
+
+  if (!ok) printf ("Error! Failed to read page of '%s' from %s. Fault_N_Tree()\n", Data_N_Tree (tree, node), tree->Pager->Snapshot->Path);
+  return ok;
+}
+
+// 트리 전체를 훑는 작업 전에 남은 서브트리를 모두 읽는다
+bool LoadAll_N_Tree (struct N_TreeType* tree) {
+
+  if (tree == NULL || tree->Pager == NULL || tree->Head == NULL) return true;
+
+  FILE* fp = fopen (tree->Pager->Snapshot->Path, "rb");
+  if (fp == NULL) {
+
+    printf ("Error! Failed to open %s. LoadAll_N_Tree()\n", tree->Pager->Snapshot->Path);
+    return false;
+  }
+
+  struct NodeListType stack = { NULL, 0, 0 };
+  bool ok = AppendNodeList (&stack, tree->Head);
+
+  while (ok && stack.Size > 0) {
+
+    struct TreeNodeType* node = stack.Items[--stack.Size];
+    if (node->Paged) ok = FaultNode (tree, fp, node);
+
+    FOR_EACH_CHILD_SLOT (node, slot) {
+
+      if (ok) ok = AppendNodeList (&stack, node->Children[slot]);
+    }
+  }
+
+  fclose (fp);
+  FreeNodeList (&stack);
+  if (!ok) printf ("Error! Failed to read %s. LoadAll_N_Tree()\n", tree->Pager->Snapshot->Path);
+  return ok;
+}
+
+static bool HasAttributes (struct N_TreeType* tree, int id) {
+
+  if (tree->Attributes == NULL) return false;
+
+  for (int index = 0; index < tree->Attributes->Count; index++) {
+
+    if (HasAttributeValue (&tree->Attributes->Columns[index], id)) return true;
+  }
+  return false;
+}
+
+// 자식이 모두 읽지 않은 상태이고, 파일에 같은 해시가 있으며(깨끗함), 속성과 의존 간선이 없어야 되돌릴 수 있다
+static bool IsEvictable (struct N_TreeType* tree, struct TreeNodeType* node, struct TreeNodeType* keep) {
+
+  if (node == keep || node->Paged || ChunkSize_Snapshot (tree->Pager->Snapshot, node->Hash) < 0) return false;
+
+  bool any = false;
+  FOR_EACH_CHILD_SLOT (node, slot) {
+
+    struct TreeNodeType* child = node->Children[slot];
+
+    // 자식이 없는 자식은 자리표시자가 아니어도 조각에서 다시 만들 수 있다
+    if (child == keep || (!child->Paged && !IsLeaf_N_Tree (child)) || HasAttributes (tree, child->Id) || HasDependencies_N_Tree (tree, child->Id)) return false;
+    any = true;
+  }
+  return any;
+}
+
+static unsigned long EntryUse (struct PagerType* pager, int id) {
+
+  return id < pager->UseCapacity ? pager->LastUse[id] : 0;
+}
+
+static struct PagerType* SortPager;
+
+static int CompareEntryUse (const void* first, const void* second) {
+
+  unsigned long a = EntryUse (SortPager, ((const struct PagerEntryType*) first)->Id);
+  unsigned long b = EntryUse (SortPager, ((const struct PagerEntryType*) second)->Id);
+  return a < b ? -1 : a > b;
+}
+
+// 한도를 넘으면 오래 방문하지 않은 깨끗한 노드의 자식을 해제하고 자리표시자로 되돌린다.
+// keep(현재 노드)은 내보내지 않는다. 다른 노드 포인터를 들고 있지 않을 때만 호출한다.
+long Evict_N_Tree (struct N_TreeType* tree, struct TreeNodeType* keep) {
+
+  if (tree == NULL || tree->Pager == NULL) return 0;
+
+  struct PagerType* pager = tree->Pager;
+  if (pager->Resident <= pager->Budget) return 0;
+
+  // 삭제되었거나 이미 되돌린 노드는 목록에서 뺀다
+  long live = 0;
+  for (long index = 0; index < pager->EntryCount; index++) {
+
+    struct TreeNodeType* node = NodeById_N_Tree (tree, pager->Entries[index].Id);
+    if (node == NULL || node->Paged) {
+
+      pager->Resident -= pager->Entries[index].Loaded;
+      continue;
+    }
+    pager->Entries[live++] = pager->Entries[index];
+  }
+  pager->EntryCount = live;
+
+  SortPager = pager;
+  qsort (pager->Entries, pager->EntryCount, sizeof (struct PagerEntryType), CompareEntryUse);
+
+  long evicted = 0;
+  live = 0;
+  for (long index = 0; index < pager->EntryCount; index++) {
+
+    struct TreeNodeType* node = NodeById_N_Tree (tree, pager->Entries[index].Id);
+    if (pager->Resident <= pager->Budget || !IsEvictable (tree, node, keep)) {
+
+      pager->Entries[live++] = pager->Entries[index];
+      continue;
+    }
+
+    FOR_EACH_CHILD_SLOT (node, slot) {
+
+      FreeTreeNode (tree, node->Children[slot]);
+      SetChild_N_Tree (node, slot, NULL);
+    }
+    node->Paged = true;
+    pager->Resident -= pager->Entries[index].Loaded;
+    pager->Evictions++;
+    evicted++;
+  }
+  pager->EntryCount = live;
+
+  if (evicted > 0) Invalidate_Euler_Index (tree);
+  if (evicted > 0) Invalidate_Rollup (tree);
+  return evicted;
+}
+
+// 읽지 않은 서브트리의 노드 수 (조각에 기록된 값)
+int PagedSize_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node) {
+
+  if (tree == NULL || tree->Pager == NULL || node == NULL || !node->Paged) return 1;
+
+  int size = ChunkSize_Snapshot (tree->Pager->Snapshot, node->Hash);
+  return size > 0 ? size : 1;
+}
+
+// 모두 읽은 뒤 스냅숏과의 연결을 끊는다 (스냅숏을 닫기 전에 호출)
+bool Detach_Pager_N_Tree (struct N_TreeType* tree) {
+
+  if (tree == NULL || tree->Pager == NULL) return true;
+  if (!LoadAll_N_Tree (tree)) return false;
+
+  Delete_Pager (tree->Pager);
+  tree->Pager = NULL;
+  return true;
+}
+
+void Delete_Pager (struct PagerType* pager) {
+
+  if (pager == NULL) return;
+
+  FreeChunk_Snapshot (pager->Chunk);
+  free (pager->Chunk);
+  free (pager->Entries);
+  free (pager->LastUse);
+  free (pager);
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#ifndef _PAGER_H_
+#define _PAGER_H_
+
+#include "n_tree.h"
+#include "snapshot.h"
+
+#define PAGER_DEFAULT_BUDGET 4096
+
+// 자식을 읽어 온 노드 하나 (내보내기 후보)
+struct PagerEntryType {
+
+  int Id;
+  int Loaded;  // 이 노드를 읽을 때 만든 자식 수
+};
+
+// 스냅숏 파일에서 처음 방문하는 노드의 자식만 읽어 오는 지연 로딩 상태.
+// 아직 읽지 않은 노드는 레이블과 해시만 가진 Paged 노드이다.
+struct PagerType {
+
+  struct SnapshotType* Snapshot;      // 빌려 쓰는 스냅숏 (닫지 않는다)
+  struct SnapshotChunkType* Chunk;    // 조각 읽기 버퍼
+  struct PagerEntryType* Entries;
+  long EntryCount;
+  long EntryCapacity;
+  unsigned long* LastUse;             // 노드 번호 -> 마지막 방문 시각
+  int UseCapacity;
+  unsigned long Clock;
+  long Budget;     // 파일에서 읽어 메모리에 둘 노드 수 한도
+  long Resident;   // 파일에서 읽어 메모리에 있는 노드 수
+  long Faults;
+  long Evictions;
+};
+
+struct N_TreeType* Open_Paged_N_Tree (struct SnapshotType* snapshot, long budget);
+bool Fault_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node);
+bool LoadAll_N_Tree (struct N_TreeType* tree);
+long Evict_N_Tree (struct N_TreeType* tree, struct TreeNodeType* keep);
+int PagedSize_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node);
+bool Detach_Pager_N_Tree (struct N_TreeType* tree);
+void Delete_Pager (struct PagerType* pager);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,407 @@
+#include "parallel.h"
+#include "trace.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+struct WorkItemType {
+
+  struct TreeNodeType* Node;
+  int Depth;
+};
+
+struct WorkStackType {
+
+  struct WorkItemType* Items;
+  int Size;
+  int Capacity;
+};
+
+// 소유 스레드는 Tail 에서 꺼내고, 다른 스레드는 Head 에서 훔쳐 간다.
+struct WorkDequeType {
+
+  struct WorkItemType* Items;
+  int Head;
+  int Tail;
+  int Capacity;
+  pthread_mutex_t Lock;
+};
+
+struct ParallelRunType;
+
+struct WorkerType {
+
+  struct ParallelRunType* Run;
+  struct WorkDequeType Deque;
+  struct WorkStackType Stack;
+  void* Local;
+  int Index;
+  pthread_t Thread;
+};
+
+struct ParallelRunType {
+
+  const struct ParallelVisitorType* Visitor;
+  struct WorkerType* Workers;
+  int ThreadCount;
+  int Grain;
+  int ChildSize;
+  atomic_long Pending;  // 아직 끝나지 않은 작업(게시된 서브트리) 수
+  atomic_int Idle;      // 일감을 찾는 중인 스레드 수
+  atomic_bool Failed;
+};
+
+static bool PushWorkStack (struct WorkStackType* stack, struct TreeNodeType* node, int depth) {
+
+  if (stack->Size == stack->Capacity) {
+
+    int capacity = stack->Capacity == 0 ? 256 : stack->Capacity * 2;
+    struct WorkItemType* items = (struct WorkItemType*) realloc (stack->Items, capacity * sizeof (struct WorkItemType));
+    if (items == NULL) return false;
+
+    stack->Items = items;
+    stack->Capacity = capacity;
+  }
+
+  stack->Items[stack->Size].Node = node;
+  stack->Items[stack->Size].Depth = depth;
+  stack->Size++;
+  return true;
+}
+
+static bool PushWorkDeque (struct WorkDequeType* deque, const struct WorkItemType* items, int count) {
+
+  pthread_mutex_lock (&deque->Lock);
+
+  if (deque->Head == deque->Tail) deque->Head = deque->Tail = 0;
+  if (deque->Tail + count > deque->Capacity) {
+
+    // 앞쪽 빈 공간을 먼저 당겨 쓰고, 그래도 모자라면 늘린다.
+    int used = deque->Tail - deque->Head;
+    if (used > 0) memmove (deque->Items, deque->Items + deque->Head, used * sizeof (struct WorkItemType));
+    deque->Head = 0;
+    deque->Tail = used;
+
+    if (used + count > deque->Capacity) {
+
+      int capacity = deque->Capacity == 0 ? 64 : deque->Capacity;
+      while (capacity < used + count) capacity *= 2;
+
+      struct WorkItemType* grown = (struct WorkItemType*) realloc (deque->Items, capacity * sizeof (struct WorkItemType));
+      if (grown == NULL) {
+
+        pthread_mutex_unlock (&deque->Lock);
+        return false;
+      }
+      deque->Items = grown;
+      deque->Capacity = capacity;
+    }
+  }
+
+  memcpy (deque->Items + deque->Tail, items, count * sizeof (struct WorkItemType));
+  deque->Tail += count;
+
+  pthread_mutex_unlock (&deque->Lock);
+  return true;
+}
+
+static bool TakeWorkDeque (struct WorkDequeType* deque, struct WorkItemType* out, bool steal) {
+
+  pthread_mutex_lock (&deque->Lock);
+
+  if (deque->Head == deque->Tail) {
+
+    pthread_mutex_unlock (&deque->Lock);
+    return false;
+  }
+
+  if (steal) *out = deque->Items[deque->Head++];
+  else *out = deque->Items[--deque->Tail];
+
+  pthread_mutex_unlock (&deque->Lock);
+  return true;
+}
+
+// 스택 바닥(루트에 가까운, 즉 큰 서브트리)의 절반을 다른 스레드가 가져갈 수 있도록 게시한다.
+static void PublishWork (struct WorkerType* worker) {
+
+  struct WorkStackType* stack = &worker->Stack;
+  int count = stack->Size / 2;
+  if (count < 1) return;
+
+  // 훔쳐 간 작업이 먼저 끝나 Pending 이 0 이 되지 않도록 게시하기 전에 센다
+  atomic_fetch_add (&worker->Run->Pending, count);
+  if (!PushWorkDeque (&worker->Deque, stack->Items, count)) {
+
+    atomic_fetch_sub (&worker->Run->Pending, count);
+    return;
+  }
+  memmove (stack->Items, stack->Items + count, (stack->Size - count) * sizeof (struct WorkItemType));
+  stack->Size -= count;
+}
+
+static void RunTask (struct WorkerType* worker, struct WorkItemType task) {
+
+  struct ParallelRunType* run = worker->Run;
+  const struct ParallelVisitorType* visitor = run->Visitor;
+  struct WorkStackType* stack = &worker->Stack;
+  int sinceSplit = 0;
+
+  stack->Size = 0;
+  if (!PushWorkStack (stack, task.Node, task.Depth)) {
+
+    atomic_store (&run->Failed, true);
+    return;
+  }
+
+  while (stack->Size > 0) {
+
+    struct WorkItemType item = stack->Items[--stack->Size];
+    visitor->Visit (item.Node, item.Depth, worker->Local, visitor->Context);
+
+    // 전위 순서를 유지하기 위해 뒤쪽 자식부터 넣는다.
+    FOR_EACH_CHILD_SLOT_REVERSE (item.Node, index) {
+
+      struct TreeNodeType* child = item.Node->Children[index];
+
+      if (!PushWorkStack (stack, child, item.Depth + 1)) {
+
+        atomic_store (&run->Failed, true);
+        return;
+      }
+    }
+
+    // 작은 서브트리는 쪼개지 않는다: Grain 개를 방문한 뒤에만, 놀고 있는 스레드가 있을 때 나눠 준다.
+    if (++sinceSplit >= run->Grain && stack->Size > 1 && atomic_load (&run->Idle) > 0) {
+
+      PublishWork (worker);
+      sinceSplit = 0;
+    }
+  }
+}
+
+static bool FindWork (struct WorkerType* worker, struct WorkItemType* out) {
+
+  struct ParallelRunType* run = worker->Run;
+
+  if (TakeWorkDeque (&worker->Deque, out, false)) return true;
+
+  for (int offset = 1; offset < run->ThreadCount; offset++) {
+
+    int victim = (worker->Index + offset) % run->ThreadCount;
+    if (TakeWorkDeque (&run->Workers[victim].Deque, out, true)) return true;
+  }
+  return false;
+}
+
+static void* WorkerMain (void* argument) {
+
+  struct WorkerType* worker = (struct WorkerType*) argument;
+  struct ParallelRunType* run = worker->Run;
+  struct WorkItemType task;
+  TRACE_BEGIN (span);
+
+  while (true) {
+
+    if (FindWork (worker, &task)) {
+
+      RunTask (worker, task);
+      atomic_fetch_sub (&run->Pending, 1);
+      continue;
+    }
+
+    if (atomic_load (&run->Pending) == 0) break;
+
+    bool found = false;
+    atomic_fetch_add (&run->Idle, 1);
+    while (atomic_load (&run->Pending) > 0 && !(found = FindWork (worker, &task))) sched_yield ();
+    atomic_fetch_sub (&run->Idle, 1);
+
+    if (!found) break;
+    RunTask (worker, task);
+    atomic_fetch_sub (&run->Pending, 1);
+  }
+  TRACE_END (span, "parallel_worker", "parallel");
+  return NULL;
+}
+
+int ParallelThreadCount (void) {
+
+  long online = sysconf (_SC_NPROCESSORS_ONLN);
+  if (online < 1) return 1;
+  if (online > PARALLEL_MAX_THREADS) return PARALLEL_MAX_THREADS;
+  return (int) online;
+}
+
+bool ParallelVisit_N_Tree (struct N_TreeType* tree, struct TreeNodeType* root, const struct ParallelVisitorType* visitor, void* result, int threadCount) {
+
+  if (tree == NULL || visitor == NULL || visitor->Visit == NULL || visitor->Init == NULL || visitor->Reduce == NULL) {
+
+    printf ("Error! Invalid arguments. ParallelVisit_N_Tree()\n");
+    return false;
+  }
+  if (root == NULL) root = tree->Head;
+  if (threadCount < 1) threadCount = ParallelThreadCount ();
+  if (threadCount > PARALLEL_MAX_THREADS) threadCount = PARALLEL_MAX_THREADS;
+  if (tree->Count < PARALLEL_MIN_NODES) threadCount = 1;
+
+  struct ParallelRunType run;
+  run.Visitor = visitor;
+  run.ThreadCount = threadCount;
+  run.Grain = visitor->Grain > 0 ? visitor->Grain : PARALLEL_DEFAULT_GRAIN;
+  run.ChildSize = tree->ChildSize;
+  atomic_init (&run.Pending, 1);
+  atomic_init (&run.Idle, 0);
+  atomic_init (&run.Failed, false);
+
+  run.Workers = (struct WorkerType*) calloc (threadCount, sizeof (struct WorkerType));
+  char* locals = (char*) calloc (threadCount, visitor->LocalSize > 0 ? visitor->LocalSize : 1);
+  if (run.Workers == NULL || locals == NULL) {
+
+    printf ("Error! The dynamic memory allocation failed. ParallelVisit_N_Tree()\n");
+    free (run.Workers);
+    free (locals);
+    return false;
+  }
+
+  for (int index = 0; index < threadCount; index++) {
+
+    struct WorkerType* worker = &run.Workers[index];
+    worker->Run = &run;
+    worker->Index = index;
+    worker->Local = locals + index * visitor->LocalSize;
+    pthread_mutex_init (&worker->Deque.Lock, NULL);
+    visitor->Init (worker->Local);
+  }
+
+  struct WorkItemType first = { root, 0 };
+  PushWorkDeque (&run.Workers[0].Deque, &first, 1);
+
+  // 0 번 작업자는 호출한 스레드가 맡는다. 생성에 실패한 작업자의 덱은 비어 있으므로 그대로 둔다.
+  int started = 1;
+  for (int index = 1; index < threadCount; index++) {
+
+    if (pthread_create (&run.Workers[index].Thread, NULL, WorkerMain, &run.Workers[index]) != 0) break;
+    started++;
+  }
+  WorkerMain (&run.Workers[0]);
+
+  for (int index = 1; index < started; index++) {
+
+    pthread_join (run.Workers[index].Thread, NULL);
+  }
+
+  visitor->Init (result);
+  for (int index = 0; index < threadCount; index++) {
+
+    struct WorkerType* worker = &run.Workers[index];
+    visitor->Reduce (result, worker->Local);
+    free (worker->Stack.Items);
+    free (worker->Deque.Items);
+    pthread_mutex_destroy (&worker->Deque.Lock);
+  }
+
+  bool failed = atomic_load (&run.Failed);
+  free (run.Workers);
+  free (locals);
+
+  if (failed) printf ("Error! The dynamic memory allocation failed. ParallelVisit_N_Tree()\n");
+  return !failed;
+}
+
+// 통계 방문자
+struct StatsContextType {
+
+  int ChildSize;
+  struct LabelPoolType* Labels;
+};
+
+static void InitStats (void* local) {
+
+  memset (local, 0, sizeof (struct TreeStatsType));
+}
+
+static void VisitStats (struct TreeNodeType* node, int depth, void* local, void* context) {
+
+  struct TreeStatsType* stats = (struct TreeStatsType*) local;
+  struct StatsContextType* statsContext = (struct StatsContextType*) context;
+
+  stats->Nodes++;
+  if (depth + 1 > stats->Depth) stats->Depth = depth + 1;
+
+  int length = strlen (Label_Text (statsContext->Labels, node->Label));
+  if (length > stats->MaxDataLength) stats->MaxDataLength = length;
+
+  if (IsLeaf_N_Tree (node)) stats->Leaves++;
+}
+
+static void ReduceStats (void* total, void* local) {
+
+  struct TreeStatsType* into = (struct TreeStatsType*) total;
+  struct TreeStatsType* from = (struct TreeStatsType*) local;
+
+  into->Nodes += from->Nodes;
+  into->Leaves += from->Leaves;
+  if (from->Depth > into->Depth) into->Depth = from->Depth;
+  if (from->MaxDataLength > into->MaxDataLength) into->MaxDataLength = from->MaxDataLength;
+}
+
+struct TreeStatsType ParallelStats_N_Tree (struct N_TreeType* tree, int threadCount) {
+
+  struct TreeStatsType stats = { 0, };
+  if (tree == NULL || tree->Head == NULL) return stats;
+
+  struct StatsContextType context = { tree->ChildSize, tree->Labels };
+  struct ParallelVisitorType visitor = { VisitStats, InitStats, ReduceStats, sizeof (struct TreeStatsType), &context, 0 };
+
+  ParallelVisit_N_Tree (tree, tree->Head, &visitor, &stats, threadCount);
+  return stats;
+}
+
+// 필터 방문자: 스레드별 목록에 모은 뒤 하나로 이어 붙인다 (순서는 보장하지 않음)
+struct FilterContextType {
+
+  NodePredicateFunc Predicate;
+  void* Context;
+};
+
+static void InitFilter (void* local) {
+
+  memset (local, 0, sizeof (struct NodeListType));
+}
+
+static void VisitFilter (struct TreeNodeType* node, int depth, void* local, void* context) {
+
+  (void) depth;
+  struct FilterContextType* filter = (struct FilterContextType*) context;
+
+  if (filter->Predicate (node, filter->Context)) AppendNodeList ((struct NodeListType*) local, node);
+}
+
+static void ReduceFilter (void* total, void* local) {
+
+  struct NodeListType* into = (struct NodeListType*) total;
+  struct NodeListType* from = (struct NodeListType*) local;
+
+  for (long index = 0; index < from->Size; index++) {
+
+    AppendNodeList (into, from->Items[index]);
+  }
+  FreeNodeList (from);
+}
+
+struct NodeListType ParallelFilter_N_Tree (struct N_TreeType* tree, NodePredicateFunc predicate, void* context, int threadCount) {
+
+  struct NodeListType result = { NULL, 0, 0 };
+  if (tree == NULL || tree->Head == NULL || predicate == NULL) return result;
+
+  struct FilterContextType filter = { predicate, context };
+  struct ParallelVisitorType visitor = { VisitFilter, InitFilter, ReduceFilter, sizeof (struct NodeListType), &filter, 0 };
+
+  ParallelVisit_N_Tree (tree, tree->Head, &visitor, &result, threadCount);
+  return result;
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef _PARALLEL_H_
+#define _PARALLEL_H_
+
+#include "n_tree.h"
+#include <stddef.h>
+
+#define PARALLEL_MAX_THREADS 64
+#define PARALLEL_DEFAULT_GRAIN 1024
+#define PARALLEL_MIN_NODES 4096
+
+// 방문 콜백: local 은 스레드마다 따로 할당된 누적 버퍼
+typedef void (*ParallelVisitFunc) (struct TreeNodeType* node, int depth, void* local, void* context);
+
+struct ParallelVisitorType {
+
+  ParallelVisitFunc Visit;
+  void (*Init) (void* local);                 // 누적 버퍼 초기화
+  void (*Reduce) (void* total, void* local);  // local 을 total 에 합침
+  size_t LocalSize;
+  void* Context;                              // Visit 에 그대로 전달
+  int Grain;                                  // 분할 전에 순차로 방문할 최소 노드 수 (0 이면 기본값)
+};
+
+struct TreeStatsType {
+
+  long Nodes;
+  long Leaves;
+  int Depth;
+  int MaxDataLength;
+};
+
+typedef bool (*NodePredicateFunc) (struct TreeNodeType* node, void* context);
+
+int ParallelThreadCount (void);
+bool ParallelVisit_N_Tree (struct N_TreeType* tree, struct TreeNodeType* root, const struct ParallelVisitorType* visitor, void* result, int threadCount);
+struct TreeStatsType ParallelStats_N_Tree (struct N_TreeType* tree, int threadCount);
+struct NodeListType ParallelFilter_N_Tree (struct N_TreeType* tree, NodePredicateFunc predicate, void* context, int threadCount);
+
+#endif
\ No newline at end of file
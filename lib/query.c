@@ -0,0 +1,651 @@
+#include "query.h"
+#include "euler.h"
+#include "pager.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* SkipSpaces (const char* text) {
+
+  while (*text == ' ' || *text == '\t') text++;
+  return text;
+}
+
+static char* CopyRange (const char* start, const char* end) {
+
+  while (end > start && (end[-1] == ' ' || end[-1] == '\t')) end--;
+
+  char* copy = (char*) malloc (end - start + 1);
+  if (copy == NULL) return NULL;
+  memcpy (copy, start, end - start);
+  copy[end - start] = '\0';
+  return copy;
+}
+
+static bool ParsePredicate (const char* start, const char* end, struct QueryStepType* step) {
+
+  if (step->PredicateCount == QUERY_MAX_PREDICATES) {
+
+    printf ("Error! Too many predicates (max %d per step). Compile_Query()\n", QUERY_MAX_PREDICATES);
+    return false;
+  }
+
+  struct QueryPredicateType* predicate = &step->Predicates[step->PredicateCount];
+  memset (predicate, 0, sizeof (struct QueryPredicateType));
+  start = SkipSpaces (start);
+
+  if (*start == '@') {
+
+    predicate->Field = QUERY_ATTRIBUTE;
+    predicate->Attribute = CopyRange (start + 1, end);
+    if (predicate->Attribute == NULL) return false;
+    step->PredicateCount++;
+    return true;
+  }
+
+  const char* name = start;
+  while (start < end && *start >= 'a' && *start <= 'z') start++;
+  size_t length = start - name;
+
+  if (length == 5 && strncmp (name, "depth", 5) == 0) predicate->Field = QUERY_DEPTH;
+  else if (length == 4 && strncmp (name, "size", 4) == 0) predicate->Field = QUERY_SIZE;
+  else if (length == 8 && strncmp (name, "children", 8) == 0) predicate->Field = QUERY_CHILDREN;
+  else if (length == 3 && strncmp (name, "pos", 3) == 0) predicate->Field = QUERY_POSITION;
+  else {
+
+    printf ("Error! Unknown predicate '%.*s' (depth, size, children, pos, @attr). Compile_Query()\n", (int) (end - name), name);
+    return false;
+  }
+
+  const char* value = ParseAttributeOperator (SkipSpaces (start), &predicate->Operator);
+  char* stop = NULL;
+  if (value != NULL) predicate->Value = strtol (value, &stop, 10);
+  if (value == NULL || stop == value || SkipSpaces (stop) != end) {
+
+    printf ("Error! Expected <field><op><number> in '%.*s'. Compile_Query()\n", (int) (end - name), name);
+    return false;
+  }
+
+  // 가지치기에 쓸 범위: 깊이 상한, 서브트리 크기 하한
+  long bound = predicate->Value;
+  if (predicate->Field == QUERY_DEPTH) {
+
+    if (predicate->Operator == ATTR_OP_LT) bound--;
+    if ((predicate->Operator == ATTR_OP_LT || predicate->Operator == ATTR_OP_LE || predicate->Operator == ATTR_OP_EQ) && bound < step->MaxDepth) {
+
+      step->MaxDepth = bound < -1 ? -1 : (int) bound;
+    }
+  } else if (predicate->Field == QUERY_SIZE) {
+
+    if (predicate->Operator == ATTR_OP_GT) bound++;
+    if ((predicate->Operator == ATTR_OP_GT || predicate->Operator == ATTR_OP_GE || predicate->Operator == ATTR_OP_EQ) && bound > step->MinSize) {
+
+      step->MinSize = bound > INT_MAX ? INT_MAX : (int) bound;
+    }
+  }
+
+  step->PredicateCount++;
+  return true;
+}
+
+// 뒤 단계의 조건을 앞 단계로 끌어올린다: 뒤 단계 노드는 적어도 한 단계 더 깊고 서브트리가 더 작다
+static void PlanBounds (struct QueryType* query) {
+
+  int reach = INT_MAX;
+  int need = 0;
+
+  for (int index = query->StepCount - 1; index >= 0; index--) {
+
+    struct QueryStepType* step = &query->Steps[index];
+    step->Reach = step->MaxDepth < reach ? step->MaxDepth : reach;
+    step->NeedSize = step->MinSize > need ? step->MinSize : need;
+
+    switch (step->Axis) {
+
+      case QUERY_CHILD:
+      case QUERY_DESCENDANT:
+        reach = step->Reach == INT_MAX ? INT_MAX : step->Reach - 1;
+        need = step->NeedSize + 1;
+        break;
+      case QUERY_SELF:
+        reach = step->Reach;
+        need = step->NeedSize;
+        break;
+      default:
+        reach = INT_MAX;
+        need = 0;
+        break;
+    }
+  }
+}
+
+struct QueryType* Compile_Query (const char* text) {
+
+  if (text == NULL) {
+
+    printf ("Error! Query text is NULL. Compile_Query()\n");
+    return NULL;
+  }
+
+  struct QueryType* query = (struct QueryType*) calloc (1, sizeof (struct QueryType));
+  if (query == NULL) {
+
+    printf ("Error! The dynamic memory allocation failed. Compile_Query()\n");
+    return NULL;
+  }
+
+  const char* p = SkipSpaces (text);
+  enum QueryAxisType axis = QUERY_CHILD;
+
+  if (p[0] == '/' && p[1] == '/') { query->Absolute = true; axis = QUERY_DESCENDANT; p += 2; }
+  else if (p[0] == '/') { query->Absolute = true; p++; }
+
+  while (true) {
+
+    if (query->StepCount == QUERY_MAX_STEPS) {
+
+      printf ("Error! Too many steps (max %d). Compile_Query()\n", QUERY_MAX_STEPS);
+      goto fail;
+    }
+
+    struct QueryStepType* step = &query->Steps[query->StepCount++];
+    step->Axis = axis;
+    step->Label = LABEL_NONE;
+    step->MaxDepth = INT_MAX;
+
+    const char* name = SkipSpaces (p);
+    while (*p && *p != '/' && *p != '[') p++;
+    char* pattern = CopyRange (name, p);
+    if (pattern == NULL) {
+
+      printf ("Error! The dynamic memory allocation failed(2). Compile_Query()\n");
+      goto fail;
+    }
+
+    if (pattern[0] == '\0') {
+
+      printf ("Error! Empty step in '%s'. Compile_Query()\n", text);
+      free (pattern);
+      goto fail;
+    }
+    if (strcmp (pattern, ".") == 0 || strcmp (pattern, "..") == 0) {
+
+      if (axis == QUERY_DESCENDANT) {
+
+        printf ("Error! '//%s' is not supported. Compile_Query()\n", pattern);
+        free (pattern);
+        goto fail;
+      }
+      step->Axis = pattern[1] == '.' ? QUERY_PARENT : QUERY_SELF;
+      free (pattern);
+    } else {
+
+      step->Pattern = pattern;
+      step->PrefixLength = strcspn (pattern, "*?");
+      step->Wildcard = pattern[step->PrefixLength] != '\0';
+    }
+
+    while (*p == '[') {
+
+      const char* close = strchr (p, ']');
+      if (close == NULL) {
+
+        printf ("Error! Missing ']' in '%s'. Compile_Query()\n", text);
+        goto fail;
+      }
+
+      const char* start = p + 1;
+      while (start < close) {
+
+        const char* comma = memchr (start, ',', close - start);
+        const char* end = comma == NULL ? close : comma;
+        if (!ParsePredicate (start, end, step)) goto fail;
+        start = end + 1;
+      }
+      p = SkipSpaces (close + 1);
+    }
+
+    if (*p == '\0') break;
+    if (p[0] == '/' && p[1] == '/') { axis = QUERY_DESCENDANT; p += 2; }
+    else if (p[0] == '/') { axis = QUERY_CHILD; p++; }
+    else {
+
+      printf ("Error! Unexpected '%c' in '%s'. Compile_Query()\n", *p, text);
+      goto fail;
+    }
+  }
+
+  PlanBounds (query);
+  return query;
+
+fail:
+  Delete_Query (query);
+  return NULL;
+}
+
+// '*' 는 임의 길이, '?' 는 한 글자
+static bool MatchGlob (const char* pattern, const char* text) {
+
+  const char* star = NULL;
+  const char* resume = NULL;
+
+  while (*text) {
+
+    if (*pattern == '*') {
+
+      star = pattern++;
+      resume = text;
+    } else if (*pattern == '?' || *pattern == *text) {
+
+      pattern++;
+      text++;
+    } else if (star != NULL) {
+
+      pattern = star + 1;
+      text = ++resume;
+    } else {
+
+      return false;
+    }
+  }
+  while (*pattern == '*') pattern++;
+  return *pattern == '\0';
+}
+
+static int SlotOf (struct N_TreeType* tree, struct TreeNodeType* node) {
+
+  if (node->Parent == NULL || node->Slot >= tree->ChildSize || ChildAt_N_Tree (node->Parent, node->Slot) != node) return -1;
+  return node->Slot;
+}
+
+// 값싼 조건부터: 깊이/서브트리 크기, 레이블 핸들, 이름 패턴, 자식 배열, 속성 열
+static bool MatchStep (struct N_TreeType* tree, struct QueryStepType* step, struct TreeNodeType* node, int size) {
+
+  if (node->Depth > step->Reach || size < step->NeedSize) return false;
+
+  for (int index = 0; index < step->PredicateCount; index++) {
+
+    struct QueryPredicateType* predicate = &step->Predicates[index];
+    long value;
+
+    if (predicate->Field == QUERY_DEPTH) value = node->Depth;
+    else if (predicate->Field == QUERY_SIZE) value = size;
+    else continue;
+
+    if (!CompareAttributeOrder ((value > predicate->Value) - (value < predicate->Value), predicate->Operator)) return false;
+  }
+
+  if (step->Pattern != NULL) {
+
+    if (!step->Wildcard) {
+
+      if (node->Label != step->Label) return false;
+    } else {
+
+      const char* text = Label_Text (tree->Labels, node->Label);
+      if (strncmp (text, step->Pattern, step->PrefixLength) != 0) return false;
+      if (!MatchGlob (step->Pattern + step->PrefixLength, text + step->PrefixLength)) return false;
+    }
+  }
+
+  for (int index = 0; index < step->PredicateCount; index++) {
+
+    struct QueryPredicateType* predicate = &step->Predicates[index];
+    long value;
+
+    if (predicate->Field == QUERY_CHILDREN) value = Fault_N_Tree (tree, node) ? ChildCount_N_Tree (node) : 0;
+    else if (predicate->Field == QUERY_POSITION) value = SlotOf (tree, node);
+    else if (predicate->Field == QUERY_ATTRIBUTE) {
+
+      if (!TestAttributeCondition (tree, &predicate->Condition, node->Id)) return false;
+      continue;
+    } else continue;
+
+    if (!CompareAttributeOrder ((value > predicate->Value) - (value < predicate->Value), predicate->Operator)) return false;
+  }
+  return true;
+}
+
+// 실행 전에 레이블 핸들과 속성 열을 찾아 둔다. 하나라도 없으면 결과가 비어 있음이 확정된다.
+static bool BindQuery (struct N_TreeType* tree, struct QueryType* query, bool* empty) {
+
+  *empty = false;
+
+  for (int index = 0; index < query->StepCount; index++) {
+
+    struct QueryStepType* step = &query->Steps[index];
+
+    if (step->Pattern != NULL && !step->Wildcard) {
+
+      step->Label = Find_Label (tree->Labels, step->Pattern);
+      if (step->Label == LABEL_NONE) *empty = true;
+    }
+    if (step->Reach < 0) *empty = true;
+
+    for (int item = 0; item < step->PredicateCount; item++) {
+
+      struct QueryPredicateType* predicate = &step->Predicates[item];
+      if (predicate->Field != QUERY_ATTRIBUTE) continue;
+
+      if (!ParseAttributeCondition (tree, predicate->Attribute, &predicate->Condition)) return false;
+      if (predicate->Condition.Column == NULL) *empty = true;
+    }
+  }
+  return true;
+}
+
+static int CompareEntry (const void* left, const void* right) {
+
+  const struct TreeNodeType* a = *(struct TreeNodeType* const*) left;
+  const struct TreeNodeType* b = *(struct TreeNodeType* const*) right;
+
+  // NULL 은 루트 위의 가상 문서 노드
+  if (a == NULL || b == NULL) return (a != NULL) - (b != NULL);
+  return (a->Entry > b->Entry) - (a->Entry < b->Entry);
+}
+
+// 색인 없이 문서 순서로 비교한다: 같은 깊이까지 올린 뒤 처음 갈라지는 곳의 슬롯 번호 (조상이 먼저)
+static int CompareDocument (const void* left, const void* right) {
+
+  const struct TreeNodeType* a = *(struct TreeNodeType* const*) left;
+  const struct TreeNodeType* b = *(struct TreeNodeType* const*) right;
+
+  if (a == NULL || b == NULL) return (a != NULL) - (b != NULL);
+
+  int aDepth = 0, bDepth = 0;
+  for (const struct TreeNodeType* at = a->Parent; at != NULL; at = at->Parent) aDepth++;
+  for (const struct TreeNodeType* at = b->Parent; at != NULL; at = at->Parent) bDepth++;
+
+  const struct TreeNodeType* x = a;
+  const struct TreeNodeType* y = b;
+  for (; aDepth > bDepth; aDepth--) x = x->Parent;
+  for (; bDepth > aDepth; bDepth--) y = y->Parent;
+  if (x == y) return (a != x) - (b != y);
+
+  while (x->Parent != y->Parent) {
+
+    x = x->Parent;
+    y = y->Parent;
+  }
+  return (x->Slot > y->Slot) - (x->Slot < y->Slot);
+}
+
+static bool NeedsSize (struct QueryStepType* step) {
+
+  if (step->NeedSize > 1) return true;
+  for (int index = 0; index < step->PredicateCount; index++) {
+
+    if (step->Predicates[index].Field == QUERY_SIZE) return true;
+  }
+  return false;
+}
+
+// 색인이 있으면 번호로, 없으면 조건에 크기가 있을 때만 센다 (그 밖에는 어느 노드나 만족하는 1)
+static int SizeOf (struct N_TreeType* tree, struct QueryType* query, struct QueryStepType* step, struct TreeNodeType* node) {
+
+  if (query->Indexed) return node->Exit - node->Entry;
+  return NeedsSize (step) ? SubtreeSize_N_Tree (tree, node) : 1;
+}
+
+// 단계마다 이미 담은 노드 (노드 번호 -> 단계 번호). 지연 로딩 트리는 질의 중에 노드가 생기므로 늘어난다.
+struct SeenType {
+
+  int* Stamps;
+  int Capacity;
+};
+
+static bool GrowSeen (struct SeenType* seen, int id) {
+
+  int capacity = seen->Capacity > 0 ? seen->Capacity : 64;
+  while (capacity <= id) capacity *= 2;
+
+  int* stamps = (int*) realloc (seen->Stamps, (size_t) capacity * sizeof (int));
+  if (stamps == NULL) return false;
+  memset (stamps + seen->Capacity, 0, (size_t) (capacity - seen->Capacity) * sizeof (int));
+  seen->Stamps = stamps;
+  seen->Capacity = capacity;
+  return true;
+}
+
+static bool Emit (struct N_TreeType* tree, struct QueryType* query, struct QueryStepType* step, struct TreeNodeType* node, int size,
+                  struct SeenType* seen, int stamp, struct NodeListType* next) {
+
+  query->Visited++;
+  if (node->Id >= seen->Capacity && !GrowSeen (seen, node->Id)) return false;
+  if (seen->Stamps[node->Id] == stamp || !MatchStep (tree, step, node, size)) return true;
+
+  seen->Stamps[node->Id] = stamp;
+  return AppendNodeList (next, node);
+}
+
+// 자손 단계: 전위 순서 배열의 [first, last) 구간을 훑고, 조건을 만족할 수 없는 서브트리는 Exit 로 건너뛴다.
+// sizes 가 NULL 이면 크기는 진입/탈출 번호의 차이다.
+static bool ScanDescendants (struct N_TreeType* tree, struct QueryType* query, struct QueryStepType* step,
+                             struct TreeNodeType** order, const int* sizes, int first, int last,
+                             struct SeenType* seen, int stamp, struct NodeListType* next) {
+
+  int entry = first;
+
+  while (entry < last) {
+
+    struct TreeNodeType* node = order[entry];
+    int size = sizes != NULL ? sizes[entry] : node->Exit - node->Entry;
+    if (node->Depth > step->Reach || size < step->NeedSize) {
+
+      query->Visited++;
+      entry = node->Exit;
+      continue;
+    }
+    if (!Emit (tree, query, step, node, size, seen, stamp, next)) return false;
+    entry++;
+  }
+  return true;
+}
+
+// 색인 없이 context 아래(NULL 이면 루트부터)만 전위 순서로 모아 그 안에서 번호와 크기를 매긴 뒤 훑는다.
+// 조건의 깊이 상한에 닿은 노드 아래는 내려가지 않으므로 지연 로딩 트리는 그 위까지만 읽는다.
+static bool ScanScope (struct N_TreeType* tree, struct QueryType* query, struct QueryStepType* step, struct TreeNodeType* context,
+                       struct SeenType* seen, int stamp, struct NodeListType* next) {
+
+  struct NodeListType order = { NULL, 0, 0 };
+  struct NodeListType stack = { NULL, 0, 0 };
+  bool ok = true;
+
+  if (context == NULL) {
+
+    tree->Head->Depth = 0;
+    ok = AppendNodeList (&stack, tree->Head);
+  } else if (context->Depth + 1 <= step->Reach && Fault_N_Tree (tree, context)) {
+
+    FOR_EACH_CHILD_SLOT_REVERSE (context, slot) {
+
+      context->Children[slot]->Depth = context->Depth + 1;
+      if (ok) ok = AppendNodeList (&stack, context->Children[slot]);
+    }
+  }
+
+  while (ok && stack.Size > 0) {
+
+    struct TreeNodeType* node = stack.Items[--stack.Size];
+    node->Entry = (int) order.Size;
+    node->Exit = node->Entry + 1;
+    if (!AppendNodeList (&order, node)) {
+
+      ok = false;
+      break;
+    }
+    if (node->Depth >= step->Reach || !Fault_N_Tree (tree, node)) continue;
+
+    FOR_EACH_CHILD_SLOT_REVERSE (node, slot) {
+
+      node->Children[slot]->Depth = node->Depth + 1;
+      if (ok) ok = AppendNodeList (&stack, node->Children[slot]);
+    }
+  }
+
+  int* sizes = ok ? (int*) malloc ((order.Size > 0 ? order.Size : 1) * sizeof (int)) : NULL;
+  if (sizes != NULL) {
+
+    // 내려가지 않은 노드는 남은 서브트리를 따로 센다 (크기 조건이 없으면 1)
+    bool counted = NeedsSize (step);
+    for (long entry = 0; entry < order.Size; entry++) {
+
+      struct TreeNodeType* node = order.Items[entry];
+      sizes[entry] = counted && (node->Depth >= step->Reach || node->Paged) ? SubtreeSize_N_Tree (tree, node) : 1;
+    }
+    for (long entry = order.Size - 1; entry >= 0; entry--) {
+
+      struct TreeNodeType* node = order.Items[entry];
+      if (node->Parent == context) continue;
+      if (counted) sizes[node->Parent->Entry] += sizes[entry];
+      if (node->Exit > node->Parent->Exit) node->Parent->Exit = node->Exit;
+    }
+    ok = ScanDescendants (tree, query, step, order.Items, sizes, 0, (int) order.Size, seen, stamp, next);
+  }
+  if (sizes == NULL) ok = false;
+
+  free (sizes);
+  FreeNodeList (&order);
+  FreeNodeList (&stack);
+  return ok;
+}
+
+static bool RunStep (struct N_TreeType* tree, struct QueryType* query, struct QueryStepType* step, struct NodeListType* contexts,
+                     struct SeenType* seen, int stamp, struct NodeListType* next) {
+
+  if (step->Axis == QUERY_DESCENDANT) {
+
+    // 다른 문맥 노드 안에 들어 있는 문맥 노드는 이미 훑은 구간이다
+    qsort (contexts->Items, contexts->Size, sizeof (struct TreeNodeType*), query->Indexed ? CompareEntry : CompareDocument);
+    int covered = -1;
+    bool all = false;
+    struct TreeNodeType* scanned = NULL;
+
+    for (long index = 0; index < contexts->Size; index++) {
+
+      struct TreeNodeType* context = contexts->Items[index];
+      if (!query->Indexed) {
+
+        if (all || (scanned != NULL && IsAncestor_N_Tree (tree, scanned, context))) continue;
+        if (!ScanScope (tree, query, step, context, seen, stamp, next)) return false;
+        all = context == NULL;
+        scanned = context;
+        continue;
+      }
+
+      int first = context == NULL ? 0 : context->Entry + 1;
+      int last = context == NULL ? tree->Euler->Size : context->Exit;
+
+      if (first <= covered) continue;
+      if (!ScanDescendants (tree, query, step, tree->Euler->Order, NULL, first, last, seen, stamp, next)) return false;
+      covered = last - 1;
+    }
+    return true;
+  }
+
+  for (long index = 0; index < contexts->Size; index++) {
+
+    struct TreeNodeType* context = contexts->Items[index];
+
+    if (step->Axis == QUERY_CHILD) {
+
+      if (context == NULL) {
+
+        tree->Head->Depth = 0;
+        if (!Emit (tree, query, step, tree->Head, SizeOf (tree, query, step, tree->Head), seen, stamp, next)) return false;
+        continue;
+      }
+      // 자식은 모두 같은 깊이이므로 한 번에 걸러진다
+      if (context->Depth + 1 > step->Reach || !Fault_N_Tree (tree, context)) continue;
+
+      FOR_EACH_CHILD_SLOT (context, slot) {
+
+        struct TreeNodeType* child = context->Children[slot];
+        if (!query->Indexed) child->Depth = context->Depth + 1;
+        if (!Emit (tree, query, step, child, SizeOf (tree, query, step, child), seen, stamp, next)) return false;
+      }
+    } else if (context != NULL) {
+
+      struct TreeNodeType* node = step->Axis == QUERY_SELF ? context : context->Parent;
+      if (node == NULL) continue;
+      if (!query->Indexed) node->Depth = step->Axis == QUERY_SELF ? context->Depth : context->Depth - 1;
+      if (!Emit (tree, query, step, node, SizeOf (tree, query, step, node), seen, stamp, next)) return false;
+    }
+  }
+  return true;
+}
+
+bool Run_Query (struct N_TreeType* tree, struct QueryType* query, struct TreeNodeType* context, struct NodeListType* result) {
+
+  if (tree == NULL || query == NULL || result == NULL) {
+
+    printf ("Error! Invalid arguments. Run_Query()\n");
+    return false;
+  }
+  if (!query->Absolute && context == NULL) context = tree->Head;
+
+  query->Visited = 0;
+  // 색인이 낡았으면 다시 매기지 않고 문맥 노드에서 직접 훑는다 (질의가 닿는 곳만 보고, 지연 로딩 트리를 모두 읽지 않음)
+  query->Indexed = tree->Euler != NULL && tree->Euler->Valid;
+  if (!query->Indexed && context != NULL) context->Depth = Depth_N_Tree (tree, context);
+
+  bool empty = false;
+  if (!BindQuery (tree, query, &empty)) return false;
+  if (empty) return true;
+
+  struct SeenType seen = { NULL, 0 };
+  struct NodeListType contexts = { NULL, 0, 0 };
+  struct NodeListType next = { NULL, 0, 0 };
+  bool ok = GrowSeen (&seen, tree->NextId) && AppendNodeList (&contexts, query->Absolute ? NULL : context);
+
+  for (int index = 0; ok && index < query->StepCount && contexts.Size > 0; index++) {
+
+    next.Size = 0;
+    ok = RunStep (tree, query, &query->Steps[index], &contexts, &seen, index + 1, &next);
+
+    struct NodeListType swap = contexts;
+    contexts = next;
+    next = swap;
+  }
+
+  if (ok) {
+
+    if (contexts.Size > 1) qsort (contexts.Items, contexts.Size, sizeof (struct TreeNodeType*), query->Indexed ? CompareEntry : CompareDocument);
+    for (long index = 0; ok && index < contexts.Size; index++) {
+
+      if (contexts.Items[index] != NULL) ok = AppendNodeList (result, contexts.Items[index]);
+    }
+  }
+  if (!ok) printf ("Error! The dynamic memory allocation failed. Run_Query()\n");
+
+  FreeNodeList (&contexts);
+  FreeNodeList (&next);
+  free (seen.Stamps);
+  return ok;
+}
+
+bool Query_N_Tree (struct N_TreeType* tree, struct TreeNodeType* context, const char* text, struct NodeListType* result) {
+
+  struct QueryType* query = Compile_Query (text);
+  if (query == NULL) return false;
+
+  bool ok = Run_Query (tree, query, context, result);
+  Delete_Query (query);
+  return ok;
+}
+
+void Delete_Query (struct QueryType* query) {
+
+  if (query == NULL) return;
+
+  for (int index = 0; index < query->StepCount; index++) {
+
+    free (query->Steps[index].Pattern);
+    for (int item = 0; item < query->Steps[index].PredicateCount; item++) {
+
+      free (query->Steps[index].Predicates[item].Attribute);
+    }
+  }
+  free (query);
+}
\ No newline at end of file
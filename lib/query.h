@@ -0,0 +1,55 @@
+#ifndef _QUERY_H_
+#define _QUERY_H_
+
+#include "n_tree.h"
+#include "attr.h"
+
+#define QUERY_MAX_STEPS 32
+#define QUERY_MAX_PREDICATES 8
+
+// 경로 질의: "/Root/*/Build//test*[depth<4]", "Deploy/svc-*[depth<=3]", "//*[@status=failed]"
+//   /a    자식 중 이름이 a 인 노드        //a   자손 중 이름이 a 인 노드
+//   *, ?  이름 와일드카드                 . .. 현재 노드, 부모 노드
+//   [depth<4] [size>=10] [children=0] [pos=2] [@attr op value]  ("," 나 [][] 는 모두 만족)
+enum QueryAxisType { QUERY_CHILD, QUERY_DESCENDANT, QUERY_SELF, QUERY_PARENT };
+enum QueryFieldType { QUERY_DEPTH, QUERY_SIZE, QUERY_CHILDREN, QUERY_POSITION, QUERY_ATTRIBUTE };
+
+struct QueryPredicateType {
+
+  enum QueryFieldType Field;
+  enum AttributeOperatorType Operator;
+  long Value;
+  char* Attribute;                          // QUERY_ATTRIBUTE: "name<op>value"
+  struct AttributeConditionType Condition;  // 실행할 때 속성 열에 묶인다
+};
+
+struct QueryStepType {
+
+  enum QueryAxisType Axis;
+  char* Pattern;        // 이름 패턴 (. 과 .. 은 NULL)
+  bool Wildcard;
+  int PrefixLength;     // 첫 와일드카드 앞까지의 길이
+  LabelType Label;      // 와일드카드가 없으면 실행할 때 찾아 둔 핸들
+  struct QueryPredicateType Predicates[QUERY_MAX_PREDICATES];
+  int PredicateCount;
+  int MaxDepth;         // 이 단계 조건이 허용하는 최대 깊이
+  int MinSize;          // 이 단계 조건이 요구하는 최소 서브트리 크기
+  int Reach;            // 이 단계 노드가 가질 수 있는 최대 깊이 (뒤 단계까지 고려)
+  int NeedSize;         // 이 단계 노드가 가져야 하는 최소 서브트리 크기 (뒤 단계까지 고려)
+};
+
+struct QueryType {
+
+  bool Absolute;
+  int StepCount;
+  struct QueryStepType Steps[QUERY_MAX_STEPS];
+  long Visited;         // 마지막 실행에서 검사한 노드 수
+  bool Indexed;         // 마지막 실행이 전위 번호 색인을 썼는지 (아니면 문맥 노드부터 직접 훑음)
+};
+
+struct QueryType* Compile_Query (const char* text);
+bool Run_Query (struct N_TreeType* tree, struct QueryType* query, struct TreeNodeType* context, struct NodeListType* result);
+bool Query_N_Tree (struct N_TreeType* tree, struct TreeNodeType* context, const char* text, struct NodeListType* result);
+void Delete_Query (struct QueryType* query);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include "report.h"
+#include "parallel.h"
+#include "euler.h"
+#include "attr.h"
+#include "pager.h"
+#include "rollup.h"
+#include "deps.h"
+#include <string.h>
+#include <stdio.h>
+
+static void InitReport (void* local) {
+
+  memset (local, 0, sizeof (struct TreeReportType));
+}
+
+static void VisitReport (struct TreeNodeType* node, int depth, void* local, void* context) {
+
+  struct TreeReportType* report = (struct TreeReportType*) local;
+  (void) context;
+
+  // 자식 수와 사용한 슬롯 폭은 점유 비트에서 바로 읽는다
+  int children = ChildCount_N_Tree (node);
+  int span = LastChildSlot_N_Tree (node) + 1;
+
+  report->Nodes++;
+  if (children == 0) report->Leaves++;
+  if (node->InSlab) report->SlabNodes++;
+  if (node->Capacity > 0) report->ChildArrayBytes += CHILD_BLOCK_BYTES (node->Capacity);
+  report->ChildCapacity += node->Capacity;
+  report->SpanSlots += span;
+  report->Occupancy[children < REPORT_FANOUT_BUCKETS ? children : REPORT_FANOUT_BUCKETS - 1]++;
+  report->Span[span < REPORT_FANOUT_BUCKETS ? span : REPORT_FANOUT_BUCKETS - 1]++;
+  if (children > report->MaxFanOut) report->MaxFanOut = children;
+  if (span > report->MaxSpan) report->MaxSpan = span;
+  report->Depths[depth < REPORT_DEPTH_BUCKETS ? depth : REPORT_DEPTH_BUCKETS - 1]++;
+  if (depth > report->MaxDepth) report->MaxDepth = depth;
+}
+
+static void ReduceReport (void* total, void* local) {
+
+  struct TreeReportType* into = (struct TreeReportType*) total;
+  struct TreeReportType* from = (struct TreeReportType*) local;
+
+  into->Nodes += from->Nodes;
+  into->Leaves += from->Leaves;
+  into->SlabNodes += from->SlabNodes;
+  into->ChildArrayBytes += from->ChildArrayBytes;
+  into->ChildCapacity += from->ChildCapacity;
+  into->SpanSlots += from->SpanSlots;
+  if (from->MaxDepth > into->MaxDepth) into->MaxDepth = from->MaxDepth;
+  if (from->MaxFanOut > into->MaxFanOut) into->MaxFanOut = from->MaxFanOut;
+  if (from->MaxSpan > into->MaxSpan) into->MaxSpan = from->MaxSpan;
+  for (int index = 0; index < REPORT_FANOUT_BUCKETS; index++) {
+
+    into->Occupancy[index] += from->Occupancy[index];
+    into->Span[index] += from->Span[index];
+  }
+  for (int index = 0; index < REPORT_DEPTH_BUCKETS; index++) into->Depths[index] += from->Depths[index];
+}
+
+static size_t AttributeTableBytes (struct AttributeTableType* table) {
+
+  if (table == NULL) return 0;
+
+  size_t bytes = sizeof (struct AttributeTableType) + (size_t) table->Capacity * sizeof (struct AttributeColumnType);
+  for (int index = 0; index < table->Count; index++) {
+
+    struct AttributeColumnType* column = &table->Columns[index];
+    size_t valueSize = column->Kind == ATTR_STRING ? sizeof (LabelType) : column->Kind == ATTR_FLOAT ? sizeof (double) : sizeof (long long);
+    bytes += (size_t) column->Capacity / 64 * sizeof (unsigned long long) + (size_t) column->Capacity * valueSize;
+  }
+  return bytes;
+}
+
+static size_t PagerBytes (struct PagerType* pager) {
+
+  if (pager == NULL) return 0;
+
+  size_t bytes = sizeof (struct PagerType) + sizeof (struct SnapshotChunkType) +
+                 (size_t) pager->Chunk->ChildCapacity * (sizeof (int) + sizeof (unsigned long long)) +
+                 (size_t) pager->EntryCapacity * sizeof (struct PagerEntryType) + (size_t) pager->UseCapacity * sizeof (unsigned long);
+  struct SnapshotType* snapshot = pager->Snapshot;
+  if (snapshot != NULL) {
+
+    bytes += sizeof (struct SnapshotType) + (size_t) snapshot->Capacity * (sizeof (unsigned long long) + sizeof (long) + sizeof (int));
+  }
+  return bytes;
+}
+
+// 메모리 사용량과 모양 분포를 구한다. 큰 트리는 병렬 방문자로 훑는다.
+bool Report_N_Tree (struct N_TreeType* tree, struct TreeReportType* report) {
+
+  if (tree == NULL || tree->Head == NULL || report == NULL) {
+
+    printf ("Error! Invalid arguments. Report_N_Tree()\n");
+    return false;
+  }
+
+  int childSize = tree->ChildSize;
+  struct ParallelVisitorType visitor = { VisitReport, InitReport, ReduceReport, sizeof (struct TreeReportType), &childSize, 0 };
+  if (!ParallelVisit_N_Tree (tree, tree->Head, &visitor, report, 0)) return false;
+
+  report->ChildSize = childSize;
+  report->NodeBytes = (size_t) report->Nodes * NODE_BYTES (tree);
+
+  struct LabelPoolType* labels = tree->Labels;
+  if (labels != NULL) {
+
+    report->LabelBytes = sizeof (struct LabelPoolType) + labels->Capacity +
+                         ((size_t) labels->OffsetCapacity + labels->BucketCount) * sizeof (unsigned int);
+  }
+  report->RegistryBytes = (size_t) tree->NodeCapacity * sizeof (struct TreeNodeType*);
+
+  struct EulerIndexType* euler = tree->Euler;
+  if (euler != NULL) {
+
+    report->EulerBytes = sizeof (struct EulerIndexType) + (size_t) euler->Size * sizeof (struct TreeNodeType*) +
+                         (size_t) euler->Levels * euler->Size * sizeof (int);
+  }
+  if (tree->Rollup != NULL) {
+
+    report->RollupBytes = sizeof (struct RollupIndexType) + (size_t) tree->Rollup->Capacity * sizeof (struct RollupValueType);
+  }
+  report->DependencyBytes = DependencyBytes_N_Tree (tree);
+  report->AttributeBytes = AttributeTableBytes (tree->Attributes);
+  report->PagerBytes = PagerBytes (tree->Pager);
+  report->TotalBytes = sizeof (struct N_TreeType) + report->NodeBytes + report->ChildArrayBytes + report->LabelBytes +
+                       report->RegistryBytes + report->EulerBytes + report->RollupBytes + report->DependencyBytes +
+                       report->AttributeBytes + report->PagerBytes;
+
+  // 슬롯 번호는 경로의 일부이므로 권장값은 지금 위치를 그대로 담는 크기로 한다
+  report->RecommendedChildSize = report->MaxSpan > 0 ? report->MaxSpan : 1;
+  report->CompactChildSize = report->MaxFanOut > 0 ? report->MaxFanOut : 1;
+  report->RecommendedSavings = (size_t) (report->ChildCapacity - report->SpanSlots) * sizeof (struct TreeNodeType*);
+  return true;
+}
+
+// 자식이 있는 노드의 자식 수 백분위 (percentile 은 0 ~ 100)
+int FanOutPercentile_N_Tree (const struct TreeReportType* report, double percentile) {
+
+  long internal = report->Nodes - report->Occupancy[0];
+  if (internal <= 0) return 0;
+
+  long rank = (long) (percentile / 100.0 * internal + 0.5);
+  if (rank < 1) rank = 1;
+
+  long seen = 0;
+  for (int index = 1; index < REPORT_FANOUT_BUCKETS; index++) {
+
+    seen += report->Occupancy[index];
+    // 마지막 칸은 CHILD_SIZE 이상을 모두 담으므로 최댓값으로 답한다
+    if (seen >= rank) return index < REPORT_FANOUT_BUCKETS - 1 ? index : report->MaxFanOut;
+  }
+  return report->MaxFanOut;
+}
\ No newline at end of file
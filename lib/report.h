@@ -0,0 +1,47 @@
+#ifndef _REPORT_H_
+#define _REPORT_H_
+
+#include "n_tree.h"
+
+#define REPORT_DEPTH_BUCKETS 64  // 마지막 칸은 그 이상 깊이를 모두 센다
+#define REPORT_FANOUT_BUCKETS (CHILD_SIZE + 1)  // 자식 수/슬롯 폭 분포 (마지막 칸은 CHILD_SIZE 이상)
+
+// 트리 한 벌이 쓰는 메모리와 모양. 바이트는 할당한 용량 기준이다 (malloc 머리 공간 제외).
+struct TreeReportType {
+
+  // 메모리
+  size_t NodeBytes;        // 노드 구조체
+  size_t ChildArrayBytes;  // 자식 블록 (포인터, 점유 비트, 순위 표)
+  size_t LabelBytes;       // 레이블 표 (문자열, 위치 표, 해시 칸)
+  size_t RegistryBytes;    // 노드 번호 -> 노드 표
+  size_t EulerBytes;       // 전위 번호와 조상 점프 표
+  size_t RollupBytes;      // 소요 시간/비용 합계
+  size_t DependencyBytes;  // 의존 간선 목록과 위상 순위
+  size_t AttributeBytes;   // 속성 열
+  size_t PagerBytes;       // 지연 로딩 상태와 스냅숏 색인
+  size_t TotalBytes;
+
+  // 모양 (메모리에 있는 노드만, 아직 읽지 않은 서브트리는 자리표시자 하나로 센다)
+  long Nodes;
+  long Leaves;
+  long SlabNodes;
+  int ChildSize;
+  int MaxDepth;
+  long ChildCapacity;                        // 자식 블록에 잡힌 슬롯 수 합
+  long SpanSlots;                            // 노드마다 (마지막으로 쓴 슬롯 + 1) 의 합
+  long Occupancy[REPORT_FANOUT_BUCKETS];     // 자식이 k 개인 노드 수
+  long Span[REPORT_FANOUT_BUCKETS];          // 마지막으로 쓴 슬롯 + 1 이 k 인 노드 수
+  long Depths[REPORT_DEPTH_BUCKETS];         // 깊이별 노드 수
+  int MaxFanOut;
+  int MaxSpan;
+
+  // ChildSize 권장값
+  int RecommendedChildSize;  // 지금 슬롯 위치를 그대로 담는 가장 작은 ChildSize (= MaxSpan)
+  int CompactChildSize;      // 자식을 앞 슬롯부터 다시 채우면 충분한 ChildSize (= MaxFanOut)
+  size_t RecommendedSavings; // 자식 블록을 슬롯 폭에 딱 맞췄을 때 줄어드는 바이트 (두 배씩 늘린 여유분)
+};
+
+bool Report_N_Tree (struct N_TreeType* tree, struct TreeReportType* report);
+int FanOutPercentile_N_Tree (const struct TreeReportType* report, double percentile);
+
+#endif
\ No newline at end of file
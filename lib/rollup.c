@@ -0,0 +1,179 @@
+#include "rollup.h"
+#include "attr.h"
+#include "euler.h"
+#include "pager.h"
+#include "run.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 숫자 속성 값 (없거나 숫자가 아니면 0)
+static double NumberAttribute (struct N_TreeType* tree, struct TreeNodeType* node, const char* name) {
+
+  struct AttributeColumnType* column = FindAttributeColumn (tree->Attributes, name);
+  if (!HasAttributeValue (column, node->Id)) return 0.0;
+  if (column->Kind == ATTR_INT) return (double) column->Values.Ints[node->Id];
+  if (column->Kind == ATTR_FLOAT) return column->Values.Floats[node->Id];
+  return 0.0;
+}
+
+static bool IsParallel (struct N_TreeType* tree, struct TreeNodeType* node) {
+
+  struct AttributeColumnType* column = FindAttributeColumn (tree->Attributes, RUN_ATTR_MODE);
+  if (column == NULL || column->Kind != ATTR_STRING || !HasAttributeValue (column, node->Id)) return false;
+  return strcmp (Label_Text (tree->Labels, column->Values.Strings[node->Id]), "parallel") == 0;
+}
+
+// 노드 번호 capacity 개를 담도록 늘린다 (새 칸은 0)
+static bool EnsureRollupCapacity (struct RollupIndexType* index, int capacity) {
+
+  if (capacity <= index->Capacity) return true;
+
+  int size = index->Capacity == 0 ? 256 : index->Capacity;
+  while (size < capacity) size *= 2;
+
+  struct RollupValueType* values = (struct RollupValueType*) realloc (index->Values, (size_t) size * sizeof (struct RollupValueType));
+  if (values == NULL) return false;
+
+  memset (values + index->Capacity, 0, (size_t) (size - index->Capacity) * sizeof (struct RollupValueType));
+  index->Values = values;
+  index->Capacity = size;
+  return true;
+}
+
+// 자식의 합계가 맞다고 보고 node 하나만 다시 계산한다
+static void Refresh (struct N_TreeType* tree, struct RollupValueType* values, struct TreeNodeType* node) {
+
+  bool parallel = IsParallel (tree, node);
+  double span = 0.0;
+  double work = 0.0;
+  double cost = 0.0;
+  double longest = -1.0;
+  int critical = -1;
+
+  FOR_EACH_CHILD_SLOT (node, slot) {
+
+    const struct RollupValueType* child = &values[node->Children[slot]->Id];
+    work += child->Work;
+    cost += child->Cost;
+    span = parallel ? (child->Span > span ? child->Span : span) : span + child->Span;
+    if (child->Span > longest) {
+
+      longest = child->Span;
+      critical = node->Children[slot]->Id;
+    }
+  }
+
+  struct RollupValueType* value = &values[node->Id];
+  double duration = NumberAttribute (tree, node, ROLLUP_ATTR_DURATION);
+  value->Span = duration + span;
+  value->Work = duration + work;
+  value->Cost = NumberAttribute (tree, node, ROLLUP_ATTR_COST) + cost;
+  value->Critical = critical;
+}
+
+// 트리 전체를 후위 순서로 다시 계산한다 (지연 로딩 트리는 남은 노드를 모두 읽는다)
+bool Rollup_N_Tree (struct N_TreeType* tree) {
+
+  if (tree == NULL || tree->Head == NULL) return false;
+  if (tree->Rollup != NULL && tree->Rollup->Valid) return true;
+  if (tree->Pager != NULL && !LoadAll_N_Tree (tree)) return false;
+
+  if (tree->Rollup == NULL) {
+
+    tree->Rollup = (struct RollupIndexType*) calloc (1, sizeof (struct RollupIndexType));
+    if (tree->Rollup == NULL) {
+
+      printf ("Error! The dynamic memory allocation failed. Rollup_N_Tree()\n");
+      return false;
+    }
+  }
+  if (!EnsureRollupCapacity (tree->Rollup, tree->NextId) || !Renumber_N_Tree (tree)) {
+
+    printf ("Error! The dynamic memory allocation failed. Rollup_N_Tree()\n");
+    return false;
+  }
+
+  // 전위 순서의 역순이면 자식이 항상 부모보다 먼저 계산된다
+  for (int entry = tree->Euler->Size - 1; entry >= 0; entry--) {
+
+    Refresh (tree, tree->Rollup->Values, tree->Euler->Order[entry]);
+  }
+  tree->Rollup->Valid = true;
+  return true;
+}
+
+const struct RollupValueType* RollupOf_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node) {
+
+  if (node == NULL || !Rollup_N_Tree (tree)) return NULL;
+  return &tree->Rollup->Values[node->Id];
+}
+
+// node 에서 Span 이 가장 긴 자식을 따라 리프까지 내려간다 (합계를 이미 들고 있으므로 깊이에 비례).
+// 경로의 노드 수를 돌려주며 capacity 를 넘는 부분은 세기만 한다.
+int CriticalPath_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, struct TreeNodeType** path, int capacity) {
+
+  if (node == NULL || !Rollup_N_Tree (tree)) return 0;
+
+  int length = 0;
+  while (node != NULL) {
+
+    if (length < capacity) path[length] = node;
+    length++;
+    node = NodeById_N_Tree (tree, tree->Rollup->Values[node->Id].Critical);
+  }
+  return length;
+}
+
+bool IsRollupAttribute (const char* name) {
+
+  return strcmp (name, ROLLUP_ATTR_DURATION) == 0 || strcmp (name, ROLLUP_ATTR_COST) == 0 || strcmp (name, RUN_ATTR_MODE) == 0;
+}
+
+// 자식이 모두 맞다고 보고 node 만 다시 계산한다 (복사한 서브트리처럼 아래에서부터 채울 때)
+void RefreshRollup_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node) {
+
+  if (tree == NULL || node == NULL || tree->Rollup == NULL || !tree->Rollup->Valid) return;
+  if (!EnsureRollupCapacity (tree->Rollup, tree->NextId)) {
+
+    tree->Rollup->Valid = false;
+    return;
+  }
+  Refresh (tree, tree->Rollup->Values, node);
+}
+
+// node 의 값이나 자식이 바뀐 뒤 호출: node 부터 합계가 그대로인 조상이 나올 때까지 올라가며 다시 계산한다
+void UpdateRollup_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node) {
+
+  if (tree == NULL || node == NULL || tree->Rollup == NULL || !tree->Rollup->Valid) return;
+  if (!EnsureRollupCapacity (tree->Rollup, tree->NextId)) {
+
+    tree->Rollup->Valid = false;
+    return;
+  }
+
+  struct RollupValueType* values = tree->Rollup->Values;
+  for (struct TreeNodeType* current = node; current != NULL; current = current->Parent) {
+
+    struct RollupValueType before = values[current->Id];
+    Refresh (tree, values, current);
+
+    const struct RollupValueType* after = &values[current->Id];
+    if (current != node && before.Span == after->Span && before.Work == after->Work && before.Cost == after->Cost) return;
+  }
+}
+
+void Invalidate_Rollup (struct N_TreeType* tree) {
+
+  if (tree == NULL || tree->Rollup == NULL) return;
+  tree->Rollup->Valid = false;
+}
+
+void Delete_Rollup (struct N_TreeType* tree) {
+
+  if (tree == NULL || tree->Rollup == NULL) return;
+
+  free (tree->Rollup->Values);
+  free (tree->Rollup);
+  tree->Rollup = NULL;
+}
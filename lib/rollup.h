@@ -0,0 +1,36 @@
+#ifndef _ROLLUP_H_
+#define _ROLLUP_H_
+
+#include "n_tree.h"
+
+#define ROLLUP_ATTR_DURATION "duration"  // 노드 자신의 소요 시간 (int 또는 float, 없으면 0)
+#define ROLLUP_ATTR_COST "cost"          // 노드 자신의 비용 (int 또는 float, 없으면 0)
+
+// 서브트리 합계 (노드 번호로 색인)
+struct RollupValueType {
+
+  double Span;    // 완료까지 걸리는 시간: 자신 + (병렬 자식은 최댓값, 순차 자식은 합)
+  double Work;    // 총 작업량: 자신 + 모든 자식의 Work
+  double Cost;    // 총 비용: 자신 + 모든 자식의 Cost
+  int Critical;   // Span 이 가장 긴 자식의 노드 번호 (자식이 없으면 -1)
+};
+
+// 처음 질의할 때 후위 순서로 한 번 계산하고, 그 뒤에는 트리나 값이 바뀔 때마다 바뀐 노드부터
+// 값이 그대로인 조상이 나올 때까지만 다시 계산한다. 지연 로딩으로 노드가 들어오거나 나가면 Valid 를 내린다.
+struct RollupIndexType {
+
+  bool Valid;
+  struct RollupValueType* Values;
+  int Capacity;
+};
+
+bool Rollup_N_Tree (struct N_TreeType* tree);
+const struct RollupValueType* RollupOf_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node);
+int CriticalPath_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node, struct TreeNodeType** path, int capacity);
+bool IsRollupAttribute (const char* name);
+void RefreshRollup_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node);
+void UpdateRollup_N_Tree (struct N_TreeType* tree, struct TreeNodeType* node);
+void Invalidate_Rollup (struct N_TreeType* tree);
+void Delete_Rollup (struct N_TreeType* tree);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,478 @@
+#include "run.h"
+#include "attr.h"
+#include "deps.h"
+#include "metrics.h"
+#include "pager.h"
+#include "parallel.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+extern char** environ;
+
+// 실행에 포함된 노드 하나의 상태 (노드 번호로 색인)
+struct RunTaskType {
+
+  unsigned long long Start;
+  int Pending;     // 끝나기를 기다리는 자식 수
+  int Waiting;     // 끝나기를 기다리는 의존 대상 수 (이번 실행에 든 노드만)
+  bool Member;     // 이번 실행의 서브트리에 든 노드
+  bool Parallel;
+  bool Failed;     // 자식이 실패했다
+  bool Skipped;    // 자식이 건너뛰어졌다
+  bool Held;       // 자식은 끝났지만 의존 대상을 기다린다
+  bool Blocked;    // 의존 대상이 실패했거나 건너뛰어졌다 (명령을 실행하지 않음)
+};
+
+struct RunningType {
+
+  pid_t Pid;
+  struct TreeNodeType* Node;
+};
+
+struct RunStateType {
+
+  struct N_TreeType* Tree;
+  struct TreeNodeType* Root;
+  const struct RunOptionsType* Options;
+  struct RunResultType* Result;
+  struct RunTaskType* Tasks;
+  struct NodeListType Nodes;   // 서브트리의 모든 노드 (끝나고 남은 pending 을 건너뜀으로 바꿀 때)
+  struct NodeListType Ready;    // 자식이 모두 끝나 자기 명령만 남은 노드 (ReadyHead 부터 꺼냄)
+  long ReadyHead;
+  struct NodeListType Stack;   // Begin 의 작업 스택
+  struct RunningType* Running;
+  int RunningCount;
+  pid_t Group;                 // 실행 중인 명령의 프로세스 그룹 (0 이면 다음 명령이 새로 만든다)
+  int Jobs;
+};
+
+static const char* StatusNames[] = { "pending", "running", "ok", "failed", "skipped" };
+
+const char* RunStatusName (enum RunStatusType status) {
+
+  return status >= RUN_PENDING && status <= RUN_SKIPPED ? StatusNames[status] : "unknown";
+}
+
+// 문자열 속성 값 (없으면 NULL)
+static const char* TextAttribute (struct N_TreeType* tree, struct TreeNodeType* node, const char* name) {
+
+  struct AttributeColumnType* column = FindAttributeColumn (tree->Attributes, name);
+  if (column == NULL || column->Kind != ATTR_STRING || !HasAttributeValue (column, node->Id)) return NULL;
+  return Label_Text (tree->Labels, column->Values.Strings[node->Id]);
+}
+
+static const char* Command (struct RunStateType* run, struct TreeNodeType* node) {
+
+  const char* command = TextAttribute (run->Tree, node, RUN_ATTR_COMMAND);
+  if (command == NULL && run->Options->LabelCommands && IsLeaf_N_Tree (node)) command = Data_N_Tree (run->Tree, node);
+  return command != NULL && command[0] != '\0' ? command : NULL;
+}
+
+static void SetStatus (struct RunStateType* run, struct TreeNodeType* node, enum RunStatusType status) {
+
+  SetAttribute_N_Tree (run->Tree, node, RUN_ATTR_STATUS, ATTR_STRING, StatusNames[status]);
+  if (status == RUN_OK) run->Result->Ok++;
+  if (status == RUN_FAILED) run->Result->Failed++;
+  if (status == RUN_SKIPPED) run->Result->Skipped++;
+  if (run->Options->Progress != NULL) run->Options->Progress (run->Tree, node, status, run->Options->Context);
+}
+
+// 결과를 적는 속성이 다른 종류로 이미 쓰이고 있으면 실행하지 않는다
+static bool CheckColumn (struct N_TreeType* tree, const char* name, enum AttributeKindType kind) {
+
+  struct AttributeColumnType* column = FindAttributeColumn (tree->Attributes, name);
+  if (column == NULL || column->Kind == kind) return true;
+
+  printf ("Error! Attribute '%s' holds %s values, but run records %s. Run_N_Tree()\n", name, AttributeKindName (column->Kind), AttributeKindName (kind));
+  return false;
+}
+
+// 슬롯 after 다음으로 자식이 있는 슬롯 (없으면 -1)
+static int NextChildSlot (const struct TreeNodeType* node, int after) {
+
+  int slot = after + 1;
+  for (int word = slot >> 6; word < CHILD_WORDS (node->Capacity); word++) {
+
+    unsigned long long bits = Occupied_N_Tree (node)[word];
+    if (word == slot >> 6) bits &= ~0ULL << (slot & 63);
+    if (bits != 0) return word * 64 + __builtin_ctzll (bits);
+  }
+  return -1;
+}
+
+// 목록을 count 칸으로 미리 늘려 둔다 (실행 중에는 할당하지 않도록)
+static bool ReserveNodeList (struct NodeListType* list, long count) {
+
+  if (count <= list->Capacity) return true;
+
+  struct TreeNodeType** items = (struct TreeNodeType**) realloc (list->Items, (size_t) count * sizeof (struct TreeNodeType*));
+  if (items == NULL) return false;
+
+  list->Items = items;
+  list->Capacity = count;
+  return true;
+}
+
+// 자식이 모두 끝난 node 를 대기열에 넣는다 (아직 끝나지 않은 의존 대상이 있으면 그때까지 미룬다)
+static void Enqueue (struct RunStateType* run, struct TreeNodeType* node) {
+
+  struct RunTaskType* task = &run->Tasks[node->Id];
+  if (task->Waiting > 0) {
+
+    task->Held = true;
+    return;
+  }
+  AppendNodeList (&run->Ready, node);
+}
+
+// node 가 끝났음을 node 를 기다리는 노드에 알린다
+static void Release (struct RunStateType* run, struct TreeNodeType* node, enum RunStatusType status) {
+
+  int count;
+  const int* dependents = DependedBy_N_Tree (run->Tree, node, &count);
+  for (int index = 0; index < count; index++) {
+
+    struct RunTaskType* task = &run->Tasks[dependents[index]];
+    if (!task->Member) continue;
+
+    if (status != RUN_OK) task->Blocked = true;
+    if (--task->Waiting == 0 && task->Held) {
+
+      task->Held = false;
+      AppendNodeList (&run->Ready, run->Tree->Nodes[dependents[index]]);
+    }
+  }
+}
+
+// node 서브트리를 시작한다: 자식이 없으면 자기 명령을 대기열에 넣고, 있으면 정책대로 자식부터 시작한다
+static void Begin (struct RunStateType* run, struct TreeNodeType* node) {
+
+  run->Stack.Size = 0;
+  AppendNodeList (&run->Stack, node);
+
+  while (run->Stack.Size > 0) {
+
+    struct TreeNodeType* current = run->Stack.Items[--run->Stack.Size];
+    struct RunTaskType* task = &run->Tasks[current->Id];
+    const char* mode = TextAttribute (run->Tree, current, RUN_ATTR_MODE);
+
+    task->Start = Metric_Now ();
+    task->Parallel = mode != NULL && strcmp (mode, "parallel") == 0;
+    SetStatus (run, current, RUN_RUNNING);
+
+    int first = NextChildSlot (current, -1);
+    if (first == -1) {
+
+      Enqueue (run, current);
+    } else if (task->Parallel) {
+
+      // 작은 슬롯이 먼저 꺼내지도록 거꾸로 넣는다
+      FOR_EACH_CHILD_SLOT_REVERSE (current, slot) {
+
+        AppendNodeList (&run->Stack, current->Children[slot]);
+        task->Pending++;
+      }
+    } else {
+
+      AppendNodeList (&run->Stack, current->Children[first]);
+      task->Pending = 1;
+    }
+  }
+}
+
+// node 가 끝났다: 결과를 적고 부모에 알린다. 부모의 자식이 모두 끝나면 부모도 마무리하며 위로 올라간다.
+static void Finish (struct RunStateType* run, struct TreeNodeType* node, enum RunStatusType status) {
+
+  while (true) {
+
+    struct RunTaskType* task = &run->Tasks[node->Id];
+    char text[32];
+    snprintf (text, sizeof (text), "%.3f", (double) (Metric_Now () - task->Start) / 1e9);
+    SetAttribute_N_Tree (run->Tree, node, RUN_ATTR_ELAPSED, ATTR_FLOAT, text);
+    SetStatus (run, node, status);
+    Release (run, node, status);
+    if (node == run->Root) return;
+
+    struct TreeNodeType* parent = node->Parent;
+    struct RunTaskType* up = &run->Tasks[parent->Id];
+    up->Pending--;
+    if (status == RUN_FAILED) up->Failed = true;
+    if (status == RUN_SKIPPED) up->Skipped = true;
+
+    if (!up->Parallel && (status == RUN_OK || run->Options->KeepGoing)) {
+
+      int slot = NextChildSlot (parent, node->Slot);
+      if (slot != -1) {
+
+        up->Pending++;
+        Begin (run, parent->Children[slot]);
+        return;
+      }
+    }
+    if (up->Pending > 0) return;
+
+    // 자식이 모두 끝났다: 모두 성공했으면 부모 자신의 명령을 실행한다
+    if (!up->Failed && !up->Skipped) {
+
+      Enqueue (run, parent);
+      return;
+    }
+    status = up->Failed ? RUN_FAILED : RUN_SKIPPED;
+    node = parent;
+  }
+}
+
+// 조상 중 이미 실패한 노드가 있으면 (KeepGoing 이 아닐 때) 아직 시작하지 않은 명령을 건너뛴다
+static bool AncestorFailed (struct RunStateType* run, struct TreeNodeType* node) {
+
+  for (; node != run->Root; node = node->Parent) {
+
+    if (run->Tasks[node->Parent->Id].Failed) return true;
+  }
+  return false;
+}
+
+// 명령은 실행마다 따로 만든 프로세스 그룹에 넣어, 트리를 품은 프로그램의 다른 자식은 기다리지 않는다
+static pid_t Spawn (struct RunStateType* run, const char* command) {
+
+  posix_spawn_file_actions_t actions;
+  posix_spawnattr_t attributes;
+  if (posix_spawn_file_actions_init (&actions) != 0) return -1;
+  if (posix_spawnattr_init (&attributes) != 0) {
+
+    posix_spawn_file_actions_destroy (&actions);
+    return -1;
+  }
+  posix_spawnattr_setflags (&attributes, POSIX_SPAWN_SETPGROUP);
+  posix_spawnattr_setpgroup (&attributes, run->Group);
+
+  // 앞서 쓴 진행 상황이 명령의 출력보다 먼저 보이도록
+  fflush (stdout);
+
+  // 명령이 CLI 의 표준 입력을 읽어 가지 않도록 막는다
+  posix_spawn_file_actions_addopen (&actions, 0, "/dev/null", O_RDONLY, 0);
+  char* arguments[] = { "sh", "-c", (char*) command, NULL };
+  pid_t pid = -1;
+  if (posix_spawn (&pid, RUN_SHELL, &actions, &attributes, arguments, environ) != 0) pid = -1;
+  posix_spawn_file_actions_destroy (&actions);
+  posix_spawnattr_destroy (&attributes);
+  if (pid > 0 && run->Group == 0) run->Group = pid;
+  return pid;
+}
+
+// 대기열의 명령을 Jobs 개까지 띄운다 (명령이 없는 노드는 바로 끝낸다)
+static void StartReady (struct RunStateType* run) {
+
+  while (run->ReadyHead < run->Ready.Size && run->RunningCount < run->Jobs) {
+
+    struct TreeNodeType* node = run->Ready.Items[run->ReadyHead++];
+    if (run->Tasks[node->Id].Blocked || (!run->Options->KeepGoing && AncestorFailed (run, node))) {
+
+      Finish (run, node, RUN_SKIPPED);
+      continue;
+    }
+
+    const char* command = Command (run, node);
+    if (command == NULL) {
+
+      Finish (run, node, RUN_OK);
+      continue;
+    }
+
+    pid_t pid = Spawn (run, command);
+    if (pid < 0) {
+
+      printf ("Error! Cannot start '%s'. Run_N_Tree()\n", command);
+      SetAttribute_N_Tree (run->Tree, node, RUN_ATTR_EXIT, ATTR_INT, "-1");
+      Finish (run, node, RUN_FAILED);
+      continue;
+    }
+    run->Result->Commands++;
+    run->Running[run->RunningCount].Pid = pid;
+    run->Running[run->RunningCount].Node = node;
+    run->RunningCount++;
+  }
+}
+
+// 실행 중인 명령 하나가 끝나기를 기다린다
+static void WaitOne (struct RunStateType* run) {
+
+  int status = 0;
+  pid_t pid = waitpid (-run->Group, &status, 0);
+  if (pid < 0) {
+
+    if (errno == EINTR) return;
+    // 그룹에 기다릴 자식이 없다: 남은 명령은 결과를 알 수 없으므로 실패로 끝낸다
+    run->Group = 0;
+    while (run->RunningCount > 0) Finish (run, run->Running[--run->RunningCount].Node, RUN_FAILED);
+    return;
+  }
+
+  for (int index = 0; index < run->RunningCount; index++) {
+
+    if (run->Running[index].Pid != pid) continue;
+
+    struct TreeNodeType* node = run->Running[index].Node;
+    run->Running[index] = run->Running[--run->RunningCount];
+    // 모두 거두면 그룹도 사라지므로 다음 명령이 새 그룹을 만든다
+    if (run->RunningCount == 0) run->Group = 0;
+
+    int code = WIFEXITED (status) ? WEXITSTATUS (status) : 128 + (WIFSIGNALED (status) ? WTERMSIG (status) : 0);
+    char text[16];
+    snprintf (text, sizeof (text), "%d", code);
+    SetAttribute_N_Tree (run->Tree, node, RUN_ATTR_EXIT, ATTR_INT, text);
+    Finish (run, node, code == 0 ? RUN_OK : RUN_FAILED);
+    return;
+  }
+}
+
+// root 서브트리를 실행한다. 명령은 최대 Jobs 개가 동시에 돌고, 노드 상태와 시간은 속성으로 바로 기록된다.
+// 한 번도 시작하지 못한 노드는 skipped 가 된다. 모든 노드가 성공하면 true.
+bool Run_N_Tree (struct N_TreeType* tree, struct TreeNodeType* root, const struct RunOptionsType* options, struct RunResultType* result) {
+
+  if (tree == NULL || tree->Head == NULL || options == NULL || result == NULL) {
+
+    printf ("Error! Invalid arguments. Run_N_Tree()\n");
+    return false;
+  }
+  if (root == NULL) root = tree->Head;
+  memset (result, 0, sizeof (struct RunResultType));
+
+  if (!CheckColumn (tree, RUN_ATTR_STATUS, ATTR_STRING) || !CheckColumn (tree, RUN_ATTR_EXIT, ATTR_INT) ||
+      !CheckColumn (tree, RUN_ATTR_ELAPSED, ATTR_FLOAT)) return false;
+
+  struct RunStateType run;
+  memset (&run, 0, sizeof (run));
+  run.Tree = tree;
+  run.Root = root;
+  run.Options = options;
+  run.Result = result;
+  run.Jobs = options->Jobs > 0 ? options->Jobs : ParallelThreadCount ();
+  if (run.Jobs > RUN_MAX_JOBS) run.Jobs = RUN_MAX_JOBS;
+
+  // 서브트리를 모두 읽어 pending 으로 표시한다 (지연 로딩 트리는 여기서 읽는다)
+  bool loaded = AppendNodeList (&run.Nodes, root);
+  for (long index = 0; loaded && index < run.Nodes.Size; index++) {
+
+    struct TreeNodeType* node = run.Nodes.Items[index];
+    if (node->Paged && !Fault_N_Tree (tree, node)) loaded = false;
+    FOR_EACH_CHILD_SLOT (node, slot) {
+
+      if (loaded) loaded = AppendNodeList (&run.Nodes, node->Children[slot]);
+    }
+  }
+
+  // 노드마다 대기열과 스택에 한 번씩만 들어가므로 미리 잡아 두면 실행 중에는 할당이 실패하지 않는다
+  long count = run.Nodes.Size;
+  run.Tasks = (struct RunTaskType*) calloc ((size_t) tree->NextId, sizeof (struct RunTaskType));
+  run.Running = (struct RunningType*) calloc ((size_t) run.Jobs, sizeof (struct RunningType));
+  if (!loaded || run.Tasks == NULL || run.Running == NULL || !ReserveNodeList (&run.Ready, count) || !ReserveNodeList (&run.Stack, count)) {
+
+    printf ("Error! The dynamic memory allocation failed. Run_N_Tree()\n");
+    FreeNodeList (&run.Nodes);
+    FreeNodeList (&run.Ready);
+    FreeNodeList (&run.Stack);
+    free (run.Tasks);
+    free (run.Running);
+    return false;
+  }
+
+  for (long index = 0; index < count; index++) run.Tasks[run.Nodes.Items[index]->Id].Member = true;
+
+  // 서브트리 밖의 의존 대상은 이미 ok 여야 하고, 안의 것은 끝날 때까지 기다린다
+  for (long index = 0; index < count; index++) {
+
+    struct TreeNodeType* node = run.Nodes.Items[index];
+    struct RunTaskType* task = &run.Tasks[node->Id];
+    int dependencies;
+    const int* on = DependsOn_N_Tree (tree, node, &dependencies);
+    for (int edge = 0; edge < dependencies; edge++) {
+
+      if (run.Tasks[on[edge]].Member) {
+
+        task->Waiting++;
+        continue;
+      }
+      const char* status = TextAttribute (tree, tree->Nodes[on[edge]], RUN_ATTR_STATUS);
+      if (status == NULL || strcmp (status, StatusNames[RUN_OK]) != 0) task->Blocked = true;
+    }
+  }
+
+  for (long index = 0; index < count; index++) {
+
+    struct TreeNodeType* node = run.Nodes.Items[index];
+    SetAttribute_N_Tree (tree, node, RUN_ATTR_STATUS, ATTR_STRING, StatusNames[RUN_PENDING]);
+    UnsetAttribute_N_Tree (tree, node, RUN_ATTR_EXIT);
+    UnsetAttribute_N_Tree (tree, node, RUN_ATTR_ELAPSED);
+  }
+
+  unsigned long long start = Metric_Now ();
+  Begin (&run, root);
+  while (run.ReadyHead < run.Ready.Size || run.RunningCount > 0) {
+
+    StartReady (&run);
+    if (run.RunningCount > 0) WaitOne (&run);
+  }
+
+  // 실패 때문에 시작하지 못한 노드와, 순차 형제 순서와 의존 간선이 엇갈려 끝까지 기다리던 노드
+  for (long index = 0; index < count; index++) {
+
+    struct TreeNodeType* node = run.Nodes.Items[index];
+    const char* status = TextAttribute (tree, node, RUN_ATTR_STATUS);
+    if (status != NULL && (strcmp (status, StatusNames[RUN_PENDING]) == 0 || strcmp (status, StatusNames[RUN_RUNNING]) == 0)) {
+
+      SetStatus (&run, node, RUN_SKIPPED);
+    }
+  }
+  result->Elapsed = (double) (Metric_Now () - start) / 1e9;
+
+  FreeNodeList (&run.Nodes);
+  FreeNodeList (&run.Ready);
+  FreeNodeList (&run.Stack);
+  free (run.Tasks);
+  free (run.Running);
+  return result->Failed == 0 && result->Skipped == 0;
+}
+
+static bool HasStatus (struct N_TreeType* tree, struct TreeNodeType* node, enum RunStatusType status) {
+
+  const char* text = TextAttribute (tree, node, RUN_ATTR_STATUS);
+  return text != NULL && strcmp (text, StatusNames[status]) == 0;
+}
+
+// root 서브트리에서 지금 시작할 수 있는 노드를 위상 순서로 ready 에 덧붙인다.
+// 아직 ok 도 running 도 아니고, 자식과 기다리는 노드가 모두 ok 인 노드다 (메모리에 있는 노드만 본다).
+bool ReadyTasks_N_Tree (struct N_TreeType* tree, struct TreeNodeType* root, struct NodeListType* ready) {
+
+  if (tree == NULL || ready == NULL) return false;
+
+  struct NodeListType order = { NULL, 0, 0 };
+  if (!TopologicalOrder_N_Tree (tree, root, &order)) return false;
+
+  bool ok = true;
+  for (long index = 0; ok && index < order.Size; index++) {
+
+    struct TreeNodeType* node = order.Items[index];
+    if (HasStatus (tree, node, RUN_OK) || HasStatus (tree, node, RUN_RUNNING)) continue;
+
+    bool startable = true;
+    FOR_EACH_CHILD_SLOT (node, slot) {
+
+      if (startable) startable = HasStatus (tree, node->Children[slot], RUN_OK);
+    }
+
+    int count;
+    const int* on = DependsOn_N_Tree (tree, node, &count);
+    for (int edge = 0; startable && edge < count; edge++) startable = HasStatus (tree, tree->Nodes[on[edge]], RUN_OK);
+
+    if (startable) ok = AppendNodeList (ready, node);
+  }
+  FreeNodeList (&order);
+  return ok;
+}
@@ -0,0 +1,46 @@
+#ifndef _RUN_H_
+#define _RUN_H_
+
+#include "n_tree.h"
+
+#define RUN_MAX_JOBS 256
+#define RUN_SHELL "/bin/sh"
+
+// 노드 속성으로 읽고 쓰는 이름
+#define RUN_ATTR_COMMAND "cmd"       // 노드가 실행할 명령 (string, 없으면 자식만 실행하는 묶음)
+#define RUN_ATTR_MODE "mode"         // "parallel" 이면 자식을 동시에, 그 밖에는 슬롯 순서로 하나씩
+#define RUN_ATTR_STATUS "status"     // pending / running / ok / failed / skipped
+#define RUN_ATTR_EXIT "exit"         // 명령의 종료 코드 (시그널로 끝나면 128 + 번호)
+#define RUN_ATTR_ELAPSED "elapsed"   // 노드를 시작해서 끝낼 때까지의 초 (자식 실행 시간 포함)
+
+// 노드를 작업으로 보고 서브트리를 실행한다.
+// 자식이 모두 성공해야 노드의 명령을 실행하고, 실패는 조상으로 올라간다.
+// 의존 간선(deps.h)이 있으면 기다리는 노드가 성공할 때까지 명령을 미루고, 실패하면 건너뛴다.
+enum RunStatusType { RUN_PENDING, RUN_RUNNING, RUN_OK, RUN_FAILED, RUN_SKIPPED };
+
+// 노드 상태가 바뀔 때마다 호출 (실행 스레드에서, 속성을 적은 뒤)
+typedef void (*RunProgressFunc) (struct N_TreeType* tree, struct TreeNodeType* node, enum RunStatusType status, void* context);
+
+struct RunOptionsType {
+
+  int Jobs;             // 동시에 실행할 명령 수 (0 이면 ParallelThreadCount)
+  bool KeepGoing;       // 실패해도 아직 시작하지 않은 형제를 계속 실행
+  bool LabelCommands;   // cmd 가 없는 리프는 레이블을 명령으로 실행
+  RunProgressFunc Progress;
+  void* Context;        // Progress 에 그대로 전달
+};
+
+struct RunResultType {
+
+  long Ok;
+  long Failed;
+  long Skipped;
+  long Commands;    // 실제로 실행한 명령 수
+  double Elapsed;   // 전체 실행 시간 (초)
+};
+
+const char* RunStatusName (enum RunStatusType status);
+bool Run_N_Tree (struct N_TreeType* tree, struct TreeNodeType* root, const struct RunOptionsType* options, struct RunResultType* result);
+bool ReadyTasks_N_Tree (struct N_TreeType* tree, struct TreeNodeType* root, struct NodeListType* ready);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,733 @@
+#include "snapshot.h"
+#include "attr.h"
+#include "deps.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SNAPSHOT_MAGIC "WTSN"
+#define SNAPSHOT_VERSION 4
+#define SNAPSHOT_HEADER_SIZE 8
+#define RECORD_NODE 'N'
+#define RECORD_ROOT 'R'
+#define RECORD_DEPENDENCIES 'D'
+#define RECORD_ATTRIBUTES 'A'
+
+// 파일 형식 (리틀 엔디언)
+//   "WTSN" u32 version
+//   'N' u64 hash, u32 size, u32 labelLength, label, u16 children, children x { u16 slot, u64 hash }
+//   'D' u64 digest, u32 edges, edges x { u16 depth, depth x u16 slot (기다리는 노드), u16 depth, depth x u16 slot (기다리는 대상) }
+//   'A' u64 digest, u32 columns, columns x { u8 nameLength, name, u8 kind, u32 count, count x { u16 depth, depth x u16 slot, value } }
+//   'R' u64 rootHash, u32 childSize, u32 count
+// size 는 서브트리 노드 수라서 아직 읽지 않은 서브트리도 크기를 알 수 있다. value 는 속성 이진 형식과 같다.
+// 'D' 와 'A' 는 바뀌었을 때만 'R' 바로 앞에 쓰며, 다음 'D'/'A' 가 나올 때까지 뒤의 모든 루트에 적용된다.
+// (버전 3 파일의 'D' 는 바로 다음 루트에만 적용되고, 버전 2 파일에는 둘 다 없다.)
+static void WriteU16 (FILE* fp, unsigned int value) {
+
+  unsigned char bytes[2] = { value & 0xFF, (value >> 8) & 0xFF };
+  fwrite (bytes, 1, 2, fp);
+}
+
+static void WriteU32 (FILE* fp, unsigned int value) {
+
+  unsigned char bytes[4] = { value & 0xFF, (value >> 8) & 0xFF, (value >> 16) & 0xFF, (value >> 24) & 0xFF };
+  fwrite (bytes, 1, 4, fp);
+}
+
+static void WriteU64 (FILE* fp, unsigned long long value) {
+
+  WriteU32 (fp, (unsigned int) (value & 0xFFFFFFFFu));
+  WriteU32 (fp, (unsigned int) (value >> 32));
+}
+
+static bool ReadU16 (FILE* fp, unsigned int* value) {
+
+  unsigned char bytes[2];
+  if (fread (bytes, 1, 2, fp) != 2) return false;
+  *value = bytes[0] | (bytes[1] << 8);
+  return true;
+}
+
+static bool ReadU32 (FILE* fp, unsigned int* value) {
+
+  unsigned char bytes[4];
+  if (fread (bytes, 1, 4, fp) != 4) return false;
+  *value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((unsigned int) bytes[3] << 24);
+  return true;
+}
+
+static bool ReadU64 (FILE* fp, unsigned long long* value) {
+
+  unsigned int low, high;
+  if (!ReadU32 (fp, &low) || !ReadU32 (fp, &high)) return false;
+  *value = ((unsigned long long) high << 32) | low;
+  return true;
+}
+
+static long FindSlot (struct SnapshotType* snapshot, unsigned long long hash) {
+
+  if (hash == 0 || snapshot->Capacity == 0) return -1;
+
+  long mask = snapshot->Capacity - 1;
+  for (long slot = (long) (hash & mask); snapshot->Keys[slot] != 0; slot = (slot + 1) & mask) {
+
+    if (snapshot->Keys[slot] == hash) return slot;
+  }
+  return -1;
+}
+
+static bool AddChunk (struct SnapshotType* snapshot, unsigned long long hash, long offset, int size) {
+
+  if (hash == 0) return true;
+
+  // 채움률 1/2 를 넘으면 두 배로 키운다
+  if ((snapshot->Count + 1) * 2 > snapshot->Capacity) {
+
+    long capacity = snapshot->Capacity == 0 ? 1024 : snapshot->Capacity * 2;
+    unsigned long long* keys = (unsigned long long*) calloc (capacity, sizeof (unsigned long long));
+    long* offsets = (long*) malloc (capacity * sizeof (long));
+    int* sizes = (int*) malloc (capacity * sizeof (int));
+    if (keys == NULL || offsets == NULL || sizes == NULL) {
+
+      free (keys);
+      free (offsets);
+      free (sizes);
+      return false;
+    }
+
+    for (long index = 0; index < snapshot->Capacity; index++) {
+
+      if (snapshot->Keys[index] == 0) continue;
+
+      long slot = (long) (snapshot->Keys[index] & (capacity - 1));
+      while (keys[slot] != 0) slot = (slot + 1) & (capacity - 1);
+      keys[slot] = snapshot->Keys[index];
+      offsets[slot] = snapshot->Offsets[index];
+      sizes[slot] = snapshot->Sizes[index];
+    }
+    free (snapshot->Keys);
+    free (snapshot->Offsets);
+    free (snapshot->Sizes);
+    snapshot->Keys = keys;
+    snapshot->Offsets = offsets;
+    snapshot->Sizes = sizes;
+    snapshot->Capacity = capacity;
+  }
+
+  long mask = snapshot->Capacity - 1;
+  long slot = (long) (hash & mask);
+  while (snapshot->Keys[slot] != 0) {
+
+    if (snapshot->Keys[slot] == hash) return true;
+    slot = (slot + 1) & mask;
+  }
+  snapshot->Keys[slot] = hash;
+  snapshot->Offsets[slot] = offset;
+  snapshot->Sizes[slot] = size;
+  snapshot->Count++;
+  return true;
+}
+
+// 조각 머리만 훑어 해시 색인과 마지막 루트를 만든다. 중간에 끊긴 마지막 기록은 무시한다.
+static bool ScanSnapshot (struct SnapshotType* snapshot, FILE* fp, long end) {
+
+  char magic[4];
+  unsigned int version;
+  if (fread (magic, 1, 4, fp) != 4 || memcmp (magic, SNAPSHOT_MAGIC, 4) != 0 || !ReadU32 (fp, &version) || version < 2 || version > SNAPSHOT_VERSION) {
+
+    printf ("Error! %s is not a snapshot file. Open_Snapshot()\n", snapshot->Path);
+    return false;
+  }
+  snapshot->Size = SNAPSHOT_HEADER_SIZE;
+  snapshot->Version = (int) version;
+
+  long dependencies = 0, attributes = 0;
+  unsigned long long digest = 0, attributeDigest = 0;
+  int type;
+  while ((type = fgetc (fp)) != EOF) {
+
+    long offset = ftell (fp) - 1;
+    unsigned long long hash;
+
+    if (type == RECORD_NODE) {
+
+      unsigned int size, length, children;
+      if (!ReadU64 (fp, &hash) || !ReadU32 (fp, &size) || !ReadU32 (fp, &length) || fseek (fp, length, SEEK_CUR) != 0 ||
+          !ReadU16 (fp, &children)) break;
+      // fseek 은 파일 끝을 넘어도 성공하므로 크기로 한 번 더 확인한다
+      if (fseek (fp, (long) children * 10, SEEK_CUR) != 0 || ftell (fp) > end) break;
+      if (!AddChunk (snapshot, hash, offset, (int) size)) return false;
+    } else if (type == RECORD_ROOT) {
+
+      unsigned int childSize, count;
+      if (!ReadU64 (fp, &hash) || !ReadU32 (fp, &childSize) || !ReadU32 (fp, &count)) break;
+
+      snapshot->HasRoot = true;
+      snapshot->Root = hash;
+      snapshot->RootChildSize = (int) childSize;
+      snapshot->RootCount = (int) count;
+      snapshot->Dependencies = dependencies;
+      snapshot->DependencyDigest = digest;
+      snapshot->Attributes = attributes;
+      snapshot->AttributeDigest = attributeDigest;
+      if (version < 4) {
+
+        dependencies = 0;
+        digest = 0;
+      }
+    } else if (type == RECORD_DEPENDENCIES) {
+
+      unsigned int edges, depth;
+      if (!ReadU64 (fp, &hash) || !ReadU32 (fp, &edges)) break;
+
+      // fseek 은 파일 끝을 넘어도 성공하므로 크기로 한 번 더 확인한다
+      bool whole = true;
+      for (unsigned long path = 0; whole && path < 2 * (unsigned long) edges; path++) {
+
+        whole = ReadU16 (fp, &depth) && fseek (fp, (long) depth * 2, SEEK_CUR) == 0 && ftell (fp) <= end;
+      }
+      if (!whole) break;
+      dependencies = offset;
+      digest = hash;
+      // 뒤따르는 루트 기록이 없으면 끊긴 저장이므로 크기에 넣지 않는다
+      continue;
+    } else if (type == RECORD_ATTRIBUTES) {
+
+      unsigned int columns;
+      if (!ReadU64 (fp, &hash) || !ReadU32 (fp, &columns)) break;
+
+      bool whole = true;
+      for (unsigned int column = 0; whole && column < columns; column++) {
+
+        int nameLength = fgetc (fp);
+        int kind = nameLength == EOF ? EOF : (fseek (fp, nameLength, SEEK_CUR) == 0 ? fgetc (fp) : EOF);
+        unsigned int count, depth, length;
+        whole = kind != EOF && ReadU32 (fp, &count);
+        for (unsigned int item = 0; whole && item < count; item++) {
+
+          whole = ReadU16 (fp, &depth) && fseek (fp, (long) depth * 2, SEEK_CUR) == 0;
+          if (whole && kind == ATTR_STRING) whole = ReadU32 (fp, &length) && fseek (fp, length, SEEK_CUR) == 0;
+          else if (whole) whole = fseek (fp, 8, SEEK_CUR) == 0;
+          whole = whole && ftell (fp) <= end;
+        }
+      }
+      if (!whole) break;
+      attributes = offset;
+      attributeDigest = hash;
+      continue;
+    } else {
+
+      break;
+    }
+    snapshot->Size = ftell (fp);
+  }
+  return true;
+}
+
+struct SnapshotType* Open_Snapshot (const char* path) {
+
+  if (path == NULL || strlen (path) >= SNAPSHOT_PATH_SIZE) {
+
+    printf ("Error! Invalid snapshot path. Open_Snapshot()\n");
+    return NULL;
+  }
+
+  struct SnapshotType* snapshot = (struct SnapshotType*) calloc (1, sizeof (struct SnapshotType));
+  if (snapshot == NULL) {
+
+    printf ("Error! The dynamic memory allocation failed. Open_Snapshot()\n");
+    return NULL;
+  }
+  strcpy (snapshot->Path, path);
+
+  FILE* fp = fopen (path, "rb");
+  if (fp == NULL) return snapshot;  // 아직 없는 파일은 첫 저장 때 만든다
+
+  long end = 0;
+  if (fseek (fp, 0, SEEK_END) == 0) end = ftell (fp);
+  rewind (fp);
+
+  bool ok = end == 0 || ScanSnapshot (snapshot, fp, end);
+  fclose (fp);
+
+  if (!ok) {
+
+    Close_Snapshot (snapshot);
+    return NULL;
+  }
+  return snapshot;
+}
+
+// 서브트리 노드 수 (파일에 없는 해시면 -1)
+int ChunkSize_Snapshot (struct SnapshotType* snapshot, unsigned long long hash) {
+
+  long slot = snapshot == NULL ? -1 : FindSlot (snapshot, hash);
+  return slot < 0 ? -1 : snapshot->Sizes[slot];
+}
+
+// 파일에 없는 서브트리만 후위 순서로 쓰고 서브트리 크기를 돌려준다 (실패하면 -1)
+static long WriteSubtree (struct SnapshotType* snapshot, FILE* fp, struct N_TreeType* tree, struct TreeNodeType* node, long* written) {
+
+  int stored = ChunkSize_Snapshot (snapshot, node->Hash);
+  if (stored >= 0) return stored;  // 같은 서브트리가 이미 파일에 있음
+  if (node->Paged) return -1;      // 읽지 않은 서브트리는 반드시 파일에 있어야 한다
+
+  long size = 1;
+  unsigned int children = 0;
+  FOR_EACH_CHILD_SLOT (node, slot) {
+
+    long childSize = WriteSubtree (snapshot, fp, tree, node->Children[slot], written);
+    if (childSize < 0) return -1;
+    size += childSize;
+    children++;
+  }
+
+  const char* text = Data_N_Tree (tree, node);
+  unsigned int length = strlen (text);
+  long offset = ftell (fp);
+
+  fputc (RECORD_NODE, fp);
+  WriteU64 (fp, node->Hash);
+  WriteU32 (fp, (unsigned int) size);
+  WriteU32 (fp, length);
+  fwrite (text, 1, length, fp);
+  WriteU16 (fp, children);
+
+  FOR_EACH_CHILD_SLOT (node, slot) {
+
+    WriteU16 (fp, slot);
+    WriteU64 (fp, node->Children[slot]->Hash);
+  }
+
+  if (!AddChunk (snapshot, node->Hash, offset, (int) size)) return -1;
+  (*written)++;
+  return size;
+}
+
+// 간선마다 두 끝의 슬롯 경로를 쓴다 (노드 번호는 다시 읽으면 바뀌므로)
+static bool WritePath (FILE* fp, struct TreeNodeType* node, int** slots, int* capacity) {
+
+  int depth = SlotPath_N_Tree (node, *slots, *capacity);
+  if (depth > *capacity) {
+
+    if (depth > 65535) return false;
+    int* grown = (int*) realloc (*slots, (size_t) depth * sizeof (int));
+    if (grown == NULL) return false;
+    *slots = grown;
+    *capacity = depth;
+    SlotPath_N_Tree (node, *slots, *capacity);
+  }
+
+  WriteU16 (fp, (unsigned int) depth);
+  for (int level = 0; level < depth; level++) WriteU16 (fp, (unsigned int) (*slots)[level]);
+  return true;
+}
+
+static bool WriteDependencies (FILE* fp, struct N_TreeType* tree, unsigned long long digest) {
+
+  struct DependencyIndexType* index = tree->Dependencies;
+  int capacity = 64;
+  int* slots = (int*) malloc ((size_t) capacity * sizeof (int));
+  if (slots == NULL) return false;
+
+  // 간선이 하나도 없던 트리는 빈 기록을 쓴다
+  fputc (RECORD_DEPENDENCIES, fp);
+  WriteU64 (fp, digest);
+  WriteU32 (fp, index != NULL ? (unsigned int) index->EdgeCount : 0);
+
+  bool ok = true;
+  for (int at = 0; ok && index != NULL && at < index->ListCount; at++) {
+
+    const struct DependencyListType* list = &index->Lists[at];
+    for (int edge = 0; ok && edge < list->OnCount; edge++) {
+
+      ok = WritePath (fp, tree->Nodes[list->Id], &slots, &capacity) && WritePath (fp, tree->Nodes[list->Ids[edge]], &slots, &capacity);
+    }
+  }
+  free (slots);
+  return ok;
+}
+
+static bool WriteAttributes (FILE* fp, struct N_TreeType* tree, unsigned long long digest) {
+
+  struct AttributeTableType* table = tree->Attributes;
+  int columns = 0;
+  for (int index = 0; table != NULL && index < table->Count; index++) {
+
+    if (table->Columns[index].Size > 0) columns++;
+  }
+
+  int capacity = 64;
+  int* slots = (int*) malloc ((size_t) capacity * sizeof (int));
+  if (slots == NULL) return false;
+
+  fputc (RECORD_ATTRIBUTES, fp);
+  WriteU64 (fp, digest);
+  WriteU32 (fp, (unsigned int) columns);
+
+  bool ok = true;
+  for (int index = 0; ok && table != NULL && index < table->Count; index++) {
+
+    struct AttributeColumnType* column = &table->Columns[index];
+    if (column->Size == 0) continue;
+
+    unsigned char nameLength = (unsigned char) strlen (column->Name);
+    fputc (nameLength, fp);
+    fwrite (column->Name, 1, nameLength, fp);
+    fputc ((int) column->Kind, fp);
+    WriteU32 (fp, (unsigned int) column->Size);
+
+    for (int id = 0; ok && id < column->Capacity; id++) {
+
+      if (!HasAttributeValue (column, id)) continue;
+
+      struct TreeNodeType* node = NodeById_N_Tree (tree, id);
+      ok = node != NULL && WritePath (fp, node, &slots, &capacity);
+      if (ok) WriteAttributeValue (tree, column, id, fp);
+    }
+  }
+  free (slots);
+  return ok;
+}
+
+// 파일에 없는 서브트리만 조각으로 덧붙이고 마지막에 루트 기록을 쓴다 (의존 간선이나 속성이 바뀌었으면 그 앞에 새 기록). 쓴 조각 수를 돌려준다.
+long Write_Snapshot (struct SnapshotType* snapshot, struct N_TreeType* tree) {
+
+  if (snapshot == NULL || tree == NULL || tree->Head == NULL) {
+
+    printf ("Error! Invalid arguments. Write_Snapshot()\n");
+    return -1;
+  }
+  // 떼어 낸 노드의 속성과 간선이 기록에 섞이지 않게 먼저 해제한다
+  Reclaim_N_Tree (tree, 0);
+
+  FILE* fp = fopen (snapshot->Path, snapshot->Size == 0 ? "wb" : "r+b");
+  if (fp == NULL) {
+
+    printf ("Error! Failed to open %s. Write_Snapshot()\n", snapshot->Path);
+    return -1;
+  }
+
+  // 중간에 끊긴 기록이 있었다면 그 자리부터 덮어쓴다
+  if (snapshot->Size == 0) {
+
+    fwrite (SNAPSHOT_MAGIC, 1, 4, fp);
+    WriteU32 (fp, SNAPSHOT_VERSION);
+    snapshot->Size = SNAPSHOT_HEADER_SIZE;
+  }
+  // 예전 버전 파일에 덧붙이면 머리의 버전을 올리고, 간선과 속성 기록을 새 규칙으로 한 번 다시 쓴다
+  bool refresh = snapshot->Version < SNAPSHOT_VERSION;
+  fseek (fp, 4, SEEK_SET);
+  WriteU32 (fp, SNAPSHOT_VERSION);
+  fseek (fp, snapshot->Size, SEEK_SET);
+
+  // 자식 조각을 먼저 써야 부모 조각에 서브트리 크기를 적을 수 있다
+  long written = 0;
+  long count = WriteSubtree (snapshot, fp, tree, tree->Head, &written);
+  bool ok = count >= 0;
+
+  unsigned long long digest = DependencyDigest_N_Tree (tree);
+  long dependencies = snapshot->Dependencies;
+  if (ok && (refresh || digest != snapshot->DependencyDigest)) {
+
+    dependencies = ftell (fp);
+    ok = WriteDependencies (fp, tree, digest);
+  }
+
+  unsigned long long attributeDigest = AttributeDigest_N_Tree (tree);
+  long attributes = snapshot->Attributes;
+  if (ok && (refresh || attributeDigest != snapshot->AttributeDigest)) {
+
+    attributes = ftell (fp);
+    ok = WriteAttributes (fp, tree, attributeDigest);
+  }
+
+  if (ok) {
+
+    fputc (RECORD_ROOT, fp);
+    WriteU64 (fp, tree->Head->Hash);
+    WriteU32 (fp, tree->ChildSize);
+    WriteU32 (fp, (unsigned int) count);
+    ok = fflush (fp) == 0 && ferror (fp) == 0;
+  }
+  if (ok) {
+
+    snapshot->Size = ftell (fp);
+    snapshot->HasRoot = true;
+    snapshot->Root = tree->Head->Hash;
+    snapshot->RootChildSize = tree->ChildSize;
+    snapshot->RootCount = (int) count;
+    snapshot->Dependencies = dependencies;
+    snapshot->DependencyDigest = digest;
+    snapshot->Attributes = attributes;
+    snapshot->AttributeDigest = attributeDigest;
+    snapshot->Version = SNAPSHOT_VERSION;
+  } else {
+
+    printf ("Error! Failed to write %s. Write_Snapshot()\n", snapshot->Path);
+  }
+
+  fclose (fp);
+  return ok ? written : -1;
+}
+
+// 파일을 다시 읽지 않고 루트 해시와 간선, 속성 요약 값만 비교한다
+bool Matches_Snapshot (struct SnapshotType* snapshot, struct N_TreeType* tree) {
+
+  if (snapshot == NULL || tree == NULL || tree->Head == NULL || !snapshot->HasRoot) return false;
+  return snapshot->Root == tree->Head->Hash && snapshot->RootChildSize == tree->ChildSize &&
+         snapshot->DependencyDigest == DependencyDigest_N_Tree (tree) && snapshot->AttributeDigest == AttributeDigest_N_Tree (tree);
+}
+
+// hash 조각을 chunk 로 읽는다 (fp 는 스냅숏 파일)
+bool ReadChunk_Snapshot (struct SnapshotType* snapshot, FILE* fp, unsigned long long hash, struct SnapshotChunkType* chunk) {
+
+  long slot = snapshot == NULL ? -1 : FindSlot (snapshot, hash);
+  unsigned long long stored;
+  unsigned int size, length, children;
+
+  if (slot < 0 || fseek (fp, snapshot->Offsets[slot] + 1, SEEK_SET) != 0 || !ReadU64 (fp, &stored) || stored != hash ||
+      !ReadU32 (fp, &size) || !ReadU32 (fp, &length) || length > LABEL_MAX_LENGTH || fread (chunk->Text, 1, length, fp) != length ||
+      !ReadU16 (fp, &children) || children > CHILD_SIZE_MAX) return false;
+
+  if ((int) children > chunk->ChildCapacity) {
+
+    int capacity = chunk->ChildCapacity > 0 ? chunk->ChildCapacity : CHILD_SIZE;
+    while (capacity < (int) children) capacity *= 2;
+
+    int* slots = (int*) realloc (chunk->Slots, (size_t) capacity * sizeof (int));
+    if (slots == NULL) return false;
+    chunk->Slots = slots;
+    unsigned long long* hashes = (unsigned long long*) realloc (chunk->Hashes, (size_t) capacity * sizeof (unsigned long long));
+    if (hashes == NULL) return false;
+    chunk->Hashes = hashes;
+    chunk->ChildCapacity = capacity;
+  }
+
+  chunk->Hash = hash;
+  chunk->Size = (int) size;
+  chunk->Text[length] = '\0';
+  chunk->ChildCount = (int) children;
+
+  for (int index = 0; index < chunk->ChildCount; index++) {
+
+    unsigned int childSlot;
+    if (!ReadU16 (fp, &childSlot) || childSlot >= CHILD_SIZE_MAX || !ReadU64 (fp, &chunk->Hashes[index])) return false;
+    chunk->Slots[index] = (int) childSlot;
+  }
+  return true;
+}
+
+// 자식 목록만 해제한다 (chunk 자체는 호출한 쪽 것)
+void FreeChunk_Snapshot (struct SnapshotChunkType* chunk) {
+
+  if (chunk == NULL) return;
+
+  free (chunk->Slots);
+  free (chunk->Hashes);
+  chunk->Slots = NULL;
+  chunk->Hashes = NULL;
+  chunk->ChildCapacity = 0;
+}
+
+// node->Hash 의 조각으로 레이블과 자식을 채운다. 해시는 마지막에 한 번에 다시 계산한다.
+static bool ReadSubtree (struct SnapshotType* snapshot, FILE* fp, struct N_TreeType* tree, struct TreeNodeType* node) {
+
+  struct SnapshotChunkType* chunk = (struct SnapshotChunkType*) calloc (1, sizeof (struct SnapshotChunkType));
+  bool ok = chunk != NULL && ReadChunk_Snapshot (snapshot, fp, node->Hash, chunk);
+
+  if (ok) {
+
+    node->Label = Intern_Label (tree->Labels, chunk->Text);
+    ok = node->Label != LABEL_NONE;
+  }
+
+  for (int index = 0; ok && index < chunk->ChildCount; index++) {
+
+    int slot = chunk->Slots[index];
+    ok = slot < tree->ChildSize && ChildAt_N_Tree (node, slot) == NULL;
+
+    struct TreeNodeType* child = ok ? MakeTreeNode (tree, node, "") : NULL;
+    ok = child != NULL && SetChild_N_Tree (node, slot, child);
+    if (child != NULL && !ok) FreeTreeNode (tree, child);
+    if (ok) {
+
+      child->Hash = chunk->Hashes[index];
+      tree->Count++;
+      ok = ReadSubtree (snapshot, fp, tree, child);
+    }
+  }
+
+  FreeChunk_Snapshot (chunk);
+  free (chunk);
+  return ok;
+}
+
+struct N_TreeType* Read_Snapshot (struct SnapshotType* snapshot) {
+
+  if (snapshot == NULL || !snapshot->HasRoot) {
+
+    printf ("Error! Snapshot has no saved tree. Read_Snapshot()\n");
+    return NULL;
+  }
+
+  FILE* fp = fopen (snapshot->Path, "rb");
+  if (fp == NULL) {
+
+    printf ("Error! Failed to open %s. Read_Snapshot()\n", snapshot->Path);
+    return NULL;
+  }
+
+  struct N_TreeType* tree = Create_N_Tree (snapshot->RootChildSize);
+  bool ok = tree != NULL;
+
+  if (ok) {
+
+    tree->Count = 1;
+    tree->Head->Hash = snapshot->Root;
+    ok = ReadSubtree (snapshot, fp, tree, tree->Head);
+  }
+  fclose (fp);
+
+  // 다시 계산한 해시가 기록과 같아야 온전한 복원이다
+  if (ok) {
+
+    Rehash_N_Tree (tree);
+    ok = tree->Head->Hash == snapshot->Root;
+  }
+
+  if (!ok) {
+
+    printf ("Error! Snapshot %s is corrupt. Read_Snapshot()\n", snapshot->Path);
+    Delete_N_Tree (tree);
+    return NULL;
+  }
+  if (!ReadDependencies_Snapshot (snapshot, tree) || !ReadAttributes_Snapshot (snapshot, tree)) {
+
+    Delete_N_Tree (tree);
+    return NULL;
+  }
+  return tree;
+}
+
+static bool ReadPath (FILE* fp, int* slots, int* depth) {
+
+  unsigned int value;
+  if (!ReadU16 (fp, &value)) return false;
+
+  *depth = (int) value;
+  for (int level = 0; level < *depth; level++) {
+
+    if (!ReadU16 (fp, &value)) return false;
+    slots[level] = (int) value;
+  }
+  return true;
+}
+
+// 마지막 루트의 간선 기록을 tree 에 더한다 (지연 로딩 트리는 두 끝까지의 경로를 읽는다)
+bool ReadDependencies_Snapshot (struct SnapshotType* snapshot, struct N_TreeType* tree) {
+
+  if (snapshot == NULL || tree == NULL || snapshot->Dependencies == 0) return true;
+
+  FILE* fp = fopen (snapshot->Path, "rb");
+  int* node = (int*) malloc (65535 * sizeof (int));
+  int* on = (int*) malloc (65535 * sizeof (int));
+  unsigned long long digest;
+  unsigned int edges = 0;
+
+  bool ok = fp != NULL && node != NULL && on != NULL && fseek (fp, snapshot->Dependencies + 1, SEEK_SET) == 0 &&
+            ReadU64 (fp, &digest) && ReadU32 (fp, &edges);
+  for (unsigned int edge = 0; ok && edge < edges; edge++) {
+
+    int nodeDepth, onDepth;
+    ok = ReadPath (fp, node, &nodeDepth) && ReadPath (fp, on, &onDepth);
+    if (ok) ok = AddDependency_N_Tree (tree, NodeBySlotPath_N_Tree (tree, node, nodeDepth), NodeBySlotPath_N_Tree (tree, on, onDepth));
+  }
+
+  if (fp != NULL) fclose (fp);
+  free (node);
+  free (on);
+  if (!ok) printf ("Error! Dependencies in %s are corrupt. ReadDependencies_Snapshot()\n", snapshot->Path);
+  return ok;
+}
+
+// 마지막 루트의 속성 기록을 tree 에 설정한다 (지연 로딩 트리는 값이 있는 노드까지의 경로를 읽는다)
+bool ReadAttributes_Snapshot (struct SnapshotType* snapshot, struct N_TreeType* tree) {
+
+  if (snapshot == NULL || tree == NULL || snapshot->Attributes == 0) return true;
+
+  FILE* fp = fopen (snapshot->Path, "rb");
+  int* slots = (int*) malloc (65535 * sizeof (int));
+  char text[LABEL_MAX_LENGTH + 1];
+  unsigned long long digest;
+  unsigned int columns = 0;
+
+  bool ok = fp != NULL && slots != NULL && fseek (fp, snapshot->Attributes + 1, SEEK_SET) == 0 &&
+            ReadU64 (fp, &digest) && ReadU32 (fp, &columns);
+  for (unsigned int column = 0; ok && column < columns; column++) {
+
+    char name[ATTR_NAME_SIZE + 256];
+    int nameLength = fgetc (fp);
+    ok = nameLength != EOF && fread (name, 1, nameLength, fp) == (size_t) nameLength;
+
+    int kind = ok ? fgetc (fp) : EOF;
+    unsigned int count = 0;
+    ok = ok && kind >= ATTR_INT && kind <= ATTR_TIMESTAMP && ReadU32 (fp, &count);
+    if (ok) name[nameLength] = '\0';
+
+    for (unsigned int item = 0; ok && item < count; item++) {
+
+      int depth;
+      ok = ReadPath (fp, slots, &depth) && ReadAttributeValue (fp, (enum AttributeKindType) kind, text, sizeof (text));
+      struct TreeNodeType* node = ok ? NodeBySlotPath_N_Tree (tree, slots, depth) : NULL;
+      ok = node != NULL && SetAttribute_N_Tree (tree, node, name, (enum AttributeKindType) kind, text);
+    }
+  }
+
+  if (fp != NULL) fclose (fp);
+  free (slots);
+  if (!ok) printf ("Error! Attributes in %s are corrupt. ReadAttributes_Snapshot()\n", snapshot->Path);
+  return ok;
+}
+
+// 마지막 루트에서 닿지 않는 조각을 버리고 새 파일로 바꾼다
+bool Compact_Snapshot (struct SnapshotType* snapshot) {
+
+  struct N_TreeType* tree = Read_Snapshot (snapshot);
+  if (tree == NULL) return false;
+
+  char temporary[SNAPSHOT_PATH_SIZE + 4];
+  snprintf (temporary, sizeof (temporary), "%s.tmp", snapshot->Path);
+  remove (temporary);
+
+  struct SnapshotType* compacted = Open_Snapshot (temporary);
+  bool ok = compacted != NULL && Write_Snapshot (compacted, tree) >= 0 && rename (temporary, snapshot->Path) == 0;
+  Delete_N_Tree (tree);
+
+  if (!ok) {
+
+    printf ("Error! Failed to compact %s. Compact_Snapshot()\n", snapshot->Path);
+    Close_Snapshot (compacted);
+    remove (temporary);
+    return false;
+  }
+
+  // 색인을 새 파일 것으로 바꾼다
+  free (snapshot->Keys);
+  free (snapshot->Offsets);
+  free (snapshot->Sizes);
+  strcpy (compacted->Path, snapshot->Path);
+  *snapshot = *compacted;
+  free (compacted);
+  return true;
+}
+
+void Close_Snapshot (struct SnapshotType* snapshot) {
+
+  if (snapshot == NULL) return;
+
+  free (snapshot->Keys);
+  free (snapshot->Offsets);
+  free (snapshot->Sizes);
+  free (snapshot);
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#ifndef _SNAPSHOT_H_
+#define _SNAPSHOT_H_
+
+#include "n_tree.h"
+#include <stdio.h>
+
+#define SNAPSHOT_PATH_SIZE 256
+
+// 머클 해시로 주소를 매긴 추가 전용 스냅숏 파일.
+// 노드 하나가 조각(chunk) 하나이고, 이미 파일에 있는 해시의 서브트리는 다시 쓰지 않는다.
+// 저장할 때마다 마지막에 루트 기록을 덧붙이며, 읽을 때는 마지막 루트 기록을 따른다.
+// 노드 사이의 의존 간선과 속성은 바뀌었을 때만 루트 기록 바로 앞에 슬롯 경로로 함께 쓴다.
+struct SnapshotType {
+
+  char Path[SNAPSHOT_PATH_SIZE];
+  unsigned long long* Keys;   // 조각 해시 (0 은 빈 칸)
+  long* Offsets;              // 조각의 파일 위치
+  int* Sizes;                 // 조각 서브트리의 노드 수
+  long Capacity;              // 2 의 거듭제곱
+  long Count;
+  long Size;                  // 유효한 기록까지의 파일 크기
+  bool HasRoot;
+  unsigned long long Root;
+  int RootChildSize;
+  int RootCount;
+  int Version;                           // 파일 머리의 버전 (새 파일은 0)
+  long Dependencies;                     // 마지막 루트의 간선 기록 위치 (없으면 0)
+  unsigned long long DependencyDigest;   // 그 간선 집합의 요약 값 (없으면 0)
+  long Attributes;                       // 마지막 루트의 속성 기록 위치 (없으면 0)
+  unsigned long long AttributeDigest;    // 그 속성 값들의 요약 값 (없으면 0)
+};
+
+// 조각 하나를 읽은 결과
+struct SnapshotChunkType {
+
+  unsigned long long Hash;
+  int Size;                              // 서브트리 노드 수
+  char Text[LABEL_MAX_LENGTH + 1];
+  int ChildCount;
+  int ChildCapacity;             // Slots, Hashes 칸 수 (ReadChunk_Snapshot 이 필요한 만큼 늘림)
+  int* Slots;
+  unsigned long long* Hashes;
+};
+
+struct SnapshotType* Open_Snapshot (const char* path);
+long Write_Snapshot (struct SnapshotType* snapshot, struct N_TreeType* tree);
+bool Matches_Snapshot (struct SnapshotType* snapshot, struct N_TreeType* tree);
+struct N_TreeType* Read_Snapshot (struct SnapshotType* snapshot);
+bool ReadDependencies_Snapshot (struct SnapshotType* snapshot, struct N_TreeType* tree);
+bool ReadAttributes_Snapshot (struct SnapshotType* snapshot, struct N_TreeType* tree);
+int ChunkSize_Snapshot (struct SnapshotType* snapshot, unsigned long long hash);
+bool ReadChunk_Snapshot (struct SnapshotType* snapshot, FILE* fp, unsigned long long hash, struct SnapshotChunkType* chunk);
+void FreeChunk_Snapshot (struct SnapshotChunkType* chunk);
+bool Compact_Snapshot (struct SnapshotType* snapshot);
+void Close_Snapshot (struct SnapshotType* snapshot);
+
+#endif
\ No newline at end of file
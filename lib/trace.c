@@ -0,0 +1,158 @@
+#include "trace.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <limits.h>
+
+#define TRACE_BUSY ULONG_MAX  // 칸을 쓰는 중
+
+struct TraceEventType {
+
+  atomic_ulong Sequence;  // 기록을 마치면 번호 + 1, 쓰는 동안 TRACE_BUSY (읽는 쪽은 이것으로 덜 쓴 칸을 거른다)
+  char Name[TRACE_NAME_SIZE];
+  const char* Category;   // 문자열 상수만 받는다
+  unsigned long long Start;
+  unsigned long long Duration;
+  int Thread;
+};
+
+// 쓰는 쪽은 Next 를 fetch_add 로 받아 자기 칸만 채우므로 여러 스레드가 동시에 기록해도 잠금이 없다.
+// 한 바퀴 앞선 스레드와 같은 칸이 겹치면 칸을 CAS 로 차지한 쪽만 쓰고 다른 쪽은 구간을 버린다.
+// 읽기(Trace_Close)는 기록하는 스레드가 모두 끝난 뒤에 한다.
+static struct TraceEventType* Events;
+static unsigned long Capacity;
+static atomic_ulong Next;
+static atomic_ulong Lost;
+static atomic_bool Active;
+static atomic_int ThreadCounter;
+static _Thread_local int ThreadId;
+static unsigned long long Origin;
+static char Path[TRACE_PATH_SIZE];
+
+static unsigned long long TraceNow (void) {
+
+  struct timespec now;
+  clock_gettime (CLOCK_MONOTONIC, &now);
+  return (unsigned long long) now.tv_sec * 1000000000ULL + (unsigned long long) now.tv_nsec;
+}
+
+bool Trace_Open (const char* path, int capacity) {
+
+  if (path == NULL || path[0] == '\0' || strlen (path) >= TRACE_PATH_SIZE) {
+
+    printf ("Error! Invalid trace file path. Trace_Open()\n");
+    return false;
+  }
+  if (atomic_load (&Active)) Trace_Close ();
+
+  // 번호를 칸 번호로 바꿀 때 나머지 대신 마스크를 쓰도록 2 의 거듭제곱으로 올린다
+  unsigned long size = 1;
+  while (size < (unsigned long) (capacity > 0 ? capacity : TRACE_DEFAULT_CAPACITY)) size <<= 1;
+
+  Events = (struct TraceEventType*) calloc (size, sizeof (struct TraceEventType));
+  if (Events == NULL) {
+
+    printf ("Error! The dynamic memory allocation failed. Trace_Open()\n");
+    return false;
+  }
+
+  Capacity = size;
+  strcpy (Path, path);
+  atomic_store (&Next, 0);
+  atomic_store (&Lost, 0);
+  Origin = TraceNow ();
+  atomic_store (&Active, true);
+  return true;
+}
+
+bool Trace_Enabled (void) {
+
+  return atomic_load_explicit (&Active, memory_order_relaxed);
+}
+
+unsigned long long Trace_Begin (void) {
+
+  if (!atomic_load_explicit (&Active, memory_order_relaxed)) return 0;
+  return TraceNow ();
+}
+
+void Trace_End (const char* name, const char* category, unsigned long long start) {
+
+  unsigned long long end = TraceNow ();
+  if (!atomic_load_explicit (&Active, memory_order_acquire) || start < Origin) return;
+
+  if (ThreadId == 0) ThreadId = atomic_fetch_add (&ThreadCounter, 1) + 1;
+
+  unsigned long sequence = atomic_fetch_add_explicit (&Next, 1, memory_order_relaxed);
+  struct TraceEventType* event = &Events[sequence & (Capacity - 1)];
+
+  unsigned long observed = atomic_load_explicit (&event->Sequence, memory_order_relaxed);
+  if (observed == TRACE_BUSY ||
+      !atomic_compare_exchange_strong_explicit (&event->Sequence, &observed, TRACE_BUSY, memory_order_acquire, memory_order_relaxed)) {
+
+    atomic_fetch_add_explicit (&Lost, 1, memory_order_relaxed);
+    return;
+  }
+  strncpy (event->Name, name, TRACE_NAME_SIZE - 1);
+  event->Name[TRACE_NAME_SIZE - 1] = '\0';
+  event->Category = category;
+  event->Start = start;
+  event->Duration = end - start;
+  event->Thread = ThreadId;
+  atomic_store_explicit (&event->Sequence, sequence + 1, memory_order_release);
+}
+
+static void WriteTraceString (FILE* fp, const char* text) {
+
+  for (; *text != '\0'; text++) {
+
+    if (*text == '"' || *text == '\\') fputc ('\\', fp);
+    if ((unsigned char) *text >= 0x20) fputc (*text, fp);
+  }
+}
+
+// 링 버퍼에 남은 구간을 기록 순서로 쓰고 추적을 끈다. 쓴 구간 수를 돌려준다 (실패하면 -1).
+long Trace_Close (void) {
+
+  if (!atomic_exchange (&Active, false)) return -1;
+
+  FILE* fp = fopen (Path, "w");
+  if (fp == NULL) {
+
+    printf ("Error! Failed to open file for writing: %s. Trace_Close()\n", Path);
+    free (Events);
+    Events = NULL;
+    return -1;
+  }
+
+  unsigned long last = atomic_load (&Next);
+  unsigned long first = last > Capacity ? last - Capacity : 0;
+  long written = 0;
+
+  fprintf (fp, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+  for (unsigned long sequence = first; sequence < last; sequence++) {
+
+    struct TraceEventType* event = &Events[sequence & (Capacity - 1)];
+    if (atomic_load_explicit (&event->Sequence, memory_order_acquire) != sequence + 1) continue;
+
+    fprintf (fp, "%s\n  {\"name\": \"", written == 0 ? "" : ",");
+    WriteTraceString (fp, event->Name);
+    fprintf (fp, "\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": %d}",
+             event->Category, (event->Start - Origin) / 1000.0, event->Duration / 1000.0, event->Thread);
+    written++;
+  }
+  fprintf (fp, "\n], \"otherData\": {\"overwritten\": %lu, \"lost\": %lu}}\n", first, atomic_load (&Lost));
+
+  bool ok = ferror (fp) == 0;
+  fclose (fp);
+  free (Events);
+  Events = NULL;
+  return ok ? written : -1;
+}
+
+const char* Trace_Path (void) {
+
+  return Path;
+}
\ No newline at end of file
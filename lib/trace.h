@@ -0,0 +1,24 @@
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <stdbool.h>
+
+// 구간 추적: 고정 크기 링 버퍼에 잠금 없이 기록했다가 Chrome trace-event JSON 으로 쓴다.
+// 꺼져 있을 때 TRACE_BEGIN 은 플래그 하나를 읽을 뿐이다.
+
+#define TRACE_DEFAULT_CAPACITY 65536  // 2 의 거듭제곱 (넘치면 오래된 구간부터 덮어쓴다)
+#define TRACE_NAME_SIZE 32
+#define TRACE_PATH_SIZE 256
+
+bool Trace_Open (const char* path, int capacity);
+bool Trace_Enabled (void);
+unsigned long long Trace_Begin (void);
+void Trace_End (const char* name, const char* category, unsigned long long start);
+long Trace_Close (void);
+const char* Trace_Path (void);
+
+// start 가 0 이면 추적이 꺼져 있던 구간이므로 기록하지 않는다
+#define TRACE_BEGIN(span) unsigned long long span = Trace_Begin ()
+#define TRACE_END(span, name, category) do { if ((span) != 0) Trace_End ((name), (category), (span)); } while (0)
+
+#endif
\ No newline at end of file
@@ -2,7 +2,7 @@
 #include <stdio.h>
 #include <string.h>
 
-void DisplayRecursive (struct TreeNodeType* node, int childSize, int depth) {
+void DisplayRecursive (struct N_TreeType* tree, struct TreeNodeType* node, int depth) {
 
   for (int loop = 0; loop < depth; loop++) printf ("  ");
   
@@ -12,11 +12,11 @@ void DisplayRecursive (struct TreeNodeType* node, int childSize, int depth) {
     return;
   }
 
-  printf ("%s\n", node->Data);
+  printf ("%s\n", Data_N_Tree (tree, node));
 
-  for (int index = 0; index < childSize; index++) {
+  for (int index = 0; index < tree->ChildSize; index++) {
 
-    DisplayRecursive (node->Children[index], childSize, depth + 1);
+    DisplayRecursive (tree, ChildAt_N_Tree (node, index), depth + 1);
   }
   return;
 }
@@ -26,22 +26,23 @@ void Display (struct N_TreeType* tree) {
   if (tree == NULL || tree->Head == NULL) return;
 
   printf ("[H]");
-  DisplayRecursive (tree->Head, tree->ChildSize, 0);
+  DisplayRecursive (tree, tree->Head, 0);
   return;
 }
 
-static void ShowRecursive (struct TreeNodeType* node, int childSize, char* prefix, int isLast) {
+static void ShowRecursive (struct N_TreeType* tree, struct TreeNodeType* node, char* prefix, int isLast) {
 
   if (node == NULL) return;
 
-  printf ("%s%s%s\n", prefix, isLast ? "└── " : "├── ", node->Data);
+  printf ("%s%s%s\n", prefix, isLast ? "└── " : "├── ", Data_N_Tree (tree, node));
 
   char newPrefix[1024];
   snprintf (newPrefix, sizeof(newPrefix), "%s%s", prefix, isLast ? "    " : "│   ");
 
-  for (int index = 0; index < childSize; index++) {
-    int isLastChild = (index == childSize - 1);
-    ShowRecursive (node->Children[index], childSize, newPrefix, isLastChild);
+  // 마지막으로 점유된 슬롯에 └── 를 붙인다
+  int lastSlot = LastChildSlot_N_Tree (node);
+  FOR_EACH_CHILD_SLOT (node, index) {
+    ShowRecursive (tree, node->Children[index], newPrefix, index == lastSlot);
   }
 }
 
@@ -49,11 +50,11 @@ void Show (struct N_TreeType* tree) {
 
   if (tree == NULL || tree->Head == NULL) return;
 
-  printf ("%s\n", tree->Head->Data);
+  printf ("%s\n", Data_N_Tree (tree, tree->Head));
 
-  for (int index = 0; index < tree->ChildSize; index++) {
-    int isLast = (index == tree->ChildSize - 1);
-    ShowRecursive (tree->Head->Children[index], tree->ChildSize, "", isLast);
+  int lastSlot = LastChildSlot_N_Tree (tree->Head);
+  FOR_EACH_CHILD_SLOT (tree->Head, index) {
+    ShowRecursive (tree, tree->Head->Children[index], "", index == lastSlot);
   }
 }
 
@@ -62,11 +63,9 @@ static int GetTreeDepth (struct TreeNodeType* node, int childSize) {
   if (node == NULL) return 0;
 
   int maxDepth = 0;
-  for (int i = 0; i < childSize; i++) {
-    if (node->Children[i] != NULL) {
-      int childDepth = GetTreeDepth (node->Children[i], childSize);
-      if (childDepth > maxDepth) maxDepth = childDepth;
-    }
+  FOR_EACH_CHILD_SLOT (node, i) {
+    int childDepth = GetTreeDepth (node->Children[i], childSize);
+    if (childDepth > maxDepth) maxDepth = childDepth;
   }
   return maxDepth + 1;
 }
@@ -75,15 +74,10 @@ static int GetTreeDepth (struct TreeNodeType* node, int childSize) {
 static int CountLeaves (struct TreeNodeType* node, int childSize) {
   if (node == NULL) return 0;
 
-  int hasChild = 0;
-  for (int i = 0; i < childSize; i++) {
-    if (node->Children[i] != NULL) hasChild = 1;
-  }
-
-  if (!hasChild) return 1;
+  if (IsLeaf_N_Tree (node)) return 1;
 
   int count = 0;
-  for (int i = 0; i < childSize; i++) {
+  FOR_EACH_CHILD_SLOT (node, i) {
     count += CountLeaves (node->Children[i], childSize);
   }
   return count;
@@ -93,12 +87,7 @@ static int CountLeaves (struct TreeNodeType* node, int childSize) {
 static int AssignPositions (struct TreeNodeType* node, int childSize, int level, int leftPos, NodePosition* positions, int* posCount, int nodeWidth, int childIdx) {
   if (node == NULL) return leftPos;
 
-  int hasChild = 0;
-  for (int i = 0; i < childSize; i++) {
-    if (node->Children[i] != NULL) hasChild = 1;
-  }
-
-  if (!hasChild) {
+  if (IsLeaf_N_Tree (node)) {
     // 리프 노드
     positions[*posCount].node = node;
     positions[*posCount].x = leftPos;
@@ -112,10 +101,8 @@ static int AssignPositions (struct TreeNodeType* node, int childSize, int level,
   int startPos = leftPos;
   int endPos = leftPos;
 
-  for (int i = 0; i < childSize; i++) {
-    if (node->Children[i] != NULL) {
-      endPos = AssignPositions (node->Children[i], childSize, level + 1, endPos, positions, posCount, nodeWidth, i);
-    }
+  FOR_EACH_CHILD_SLOT (node, i) {
+    endPos = AssignPositions (node->Children[i], childSize, level + 1, endPos, positions, posCount, nodeWidth, i);
   }
 
   // 부모는 자식들의 중간에 배치
@@ -167,7 +154,7 @@ void TreeView (struct N_TreeType* tree, int nodeWidth) {
     for (int i = 0; i < posCount; i++) {
       if (positions[i].level == level) {
         int x = positions[i].x;
-        const char* data = positions[i].node->Data;
+        const char* data = Data_N_Tree (tree, positions[i].node);
         int dataLen = strlen (data);
 
         // 고정 너비로 노드 데이터 출력 (중앙 정렬)
@@ -226,15 +213,13 @@ void TreeView (struct N_TreeType* tree, int nodeWidth) {
           int childCount = 0;
 
           // 자식 노드들의 위치 찾기
-          for (int c = 0; c < tree->ChildSize; c++) {
-            if (parent->Children[c] != NULL) {
-              for (int p = 0; p < posCount; p++) {
-                if (positions[p].node == parent->Children[c]) {
-                  int childX = positions[p].x + nodeWidth / 2;
-                  childPositions[childCount++] = childX;
-                  if (firstChildX == -1) firstChildX = childX;
-                  lastChildX = childX;
-                }
+          FOR_EACH_CHILD_SLOT (parent, c) {
+            for (int p = 0; p < posCount; p++) {
+              if (positions[p].node == parent->Children[c]) {
+                int childX = positions[p].x + nodeWidth / 2;
+                childPositions[childCount++] = childX;
+                if (firstChildX == -1) firstChildX = childX;
+                lastChildX = childX;
               }
             }
           }
@@ -281,10 +266,10 @@ struct TreeNodeType* GetParentNode (struct TreeNodeType* current) {
   return current->Parent;
 }
 
-void MoveChildNode (struct TreeNodeType* parent, int from, int to) {
+void MoveChildNode (struct N_TreeType* tree, struct TreeNodeType* parent, int from, int to) {
 
   if (parent == NULL) return;
-  if (parent->Children == NULL) return;
+  if (!ReserveChildren_N_Tree (parent, (from > to ? from : to) + 1)) return;
 
   // 범위 체크는 호출하는 쪽에서 해야 함
   struct TreeNodeType* temp = parent->Children[from];
@@ -293,37 +278,38 @@ void MoveChildNode (struct TreeNodeType* parent, int from, int to) {
   if (from < to) {
     // 왼쪽에서 오른쪽으로 이동
     for (int i = from; i < to; i++) {
-      parent->Children[i] = parent->Children[i + 1];
+      SetChild_N_Tree (parent, i, parent->Children[i + 1]);
     }
   } else if (from > to) {
     // 오른쪽에서 왼쪽으로 이동
     for (int i = from; i > to; i--) {
-      parent->Children[i] = parent->Children[i - 1];
+      SetChild_N_Tree (parent, i, parent->Children[i - 1]);
     }
   } else {
     // from == to, 이동 필요 없음
     return;
   }
 
-  parent->Children[to] = temp;
+  SetChild_N_Tree (parent, to, temp);
+  UpdateHash_N_Tree (tree, parent);
 }
 
-void SwapChildNode (struct TreeNodeType* parent, int from, int to) {
+void SwapChildNode (struct N_TreeType* tree, struct TreeNodeType* parent, int from, int to) {
 
   if (parent == NULL) return;
-  if (parent->Children == NULL) return;
+  if (!ReserveChildren_N_Tree (parent, (from > to ? from : to) + 1)) return;
 
   // 범위 체크는 호출하는 쪽에서 해야 함
   struct TreeNodeType* temp = parent->Children[from];
-  parent->Children[from] = parent->Children[to];
-  parent->Children[to] = temp;
+  SetChild_N_Tree (parent, from, parent->Children[to]);
+  SetChild_N_Tree (parent, to, temp);
+  UpdateHash_N_Tree (tree, parent);
 }
 
-void Edit (struct TreeNodeType* current, char* data) {
+void Edit (struct N_TreeType* tree, struct TreeNodeType* current, char* data) {
 
   if (current == NULL) return;
   if (data == NULL) return;
 
-  strncpy (current->Data, data, SIZE - 1);
-  current->Data[SIZE - 1] = '\0';
+  SetData_N_Tree (tree, current, data);
 }
\ No newline at end of file
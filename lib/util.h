@@ -14,12 +14,12 @@ typedef struct {
   int childIndex;  // 부모의 몇 번째 자식인지 (-1이면 루트)
 } NodePosition;
 
-void MoveChildNode (struct TreeNodeType* parent, int from, int to);
-void SwapChildNode (struct TreeNodeType* parent, int from, int to);
+void MoveChildNode (struct N_TreeType* tree, struct TreeNodeType* parent, int from, int to);
+void SwapChildNode (struct N_TreeType* tree, struct TreeNodeType* parent, int from, int to);
 void Display (struct N_TreeType* tree);
 void Show (struct N_TreeType* tree);
 void TreeView (struct N_TreeType* tree, int nodeWidth);
-void Edit (struct TreeNodeType* current, char* data);
+void Edit (struct N_TreeType* tree, struct TreeNodeType* current, char* data);
 struct TreeNodeType* GetParentNode (struct TreeNodeType* current);
 
 #endif
\ No newline at end of file
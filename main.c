@@ -1,12 +1,60 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "cli/workflow_cli.h"
 
+// 선택 인자: 다음 인자가 옵션이 아니면 값으로 쓴다
+static const char* OptionValue (int argc, char* argv[], int* index) {
+
+  if (*index + 1 < argc && strncmp(argv[*index + 1], "--", 2) != 0) return argv[++(*index)];
+  return NULL;
+}
+
 int main (int argc, char* argv[]) {
 
-  // CLI 초기화 (각 노드는 최대 128개의 자식을 가질 수 있음)
-  WorkflowCLI* cli = InitWorkflowCLI(128); // max
+  // --lazy [snapshot] 이면 스냅숏에서 처음 방문하는 서브트리만 읽는다
+  // --trace [file] 이면 세션 구간을 기록해 종료할 때 Chrome trace JSON 으로 쓴다
+  // --fanout N 이면 새 트리의 ChildSize 를 N 으로 한다 (저장된 트리는 파일의 값을 따름)
+  bool lazy = false;
+  int fanout = CHILD_SIZE;
+  const char* snapshotPath = SNAPSHOT_FILE_PATH;
+  bool trace = false;
+  const char* tracePath = NULL;
+  for (int index = 1; index < argc; index++) {
+
+    if (strcmp(argv[index], "--lazy") == 0) {
+
+      lazy = true;
+      const char* value = OptionValue(argc, argv, &index);
+      if (value != NULL) snapshotPath = value;
+    } else if (strcmp(argv[index], "--trace") == 0) {
+
+      trace = true;
+      tracePath = OptionValue(argc, argv, &index);
+    } else if (strcmp(argv[index], "--fanout") == 0) {
+
+      const char* value = OptionValue(argc, argv, &index);
+      fanout = value != NULL ? atoi(value) : 0;
+      if (fanout < 1 || fanout > CHILD_SIZE_MAX) {
+        printf("Invalid fan-out: must be between 1 and %d\n", CHILD_SIZE_MAX);
+        return 1;
+      }
+    } else {
+
+      printf("Unknown option: %s\n", argv[index]);
+      printf("Usage: %s [--lazy [snapshot]] [--trace [file]] [--fanout N]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  // 초기 불러오기도 기록되도록 CLI 초기화 전에 켠다
+  if (trace && !StartTrace(tracePath)) return 1;
+
+  // CLI 초기화 (각 노드는 기본 128개, --fanout 으로 최대 CHILD_SIZE_MAX 개의 자식을 가질 수 있음)
+  WorkflowCLI* cli = lazy ? InitPagedWorkflowCLI(snapshotPath) : InitWorkflowCLI(fanout);
   if (cli == NULL) {
     printf("Failed to initialize CLI.\n");
+    StopTrace();
     return 1;
   }
 
@@ -0,0 +1,140 @@
+#include "../lib/n_tree.h"
+#include "../lib/attr.h"
+#include "../lib/deps.h"
+#include "../lib/diff.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int failures = 0;
+
+static void Check (bool condition, const char* message) {
+
+  if (!condition) {
+
+    printf ("FAIL: %s\n", message);
+    failures++;
+  }
+}
+
+// Root 아래 A, B, C 와 A 아래 A0 을 가진 트리 (base, ours, theirs 가 같은 모양에서 시작한다)
+static struct N_TreeType* BuildTree (void) {
+
+  struct N_TreeType* tree = Create_N_Tree (8);
+  tree->Count = 1;
+  Insert_ChildNode_N_Tree (tree, tree->Head, "A", 0);
+  Insert_ChildNode_N_Tree (tree, tree->Head, "B", 1);
+  Insert_ChildNode_N_Tree (tree, tree->Head, "C", 2);
+  Insert_ChildNode_N_Tree (tree, tree->Head->Children[0], "A0", 0);
+  return tree;
+}
+
+static struct TreeNodeType* At (struct N_TreeType* tree, int slot) {
+
+  return ChildAt_N_Tree (tree->Head, slot);
+}
+
+static bool AttributeIs (struct N_TreeType* tree, struct TreeNodeType* node, const char* name, const char* expected) {
+
+  char value[ATTR_TEXT_SIZE] = "";
+  bool found = node != NULL && GetAttribute_N_Tree (tree, node, name, value, sizeof (value));
+  return expected == NULL ? !found : found && strcmp (value, expected) == 0;
+}
+
+static bool HasEdge (struct N_TreeType* tree, struct TreeNodeType* node, struct TreeNodeType* on) {
+
+  int count;
+  const int* ids = DependsOn_N_Tree (tree, node, &count);
+  for (int edge = 0; edge < count; edge++) {
+
+    if (ids[edge] == on->Id) return true;
+  }
+  return false;
+}
+
+// 이름이 바뀌지 않은 노드의 속성만 바뀌어도 병합 결과에 들어가야 한다
+static void TestAttributeOnlyChanges (void) {
+
+  struct N_TreeType* base = BuildTree ();
+  struct N_TreeType* ours = BuildTree ();
+  struct N_TreeType* theirs = BuildTree ();
+  SetAttribute_N_Tree (base, At (base, 1), "status", ATTR_STRING, "todo");
+  SetAttribute_N_Tree (ours, At (ours, 1), "status", ATTR_STRING, "todo");
+  SetAttribute_N_Tree (theirs, At (theirs, 1), "status", ATTR_STRING, "done");
+  SetAttribute_N_Tree (theirs, At (theirs, 0)->Children[0], "owner", ATTR_STRING, "amy");
+  SetAttribute_N_Tree (ours, At (ours, 2), "cost", ATTR_INT, "5");
+
+  struct MergeConflictListType conflicts;
+  struct N_TreeType* merged = Merge_N_Tree (base, ours, theirs, &conflicts);
+  Check (merged != NULL, "merge succeeds");
+  if (merged != NULL) {
+
+    Check (AttributeIs (merged, At (merged, 1), "status", "done"), "attribute changed only in theirs is taken");
+    Check (AttributeIs (merged, At (merged, 0)->Children[0], "owner", "amy"), "attribute added deep in theirs is taken");
+    Check (AttributeIs (merged, At (merged, 2), "cost", "5"), "attribute added only in ours is kept");
+    Check (conflicts.Total == 0, "one-sided attribute changes do not conflict");
+  }
+  Delete_N_Tree (merged);
+
+  // 같은 노드의 속성을 양쪽이 다르게 바꾸면 ours 를 두고 충돌로 알린다
+  SetAttribute_N_Tree (ours, At (ours, 1), "status", ATTR_STRING, "failed");
+  merged = Merge_N_Tree (base, ours, theirs, &conflicts);
+  Check (merged != NULL && AttributeIs (merged, At (merged, 1), "status", "failed"), "conflicting attribute keeps ours");
+  Check (conflicts.Total == 1 && strcmp (conflicts.Items[0].Path, "/1") == 0, "conflicting attribute is reported");
+
+  Delete_N_Tree (merged);
+  Delete_N_Tree (base);
+  Delete_N_Tree (ours);
+  Delete_N_Tree (theirs);
+}
+
+// 간선은 슬롯 경로로 옮기고, theirs 가 더하거나 지운 간선을 반영한다
+static void TestDependencies (void) {
+
+  struct N_TreeType* base = BuildTree ();
+  struct N_TreeType* ours = BuildTree ();
+  struct N_TreeType* theirs = BuildTree ();
+  AddDependency_N_Tree (base, At (base, 1), At (base, 0));
+  AddDependency_N_Tree (ours, At (ours, 1), At (ours, 0));
+  AddDependency_N_Tree (ours, At (ours, 2), At (ours, 1));               // ours 가 더함
+  AddDependency_N_Tree (theirs, At (theirs, 2), At (theirs, 0)->Children[0]);  // theirs 가 더하고 B -> A 는 지움
+
+  struct MergeConflictListType conflicts;
+  struct N_TreeType* merged = Merge_N_Tree (base, ours, theirs, &conflicts);
+  Check (merged != NULL, "merge with dependencies succeeds");
+  if (merged != NULL) {
+
+    Check (!HasEdge (merged, At (merged, 1), At (merged, 0)), "edge removed in theirs is dropped");
+    Check (HasEdge (merged, At (merged, 2), At (merged, 1)), "edge added in ours is kept");
+    Check (HasEdge (merged, At (merged, 2), At (merged, 0)->Children[0]), "edge added in theirs is taken");
+    Check (DependencyCount_N_Tree (merged) == 2, "merged tree has exactly the merged edges");
+    Check (conflicts.Total == 0, "edge merge without conflicts");
+  }
+  Delete_N_Tree (merged);
+
+  // theirs 가 지운 노드를 기다리던 ours 의 간선은 빼고 충돌로 알린다
+  Remove_N_Tree (theirs, At (theirs, 0)->Children[0], false);
+  AddDependency_N_Tree (ours, At (ours, 1), At (ours, 0)->Children[0]);
+  merged = Merge_N_Tree (base, ours, theirs, &conflicts);
+  Check (merged != NULL && At (merged, 0) != NULL && ChildCount_N_Tree (At (merged, 0)) == 0, "deletion in theirs is merged");
+  Check (conflicts.Total >= 1, "edge to a deleted node is reported");
+
+  Delete_N_Tree (merged);
+  Delete_N_Tree (base);
+  Delete_N_Tree (ours);
+  Delete_N_Tree (theirs);
+}
+
+int main (void) {
+
+  TestAttributeOnlyChanges ();
+  TestDependencies ();
+
+  if (failures > 0) {
+
+    printf ("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf ("merge_test: ok\n");
+  return 0;
+}
@@ -0,0 +1,87 @@
+#include "../lib/n_tree.h"
+#include "../lib/attr.h"
+#include "../lib/deps.h"
+#include "../lib/snapshot.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_PATH "snapshot_test.snap"
+
+static int failures = 0;
+
+static void Check (bool condition, const char* message) {
+
+  if (!condition) {
+
+    printf ("FAIL: %s\n", message);
+    failures++;
+  }
+}
+
+// 간선이 하나도 없는 트리도 저장, 다시 읽기, 정리가 되어야 한다
+static void TestSaveWithoutDependencies (void) {
+
+  remove (TEST_PATH);
+  struct N_TreeType* tree = Create_N_Tree (8);
+  Insert_ChildNode_N_Tree (tree, tree->Head, "A", 0);
+  Insert_ChildNode_N_Tree (tree, tree->Head, "B", 3);
+  Check (tree->Dependencies == NULL, "a new tree has no dependency index");
+
+  struct SnapshotType* snapshot = Open_Snapshot (TEST_PATH);
+  Check (snapshot != NULL && Write_Snapshot (snapshot, tree) == 3, "save writes every node");
+  Check (Matches_Snapshot (snapshot, tree), "saved snapshot matches the tree");
+
+  struct N_TreeType* loaded = Read_Snapshot (snapshot);
+  Check (loaded != NULL && loaded->Head->Hash == tree->Head->Hash, "reloaded tree has the same hash");
+  Check (loaded != NULL && DependencyCount_N_Tree (loaded) == 0, "reloaded tree has no dependencies");
+  Delete_N_Tree (loaded);
+
+  Check (Compact_Snapshot (snapshot), "compact succeeds");
+  Close_Snapshot (snapshot);
+  Delete_N_Tree (tree);
+}
+
+// 속성과 간선은 파일을 다시 열어도 남아 있어야 한다
+static void TestSaveWithAttributesAndDependencies (void) {
+
+  remove (TEST_PATH);
+  struct N_TreeType* tree = Create_N_Tree (8);
+  Insert_ChildNode_N_Tree (tree, tree->Head, "A", 0);
+  Insert_ChildNode_N_Tree (tree, tree->Head, "B", 1);
+  struct TreeNodeType* a = tree->Head->Children[0];
+  struct TreeNodeType* b = tree->Head->Children[1];
+  SetAttribute_N_Tree (tree, a, "duration", ATTR_INT, "7");
+  Check (AddDependency_N_Tree (tree, b, a), "add a dependency");
+
+  struct SnapshotType* snapshot = Open_Snapshot (TEST_PATH);
+  Check (snapshot != NULL && Write_Snapshot (snapshot, tree) >= 0, "save succeeds");
+  Close_Snapshot (snapshot);
+
+  snapshot = Open_Snapshot (TEST_PATH);
+  struct N_TreeType* loaded = snapshot != NULL ? Read_Snapshot (snapshot) : NULL;
+  char value[ATTR_TEXT_SIZE] = "";
+  Check (loaded != NULL && GetAttribute_N_Tree (loaded, loaded->Head->Children[0], "duration", value, sizeof (value)) && strcmp (value, "7") == 0,
+         "attribute survives a reload");
+  Check (loaded != NULL && DependencyCount_N_Tree (loaded) == 1, "dependency survives a reload");
+  Check (loaded != NULL && Matches_Snapshot (snapshot, loaded), "reloaded tree matches the snapshot");
+
+  Delete_N_Tree (loaded);
+  Close_Snapshot (snapshot);
+  Delete_N_Tree (tree);
+}
+
+int main (void) {
+
+  TestSaveWithoutDependencies ();
+  TestSaveWithAttributesAndDependencies ();
+  remove (TEST_PATH);
+
+  if (failures > 0) {
+
+    printf ("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf ("snapshot_test: ok\n");
+  return 0;
+}